@@ -1,7 +1,9 @@
+#include <chrono>
 #include <fstream>
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
 #include "ns3/internet-apps-module.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/ipv4-routing-table-entry.h"
@@ -10,26 +12,221 @@
 #include "ns3/applications-module.h"
 #include "ns3/mobility-module.h"
 #include <string>
+#include "topology-loader.h"
+#include "rip-convergence.h"
+#include "rip-snapshot.h"
+#include "rip-journal.h"
+#include "packet-capture.h"
+#include "async-trace-writer.h"
+#include "anim-mode.h"
+#include "fault-schedule.h"
+#include "ping-stats.h"
+#include "bulk-traffic.h"
+#include "rip-overhead.h"
+#include "rip-oracle.h"
+#include "sim-progress.h"
+#include "traffic-matrix.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("PoiRipRouting");
 
-void TearDownLink (Ptr<Node> nodeA, Ptr<Node> nodeB, uint32_t interfaceA, uint32_t interfaceB)
+NetDeviceContainer InstallLink (CsmaHelper &csma, PointToPointHelper &p2p, bool pointToPoint, NodeContainer nodes)
 {
-  nodeA->GetObject<Ipv4> ()->SetDown (interfaceA);
-  nodeB->GetObject<Ipv4> ()->SetDown (interfaceB);
+  return pointToPoint ? p2p.Install (nodes) : csma.Install (nodes);
 }
 
-void MoveOutNode (Ptr<Node> nodeA)
+void RunAndReport (void)
 {
-  ListPositionAllocator nodesPositionAllocator;
-  Vector newPos(800, 300, 0);
-  nodesPositionAllocator.Add(newPos);
-  MobilityHelper nodesmobility;
-  nodesmobility.SetPositionAllocator(&nodesPositionAllocator);
-  nodesmobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-  nodesmobility.Install(nodeA);
+  std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double runSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - runStart).count ();
+  std::cout<<"INFO: "<<Simulator::GetEventCount ()<<" events in "<<runSeconds<<" s, "
+           <<Simulator::GetEventCount () / runSeconds<<" events/s\n";
+}
+
+void RunTopologyFile (const std::string &topologyFile, const std::string &binaryTopology,
+                      const std::string &pingSrc, const std::string &pingDst,
+                      bool printRoutingTables, bool showPings, PacketCapture &capture, bool asyncTraces,
+                      const std::string &faultFile, const std::string &pingStatsPrefix,
+                      BulkTraffic &traffic, Time trafficStart, Time trafficStop, const std::string &trafficPrefix,
+                      const std::string &matrixFile, const std::string &hostPool,
+                      bool headless, bool pointToPoint, const std::string &oraclePrefix, uint32_t oracleThreads,
+                      bool stopOnConvergence, double quietPeriod, const std::string &snapshotPrefix, bool compressSnapshots,
+                      const std::string &journalFile, const std::string &overheadFile, double overheadBucket,
+                      AnimationMode &animation)
+{
+  NS_LOG_INFO ("Load topology " << topologyFile);
+  TopologyLoader loader;
+  if (!binaryTopology.empty ())
+    {
+      loader.SetBinaryMirror (binaryTopology);
+    }
+  loader.SetIgnorePositions (headless);
+  loader.SetPointToPoint (pointToPoint);
+  loader.Load (topologyFile);
+  NodeContainer routers = loader.GetRouters ();
+  std::cout<<"INFO: Loaded "<<routers.GetN ()<<" routers, "<<loader.GetHosts ().GetN ()<<" hosts and "
+           <<loader.GetNLinks ()<<" links from "<<topologyFile<<"\n";
+
+  Ptr<Node> src = loader.GetNode (pingSrc);
+  Ptr<Node> dst = loader.GetNode (pingDst);
+  NS_ABORT_MSG_IF (src == 0 || dst == 0, "Topology has no node \"" << pingSrc << "\" or \"" << pingDst << "\"");
+
+  TrafficMatrix matrix;
+  if (!matrixFile.empty ())
+    {
+      matrix.SetNodeLookup (MakeCallback (&TopologyLoader::GetNode, &loader));
+      matrix.Load (matrixFile);
+      matrix.AttachHosts (loader.GetCsmaHelper (), loader.GetPointToPointHelper (), pointToPoint, hostPool);
+    }
+
+  if (!snapshotPrefix.empty ())
+    {
+      ScheduleRipSnapshot (Seconds (15.0), routers, snapshotPrefix, compressSnapshots);
+      ScheduleRipSnapshot (Seconds (85.0), routers, snapshotPrefix, compressSnapshots);
+    }
+  else if (printRoutingTables)
+    {
+      RipHelper routingHelper;
+
+      Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> (&std::cout);
+
+      for (uint32_t i = 0; i < routers.GetN (); i++)
+        {
+          routingHelper.PrintRoutingTableAt (Seconds (15.0), routers.Get (i), routingStream);
+        }
+      for (uint32_t i = 0; i < routers.GetN (); i++)
+        {
+          routingHelper.PrintRoutingTableAt (Seconds (85.0), routers.Get (i), routingStream);
+        }
+    }
+  RipOracle oracle (oracleThreads);
+  if (!oraclePrefix.empty ())
+    {
+      oracle.Schedule (Seconds (15.0), routers, oraclePrefix);
+      oracle.Schedule (Seconds (85.0), routers, oraclePrefix);
+    }
+
+  NS_LOG_INFO ("Create Applications.");
+  V4PingHelper ping (dst->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ());
+  ping.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  ping.SetAttribute ("Size", UintegerValue (1024));
+  if (showPings && pingStatsPrefix.empty ())
+    {
+      ping.SetAttribute ("Verbose", BooleanValue (true));
+    }
+  ApplicationContainer apps = ping.Install (src);
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (200.0));
+
+  if (traffic.IsEnabled ())
+    {
+      traffic.AddFlows (src, dst, trafficStart, trafficStop);
+      matrix.AddFlows (traffic, trafficStart, trafficStop);
+      traffic.Start ();
+    }
+
+  AsyncTraceWriter *traceWriter = 0;
+  if (capture.GetMode () == PacketCapture::ALL && asyncTraces)
+    {
+      traceWriter = new AsyncTraceWriter;
+      Ptr<OutputStreamWrapper> stream = traceWriter->CreateFileStream ("rip-poi-routing.tr");
+      loader.GetCsmaHelper ().EnableAsciiAll (stream);
+      loader.GetPointToPointHelper ().EnableAsciiAll (stream);
+      traceWriter->EnablePcap (NodeContainer::GetGlobal (), "rip-poi-routing", true);
+    }
+  else if (capture.GetMode () == PacketCapture::ALL)
+    {
+      CsmaHelper &csma = loader.GetCsmaHelper ();
+      PointToPointHelper &p2p = loader.GetPointToPointHelper ();
+      AsciiTraceHelper ascii;
+      Ptr<OutputStreamWrapper> stream = ascii.CreateFileStream ("rip-poi-routing.tr");
+      csma.EnableAsciiAll (stream);
+      p2p.EnableAsciiAll (stream);
+      csma.EnablePcapAll ("rip-poi-routing", true);
+      p2p.EnablePcapAll ("rip-poi-routing", true);
+    }
+  capture.Install (NodeContainer::GetGlobal (), "rip-poi-routing");
+
+  FaultSchedule faults;
+  if (!faultFile.empty ())
+    {
+      // The loader knows the file's names, headless or not.
+      faults.SetNodeLookup (MakeCallback (&TopologyLoader::GetNode, &loader));
+      faults.Load (faultFile);
+    }
+  std::vector<Time> faultTimes = faults.GetTimes ();
+  PingStats pingStats;
+  if (!pingStatsPrefix.empty ())
+    {
+      pingStats.Connect (src);
+    }
+  for (size_t i = 0; i < faultTimes.size (); i++)
+    {
+      capture.NotifyFailureAt (faultTimes[i]);
+      pingStats.NotifyFailureAt (faultTimes[i]);
+    }
+  faults.Start ();
+
+  RipTableWatcher ripWatcher;
+  RipConvergenceDetector *convergence = 0;
+  if (stopOnConvergence)
+    {
+      ripWatcher.Watch (routers);
+      convergence = new RipConvergenceDetector (ripWatcher, Seconds (quietPeriod), true);
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          convergence->NotifyFailureAt (faultTimes[i]);
+        }
+    }
+  RipJournal *journal = 0;
+  if (!journalFile.empty ())
+    {
+      ripWatcher.Watch (routers);
+      journal = new RipJournal (ripWatcher, journalFile);
+    }
+  if (convergence != 0 || journal != 0)
+    {
+      faults.AddLinkChangedCallback (MakeCallback (&RipTableWatcher::MarkDirty, &ripWatcher));
+    }
+  RipOverhead overhead (Seconds (overheadBucket));
+  if (!overheadFile.empty ())
+    {
+      overhead.Connect (routers);
+    }
+
+  NS_LOG_INFO ("Run Simulation.");
+  Simulator::Stop (Seconds (200.0));
+
+  AnimationInterface *anim = animation.Create ("xmls/poi-rip.xml");
+  if (anim != 0)
+    {
+      anim->UpdateNodeDescription (src, pingSrc);
+      anim->UpdateNodeDescription (dst, pingDst);
+      anim->UpdateNodeColor (src, 10, 240, 10);
+      anim->UpdateNodeColor (dst, 10, 10, 240);
+    }
+
+  RunAndReport ();
+  if (!pingStatsPrefix.empty ())
+    {
+      pingStats.Write (pingStatsPrefix);
+    }
+  if (traffic.IsEnabled ())
+    {
+      traffic.Write (trafficPrefix);
+    }
+  if (!overheadFile.empty ())
+    {
+      overhead.Write (overheadFile);
+    }
+  Simulator::Destroy ();
+  animation.Finish ();
+  delete traceWriter;
+  delete convergence;
+  delete journal;
+  NS_LOG_INFO ("Done.");
 }
 
 int main (int argc, char **argv)
@@ -39,14 +236,108 @@ int main (int argc, char **argv)
   bool showPings = true;
   int unusefulAmount = 4;
   std::string SplitHorizon ("PoisonReverse");
+  std::string topologyFile;
+  std::string binaryTopology;
+  std::string pingSrc ("src");
+  std::string pingDst ("dst");
+  bool stopOnConvergence = false;
+  double quietPeriod = 60.0;
+  std::string snapshotPrefix;
+  bool compressSnapshots = true;
+  std::string journalFile;
+  std::string overheadFile;
+  std::string oraclePrefix;
+  uint32_t oracleThreads = 0;
+  double overheadBucket = 10.0;
+  std::string captureMode ("all");
+  std::string captureNodes;
+  std::string captureProtocol ("any");
+  uint32_t ringPackets = 100000;
+  double ringWindow = 5.0;
+  bool asyncTraces = false;
+  std::string animMode ("full");
+  std::string faultFile;
+  std::string pingStatsPrefix;
+  bool headless = false;
+  std::string linkType ("csma");
+  std::string trafficMode ("none");
+  std::string udpRate ("1Mbps");
+  double trafficStart = 5.0;
+  double trafficStop = 150.0;
+  double trafficInterval = 0.5;
+  std::string trafficPrefix ("rip-poi-traffic");
+  bool strayTraffic = false;
+  std::string matrixFile;
+  std::string hostPool ("10.9.0.0/16");
+  double animStart = 65.0;
+  double animStop = 80.0;
+  uint32_t animSampleEvery = 10;
+  double animSlot = 1.0;
+  std::string scheduler ("map");
+  std::string progressFile;
+  double progressInterval = 10.0;
 
   CommandLine cmd;
   cmd.AddValue ("verbose", "turn on log components", verbose);
   cmd.AddValue ("printRoutingTables", "Print routing tables at 30, 60 and 90 seconds", printRoutingTables);
   cmd.AddValue ("showPings", "Show Ping6 reception", showPings);
   cmd.AddValue ("splitHorizonStrategy", "Split Horizon strategy to use (NoSplitHorizon, SplitHorizon, PoisonReverse)", SplitHorizon);
+  cmd.AddValue ("topology", "Build the network from a text or binary topology file instead of the built-in graph", topologyFile);
+  cmd.AddValue ("saveBinaryTopology", "Write the loaded topology in binary form to this file", binaryTopology);
+  cmd.AddValue ("pingSrc", "Topology file node that sends the pings", pingSrc);
+  cmd.AddValue ("pingDst", "Topology file node that receives the pings", pingDst);
+  cmd.AddValue ("stopOnConvergence", "Stop once no RIP table changed for quietPeriod after the last failure", stopOnConvergence);
+  cmd.AddValue ("quietPeriod", "Seconds without RIP table changes that count as converged", quietPeriod);
+  cmd.AddValue ("snapshotPrefix", "Write binary RIP snapshots of all routers to <prefix>-<time>s.snap instead of printing tables", snapshotPrefix);
+  cmd.AddValue ("compressSnapshots", "Delta/varint-encode the snapshot columns", compressSnapshots);
+  cmd.AddValue ("journalFile", "Append every RIP route change of every router to this binary journal", journalFile);
+  cmd.AddValue ("ripOverhead", "Count RIP messages and bytes per interface and write them to this CSV file", overheadFile);
+  cmd.AddValue ("overheadBucket", "Time bucket of the RIP overhead counters, in seconds", overheadBucket);
+  cmd.AddValue ("oracle", "Check all RIP tables against shortest paths of the live topology at 15s and 85s; reports go to <prefix>-<time>s.txt", oraclePrefix);
+  cmd.AddValue ("oracleThreads", "Threads of the RIP table check (0: one per core)", oracleThreads);
+  cmd.AddValue ("capture", "Packet capture: all (every device, pcap and ascii), none, selective or ring", captureMode);
+  cmd.AddValue ("captureNodes", "Comma-separated node ids to capture on in selective and ring mode (default: all)", captureNodes);
+  cmd.AddValue ("captureProtocol", "Only capture these packets in selective and ring mode: any, icmp or rip", captureProtocol);
+  cmd.AddValue ("ringPackets", "Packets the ring mode keeps in memory", ringPackets);
+  cmd.AddValue ("ringWindow", "Seconds before and after each failure that ring mode writes out", ringWindow);
+  cmd.AddValue ("asyncTraces", "Write the capture=all traces from a background thread", asyncTraces);
+  cmd.AddValue ("faultSchedule", "Take links down/up and move nodes as listed in this file instead of the built-in failures", faultFile);
+  cmd.AddValue ("pingStats", "Keep ping RTT/loss statistics in memory and write <prefix>-*.csv at the end instead of printing every reply", pingStatsPrefix);
+  cmd.AddValue ("traffic", "Bulk flows from src to dst, measured with FlowMonitor: none, tcp (BulkSend), udp (OnOff) or both", trafficMode);
+  cmd.AddValue ("udpRate", "Sending rate of each UDP flow", udpRate);
+  cmd.AddValue ("trafficStart", "Start of the bulk flows, in seconds", trafficStart);
+  cmd.AddValue ("trafficStop", "End of the bulk flows, in seconds", trafficStop);
+  cmd.AddValue ("trafficInterval", "Seconds between two samples of the flow timeline", trafficInterval);
+  cmd.AddValue ("trafficPrefix", "Write the flow statistics to <prefix>-flows.csv and <prefix>-timeline.csv", trafficPrefix);
+  cmd.AddValue ("trafficMatrix", "Attach the hosts and run the bulk flows listed in this traffic matrix file, besides src -> dst", matrixFile);
+  cmd.AddValue ("hostPool", "Address pool of the links of traffic matrix hosts (a.b.c.d/len)", hostPool);
+  cmd.AddValue ("strayTraffic", "Also run the bulk flows from each unused host behind router C to dst", strayTraffic);
+  cmd.AddValue ("linkType", "Device of the two-node links (net1..net9, topology file \"link\"): csma or p2p (point-to-point)", linkType);
+  cmd.AddValue ("headless", "Large-run mode: no node names, NetAnim, packet capture or topology file positions", headless);
+  cmd.AddValue ("anim", "NetAnim output: full, off, topology, window (animStart..animStop) or sampled", animMode);
+  cmd.AddValue ("animStart", "Start of the window mode, in seconds", animStart);
+  cmd.AddValue ("animStop", "End of the window mode, in seconds", animStop);
+  cmd.AddValue ("animSampleEvery", "Sampled mode animates one slot out of this many", animSampleEvery);
+  cmd.AddValue ("animSlot", "Length of a sampled mode slot, in seconds", animSlot);
+  cmd.AddValue ("scheduler", "Event scheduler: map (ns-3 default), heap, list, calendar or priority-queue", scheduler);
+  cmd.AddValue ("progress", "Append simulated time, wall time, events, events/s and pending events to this CSV file as the run goes", progressFile);
+  cmd.AddValue ("progressInterval", "Simulated seconds between two progress rows", progressInterval);
   cmd.Parse (argc, argv);
 
+  // Both the built-in graph and a topology file run until 200 s.
+  SimProgress progress (scheduler, progressFile, Seconds (progressInterval));
+  progress.Start (Seconds (200.0));
+
+  PacketCapture capture (headless ? "none" : captureMode, captureNodes, captureProtocol, ringPackets);
+  capture.SetRingWindow (Seconds (ringWindow), Seconds (ringWindow));
+  AnimationMode animation (headless ? "off" : animMode);
+  animation.SetWindow (Seconds (animStart), Seconds (animStop));
+  animation.SetSampling (animSampleEvery, Seconds (animSlot));
+  BulkTraffic traffic (trafficMode, DataRate (udpRate), Seconds (trafficInterval));
+  NS_ABORT_MSG_UNLESS (linkType == "csma" || linkType == "p2p", "Unknown link type \"" << linkType << "\" (csma, p2p)");
+  bool pointToPoint = linkType == "p2p";
+  NS_ABORT_MSG_IF (!matrixFile.empty () && !traffic.IsEnabled (), "--trafficMatrix needs --traffic=tcp, udp or both");
+
   if (verbose)
     {
       LogComponentEnableAll (LogLevel (LOG_PREFIX_TIME | LOG_PREFIX_NODE));
@@ -72,35 +363,47 @@ int main (int argc, char **argv)
       Config::SetDefault ("ns3::Rip::SplitHorizon", EnumValue (RipNg::POISON_REVERSE));
     }
 
+  if (!topologyFile.empty ())
+    {
+      RunTopologyFile (topologyFile, binaryTopology, pingSrc, pingDst, printRoutingTables, showPings, capture, asyncTraces, faultFile, pingStatsPrefix,
+                       traffic, Seconds (trafficStart), Seconds (trafficStop), trafficPrefix, matrixFile, hostPool,
+                       headless, pointToPoint, oraclePrefix, oracleThreads, stopOnConvergence, quietPeriod,
+                       snapshotPrefix, compressSnapshots, journalFile, overheadFile, overheadBucket, animation);
+      return 0;
+    }
 
   // Create nodes compelete
   NS_LOG_INFO ("Create nodes.");
   Ptr<Node> src = CreateObject<Node> ();
-  Names::Add ("SrcNode", src);
   Ptr<Node> dst = CreateObject<Node> ();
-  Names::Add ("DstNode", dst);
   Ptr<Node> Ap = CreateObject<Node> ();
-  Names::Add ("Wifi", Ap);
   Ptr<Node> a = CreateObject<Node> ();
-  Names::Add ("RouterA", a);
   Ptr<Node> b = CreateObject<Node> ();
-  Names::Add ("RouterB", b);
   Ptr<Node> c = CreateObject<Node> ();
-  Names::Add ("RouterC", c);
   Ptr<Node> d = CreateObject<Node> ();
-  Names::Add ("RouterD", d);
   Ptr<Node> e = CreateObject<Node> ();
-  Names::Add ("RouterE", e);
   Ptr<Node> f = CreateObject<Node> ();
-  Names::Add ("RouterF", f);
   Ptr<Node> g = CreateObject<Node> ();
-  Names::Add ("RouterG", g);
-
   Ptr<Node> Asuna = CreateObject<Node> ();
-  Names::Add ("Asuna", Asuna);
-
   Ptr<Node> Kazuto = CreateObject<Node> ();
-  Names::Add ("Kazuto", Kazuto);
+  // Only NetAnim, fault files and traffic matrices read the names; a
+  // headless run skips the registry unless one of the files needs it.
+  bool registerNames = !headless || !faultFile.empty () || !matrixFile.empty ();
+  if (registerNames)
+    {
+      Names::Add ("SrcNode", src);
+      Names::Add ("DstNode", dst);
+      Names::Add ("Wifi", Ap);
+      Names::Add ("RouterA", a);
+      Names::Add ("RouterB", b);
+      Names::Add ("RouterC", c);
+      Names::Add ("RouterD", d);
+      Names::Add ("RouterE", e);
+      Names::Add ("RouterF", f);
+      Names::Add ("RouterG", g);
+      Names::Add ("Asuna", Asuna);
+      Names::Add ("Kazuto", Kazuto);
+    }
 
   NodeContainer net1 (src, a); // a->src is 1
   NodeContainer net2 (a, f);
@@ -122,6 +425,15 @@ int main (int argc, char **argv)
 
   NodeContainer unusefulAddtions;
   unusefulAddtions.Create(unusefulAmount);
+  if (registerNames)
+    {
+      for (int i = 0; i < unusefulAmount; i++)
+        {
+          std::ostringstream name;
+          name << "Idle" << i;
+          Names::Add (name.str (), unusefulAddtions.Get (i));
+        }
+    }
   NodeContainer unusefulCSMANodes;
   unusefulCSMANodes.Add(c);
   unusefulCSMANodes.Add(unusefulAddtions);
@@ -131,15 +443,19 @@ int main (int argc, char **argv)
   CsmaHelper csma;
   csma.SetChannelAttribute ("DataRate", DataRateValue (5000000));
   csma.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (2)));
-  NetDeviceContainer ndc1 = csma.Install (net1);
-  NetDeviceContainer ndc2 = csma.Install (net2);
-  NetDeviceContainer ndc3 = csma.Install (net3);
-  NetDeviceContainer ndc4 = csma.Install (net4);
-  NetDeviceContainer ndc5 = csma.Install (net5);
-  NetDeviceContainer ndc6 = csma.Install (net6);
-  NetDeviceContainer ndc7 = csma.Install (net7);
-  NetDeviceContainer ndc8 = csma.Install (net8);
-  NetDeviceContainer ndc9 = csma.Install (net9);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", DataRateValue (5000000));
+  p2p.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (2)));
+  // Same install order either way, so interface numbers do not change.
+  NetDeviceContainer ndc1 = InstallLink (csma, p2p, pointToPoint, net1);
+  NetDeviceContainer ndc2 = InstallLink (csma, p2p, pointToPoint, net2);
+  NetDeviceContainer ndc3 = InstallLink (csma, p2p, pointToPoint, net3);
+  NetDeviceContainer ndc4 = InstallLink (csma, p2p, pointToPoint, net4);
+  NetDeviceContainer ndc5 = InstallLink (csma, p2p, pointToPoint, net5);
+  NetDeviceContainer ndc6 = InstallLink (csma, p2p, pointToPoint, net6);
+  NetDeviceContainer ndc7 = InstallLink (csma, p2p, pointToPoint, net7);
+  NetDeviceContainer ndc8 = InstallLink (csma, p2p, pointToPoint, net8);
+  NetDeviceContainer ndc9 = InstallLink (csma, p2p, pointToPoint, net9);
 
   NetDeviceContainer unusefulNdc = csma.Install(unusefulCSMANodes);
 
@@ -328,8 +644,31 @@ int main (int argc, char **argv)
   staticRouting->SetDefaultRoute ("10.0.1.2", 1 );
   staticRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (dst->GetObject<Ipv4> ()->GetRoutingProtocol ());
   staticRouting->SetDefaultRoute ("10.0.9.1", 1 );
+  if (strayTraffic)
+    {
+      // The unused hosts only reach their own LAN unless routed through C.
+      for (int i = 0; i < unusefulAmount; i++)
+        {
+          staticRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (unusefulAddtions.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+          staticRouting->SetDefaultRoute ("10.8.1.1", 1 );
+        }
+    }
 
-  if (printRoutingTables)
+  // After the fixed default routes above, which the matrix keeps.
+  TrafficMatrix matrix;
+  if (!matrixFile.empty ())
+    {
+      matrix.Load (matrixFile);
+      matrix.AttachHosts (csma, p2p, pointToPoint, hostPool);
+    }
+
+  if (!snapshotPrefix.empty ())
+    {
+      NodeContainer routers (routers1, routers2);
+      ScheduleRipSnapshot (Seconds (15.0), routers, snapshotPrefix, compressSnapshots);
+      ScheduleRipSnapshot (Seconds (85.0), routers, snapshotPrefix, compressSnapshots);
+    }
+  else if (printRoutingTables)
     {
       RipHelper routingHelper;
 
@@ -353,6 +692,12 @@ int main (int argc, char **argv)
       routingHelper.PrintRoutingTableAt (Seconds (85.0), f, routingStream);
       routingHelper.PrintRoutingTableAt (Seconds (85.0), g, routingStream);
     }
+  RipOracle oracle (oracleThreads);
+  if (!oraclePrefix.empty ())
+    {
+      oracle.Schedule (Seconds (15.0), NodeContainer (routers1, routers2), oraclePrefix);
+      oracle.Schedule (Seconds (85.0), NodeContainer (routers1, routers2), oraclePrefix);
+    }
 
   NS_LOG_INFO ("Create Applications.");
   uint32_t packetSize = 1024;
@@ -366,7 +711,7 @@ int main (int argc, char **argv)
 //  pingWifi.SetAttribute ("Interval", TimeValue (interPacketInterval));
 //  pingWifi.SetAttribute ("Size", UintegerValue (packetSize));
 
-  if (showPings)
+  if (showPings && pingStatsPrefix.empty ())
     {
       ping.SetAttribute ("Verbose", BooleanValue (true));
 //      pingWifi.SetAttribute("Verbose", BooleanValue (true));
@@ -380,14 +725,93 @@ int main (int argc, char **argv)
 //  wifiApps.Start (Seconds (2.0));
 //  wifiApps.Stop (Seconds (150.0));
 
-  AsciiTraceHelper ascii;
-  csma.EnableAsciiAll (ascii.CreateFileStream ("rip-poi-routing.tr"));
-  csma.EnablePcapAll ("rip-poi-routing", true);
+  if (traffic.IsEnabled ())
+    {
+      traffic.AddFlows (src, dst, Seconds (trafficStart), Seconds (trafficStop));
+      if (strayTraffic)
+        {
+          for (int i = 0; i < unusefulAmount; i++)
+            {
+              traffic.AddFlows (unusefulAddtions.Get (i), dst, Seconds (trafficStart), Seconds (trafficStop));
+            }
+        }
+      matrix.AddFlows (traffic, Seconds (trafficStart), Seconds (trafficStop));
+      traffic.Start ();
+    }
 
+  AsyncTraceWriter *traceWriter = 0;
+  if (capture.GetMode () == PacketCapture::ALL && asyncTraces)
+    {
+      traceWriter = new AsyncTraceWriter;
+      Ptr<OutputStreamWrapper> stream = traceWriter->CreateFileStream ("rip-poi-routing.tr");
+      csma.EnableAsciiAll (stream);
+      p2p.EnableAsciiAll (stream);
+      traceWriter->EnablePcap (NodeContainer::GetGlobal (), "rip-poi-routing", true);
+    }
+  else if (capture.GetMode () == PacketCapture::ALL)
+    {
+      AsciiTraceHelper ascii;
+      Ptr<OutputStreamWrapper> stream = ascii.CreateFileStream ("rip-poi-routing.tr");
+      csma.EnableAsciiAll (stream);
+      p2p.EnableAsciiAll (stream);
+      csma.EnablePcapAll ("rip-poi-routing", true);
+      p2p.EnablePcapAll ("rip-poi-routing", true);
+    }
+  capture.Install (NodeContainer::GetGlobal (), "rip-poi-routing");
 
-  Simulator::Schedule(Seconds (20),&MoveOutNode,Ap);
-  Simulator::Schedule(Seconds (70), &TearDownLink,a,Ap,4,0);
-  Simulator::Schedule(Seconds (70), &TearDownLink,b,Ap,4,1); //83s reconnect
+  FaultSchedule faults;
+  if (!faultFile.empty ())
+    {
+      faults.Load (faultFile);
+    }
+  else
+    {
+      faults.AddMove (Seconds (20), Ap, Vector (800, 300, 0));
+      faults.AddLinkDown (Seconds (70), a, Ap);
+      faults.AddLinkDown (Seconds (70), b, Ap); //83s reconnect
+    }
+  std::vector<Time> faultTimes = faults.GetTimes ();
+  PingStats pingStats;
+  if (!pingStatsPrefix.empty ())
+    {
+      pingStats.Connect (src);
+    }
+  for (size_t i = 0; i < faultTimes.size (); i++)
+    {
+      capture.NotifyFailureAt (faultTimes[i]);
+      pingStats.NotifyFailureAt (faultTimes[i]);
+    }
+  faults.Start ();
+
+  RipTableWatcher ripWatcher;
+  RipConvergenceDetector *convergence = 0;
+  if (stopOnConvergence)
+    {
+      ripWatcher.Watch (routers1);
+      ripWatcher.Watch (routers2);
+      convergence = new RipConvergenceDetector (ripWatcher, Seconds (quietPeriod), true);
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          convergence->NotifyFailureAt (faultTimes[i]);
+        }
+    }
+  RipJournal *journal = 0;
+  if (!journalFile.empty ())
+    {
+      ripWatcher.Watch (routers1);
+      ripWatcher.Watch (routers2);
+      journal = new RipJournal (ripWatcher, journalFile);
+    }
+  if (convergence != 0 || journal != 0)
+    {
+      faults.AddLinkChangedCallback (MakeCallback (&RipTableWatcher::MarkDirty, &ripWatcher));
+    }
+  RipOverhead overhead (Seconds (overheadBucket));
+  if (!overheadFile.empty ())
+    {
+      overhead.Connect (routers1);
+      overhead.Connect (routers2);
+    }
 
   /*********************end*********************/
 
@@ -395,33 +819,60 @@ int main (int argc, char **argv)
   NS_LOG_INFO ("Run Simulation.");
   Simulator::Stop (Seconds (200.0));
 
-  AnimationInterface anim ("xmls/poi-rip.xml");
-  anim.UpdateNodeDescription(src,"source");
-  anim.UpdateNodeDescription(dst,"destination");
-  anim.UpdateNodeDescription(Ap,"AP");
-  anim.UpdateNodeDescription(Asuna,"Q1");
-  anim.UpdateNodeDescription(Kazuto,"Q2");
-  std::string descrip;
-  for (int i=0;i<5;i++)
-  {
-	  descrip = 'A' + i;
-	  anim.UpdateNodeDescription(routers1.Get(i),descrip);
-  }
-  anim.UpdateNodeDescription(f,"F");
-  anim.UpdateNodeDescription(g,"G");
-  anim.UpdateNodeColor(Ap,128,109,158);
-  anim.UpdateNodeColor(src,10,240,10);
-  anim.UpdateNodeColor(dst,10,10,240);
-  anim.UpdateNodeColor(Asuna,249,125,28);
-  anim.UpdateNodeColor(Kazuto,249,125,28);
-  for(int i=0;i<unusefulAmount;i++)
-  {
-	  anim.UpdateNodeColor(unusefulAddtions.Get(i),80,80,80);
-  }
+  AnimationInterface *anim = animation.Create ("xmls/poi-rip.xml");
+  if (anim != 0)
+    {
+      anim->UpdateNodeDescription(src,"source");
+      anim->UpdateNodeDescription(dst,"destination");
+      anim->UpdateNodeDescription(Ap,"AP");
+      anim->UpdateNodeDescription(Asuna,"Q1");
+      anim->UpdateNodeDescription(Kazuto,"Q2");
+      std::string descrip;
+      for (int i=0;i<5;i++)
+      {
+        descrip = 'A' + i;
+        anim->UpdateNodeDescription(routers1.Get(i),descrip);
+      }
+      anim->UpdateNodeDescription(f,"F");
+      anim->UpdateNodeDescription(g,"G");
+      anim->UpdateNodeColor(Ap,128,109,158);
+      anim->UpdateNodeColor(src,10,240,10);
+      anim->UpdateNodeColor(dst,10,10,240);
+      anim->UpdateNodeColor(Asuna,249,125,28);
+      anim->UpdateNodeColor(Kazuto,249,125,28);
+      for(int i=0;i<unusefulAmount;i++)
+      {
+        anim->UpdateNodeColor(unusefulAddtions.Get(i),80,80,80);
+      }
+    }
 
-  csma.EnablePcapAll("pcap/mycsma");
+  if (traceWriter != 0)
+    {
+      traceWriter->EnablePcap (NodeContainer::GetGlobal (), "pcap/mycsma", false);
+    }
+  else if (capture.GetMode () == PacketCapture::ALL)
+    {
+      csma.EnablePcapAll("pcap/mycsma");
+      p2p.EnablePcapAll("pcap/mycsma");
+    }
 
-  Simulator::Run ();
+  RunAndReport ();
+  if (!pingStatsPrefix.empty ())
+    {
+      pingStats.Write (pingStatsPrefix);
+    }
+  if (traffic.IsEnabled ())
+    {
+      traffic.Write (trafficPrefix);
+    }
+  if (!overheadFile.empty ())
+    {
+      overhead.Write (overheadFile);
+    }
   Simulator::Destroy ();
+  animation.Finish ();
+  delete traceWriter;
+  delete convergence;
+  delete journal;
   NS_LOG_INFO ("Done.");
 }
@@ -0,0 +1,126 @@
+#ifndef ANIM_MODE_H
+#define ANIM_MODE_H
+
+#include <string>
+#include <sys/stat.h>
+#include "ns3/core-module.h"
+#include "ns3/netanim-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Creates the AnimationInterface for an --anim mode.
+ *
+ *  - "full": every packet for the whole run, as before.
+ *  - "off": no animation file.
+ *  - "topology": nodes, links and descriptions only (SkipPacketTracing).
+ *  - "window": packets between two times only.
+ *  - "sampled": packets during one slot out of every N.
+ *
+ * AnimationInterface has no per-packet filter, so "sampled" keeps 1-in-N
+ * time slots rather than 1-in-N packets, by moving the interface's time
+ * window from slot to slot.
+ */
+class AnimationMode
+{
+public:
+  AnimationMode (const std::string &mode);
+
+  void SetWindow (Time start, Time stop);
+  void SetSampling (uint32_t every, Time slot);
+
+  /// The interface to decorate, or 0 in "off" mode.
+  AnimationInterface *Create (const std::string &path);
+  /// Close the file (after Simulator::Destroy) and report its size.
+  void Finish (void);
+
+private:
+  void OpenSlot (void);
+
+  std::string m_mode;
+  std::string m_path;
+  AnimationInterface *m_anim;
+  Time m_start;
+  Time m_stop;
+  uint32_t m_every;
+  Time m_slot;
+};
+
+inline
+AnimationMode::AnimationMode (const std::string &mode)
+  : m_mode (mode),
+    m_anim (0),
+    m_every (10),
+    m_slot (Seconds (1))
+{
+  NS_ABORT_MSG_UNLESS (mode == "full" || mode == "off" || mode == "topology" || mode == "window" || mode == "sampled",
+                       "Unknown animation mode \"" << mode << "\" (full, off, topology, window, sampled)");
+}
+
+inline void
+AnimationMode::SetWindow (Time start, Time stop)
+{
+  m_start = start;
+  m_stop = stop;
+}
+
+inline void
+AnimationMode::SetSampling (uint32_t every, Time slot)
+{
+  NS_ABORT_MSG_IF (every == 0, "Animation sampling needs N >= 1");
+  m_every = every;
+  m_slot = slot;
+}
+
+inline AnimationInterface *
+AnimationMode::Create (const std::string &path)
+{
+  if (m_mode == "off")
+    {
+      return 0;
+    }
+  m_path = path;
+  m_anim = new AnimationInterface (path);
+  if (m_mode == "topology")
+    {
+      m_anim->SkipPacketTracing ();
+    }
+  else if (m_mode == "window")
+    {
+      m_anim->SetStartTime (m_start);
+      m_anim->SetStopTime (m_stop);
+    }
+  else if (m_mode == "sampled")
+    {
+      OpenSlot ();
+    }
+  return m_anim;
+}
+
+inline void
+AnimationMode::OpenSlot (void)
+{
+  m_anim->SetStartTime (Simulator::Now ());
+  m_anim->SetStopTime (Simulator::Now () + m_slot);
+  Simulator::Schedule (Seconds (m_slot.GetSeconds () * m_every), &AnimationMode::OpenSlot, this);
+}
+
+inline void
+AnimationMode::Finish (void)
+{
+  if (m_anim == 0)
+    {
+      return;
+    }
+  delete m_anim;
+  m_anim = 0;
+  struct stat st;
+  if (stat (m_path.c_str (), &st) == 0)
+    {
+      std::cout<<"INFO: NetAnim ("<<m_mode<<") wrote "<<st.st_size / 1024<<" KiB to "<<m_path<<"\n";
+    }
+}
+
+} // namespace ns3
+
+#endif /* ANIM_MODE_H */
@@ -0,0 +1,427 @@
+#ifndef ASYNC_TRACE_WRITER_H
+#define ASYNC_TRACE_WRITER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Trace files whose bytes are written by a background thread.
+ *
+ * Each file is an std::ostream over a fixed-size buffer taken from a shared
+ * pool, taken on the first write. Trace sinks only format into that buffer;
+ * a full buffer is queued and a writer thread hands runs of queued buffers
+ * to writev, then returns them to the pool. The simulator thread only waits
+ * when the pool is used up and some buffers are still being written.
+ * Streams ignore flushes (std::endl), so the ASCII helpers do not turn every
+ * line into a system call.
+ *
+ * Close() drains everything; it is scheduled to run at Simulator::Destroy.
+ */
+class AsyncTraceWriter
+{
+public:
+  /**
+   * \param bufferSize bytes per buffer
+   * \param maxBuffers buffers in the pool; every file that has been written
+   * to holds one, so this grows past the limit rather than deadlock
+   */
+  AsyncTraceWriter (size_t bufferSize = 16 * 1024, size_t maxBuffers = 16384);
+  ~AsyncTraceWriter ();
+
+  /// An ASCII trace stream, to pass to EnableAsciiAll and friends.
+  Ptr<OutputStreamWrapper> CreateFileStream (const std::string &path);
+  /**
+   * \brief Write a pcap file per CSMA or point-to-point device of these
+   * nodes, named like CsmaHelper/PointToPointHelper::EnablePcapAll name them.
+   */
+  void EnablePcap (NodeContainer nodes, const std::string &prefix, bool promiscuous);
+
+  void Close (void);
+
+private:
+  struct Buffer
+  {
+    std::vector<char> data;
+    size_t length;
+    int fd;
+  };
+
+  class Stream : public std::streambuf
+  {
+  public:
+    Stream (AsyncTraceWriter *writer, int fd);
+    void Flush (void);
+
+  protected:
+    virtual int_type overflow (int_type c);
+    virtual std::streamsize xsputn (const char *s, std::streamsize n);
+    virtual int sync (void);
+
+  private:
+    void Take (void);
+    void HandOff (void);
+
+    AsyncTraceWriter *m_writer;
+    int m_fd;
+    Buffer *m_buffer;
+  };
+
+  static void WritePcapRecord (std::ostream *os, Ptr<const Packet> packet);
+  std::ostream *Open (const std::string &path);
+  Buffer *Acquire (void);
+  void Submit (Buffer *buffer);
+  void Release (Buffer *buffer);
+  void Run (void);
+  void WriteBatch (const std::vector<Buffer *> &batch);
+
+  size_t m_bufferSize;
+  size_t m_maxBuffers;
+  size_t m_allocated;
+  size_t m_inFlight;
+  std::vector<Buffer *> m_free;
+  std::deque<Buffer *> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::condition_variable m_returned;
+  std::thread m_thread;
+  bool m_stop;
+  bool m_closed;
+  int m_error;
+  uint64_t m_bytes;
+  uint64_t m_stalls;
+  std::vector<int> m_fds;
+  std::vector<Stream *> m_streams;
+  std::vector<std::ostream *> m_ostreams;
+};
+
+inline
+AsyncTraceWriter::Stream::Stream (AsyncTraceWriter *writer, int fd)
+  : m_writer (writer),
+    m_fd (fd),
+    m_buffer (0)
+{
+}
+
+inline void
+AsyncTraceWriter::Stream::Take (void)
+{
+  m_buffer = m_writer->Acquire ();
+  m_buffer->fd = m_fd;
+  setp (m_buffer->data.data (), m_buffer->data.data () + m_buffer->data.size ());
+}
+
+inline void
+AsyncTraceWriter::Stream::HandOff (void)
+{
+  if (m_buffer != 0)
+    {
+      m_buffer->length = pptr () - pbase ();
+      m_writer->Submit (m_buffer);
+    }
+  Take ();
+}
+
+inline void
+AsyncTraceWriter::Stream::Flush (void)
+{
+  if (m_buffer == 0)
+    {
+      return;
+    }
+  m_buffer->length = pptr () - pbase ();
+  if (m_buffer->length > 0)
+    {
+      m_writer->Submit (m_buffer);
+    }
+  else
+    {
+      m_writer->Release (m_buffer);
+    }
+  m_buffer = 0;
+  setp (0, 0);
+}
+
+inline AsyncTraceWriter::Stream::int_type
+AsyncTraceWriter::Stream::overflow (int_type c)
+{
+  HandOff ();
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+inline std::streamsize
+AsyncTraceWriter::Stream::xsputn (const char *s, std::streamsize n)
+{
+  std::streamsize done = 0;
+  while (done < n)
+    {
+      if (pptr () == epptr ())
+        {
+          HandOff ();
+        }
+      std::streamsize chunk = std::min<std::streamsize> (n - done, epptr () - pptr ());
+      std::memcpy (pptr (), s + done, chunk);
+      pbump (int (chunk));
+      done += chunk;
+    }
+  return n;
+}
+
+inline int
+AsyncTraceWriter::Stream::sync (void)
+{
+  return 0;
+}
+
+inline
+AsyncTraceWriter::AsyncTraceWriter (size_t bufferSize, size_t maxBuffers)
+  : m_bufferSize (bufferSize),
+    m_maxBuffers (maxBuffers),
+    m_allocated (0),
+    m_inFlight (0),
+    m_stop (false),
+    m_closed (false),
+    m_error (0),
+    m_bytes (0),
+    m_stalls (0)
+{
+  m_thread = std::thread (&AsyncTraceWriter::Run, this);
+  Simulator::ScheduleDestroy (&AsyncTraceWriter::Close, this);
+}
+
+inline
+AsyncTraceWriter::~AsyncTraceWriter ()
+{
+  Close ();
+  for (size_t i = 0; i < m_ostreams.size (); ++i)
+    {
+      delete m_ostreams[i];
+      delete m_streams[i];
+    }
+  for (size_t i = 0; i < m_free.size (); ++i)
+    {
+      delete m_free[i];
+    }
+}
+
+inline std::ostream *
+AsyncTraceWriter::Open (const std::string &path)
+{
+  NS_ABORT_MSG_IF (m_closed, "AsyncTraceWriter: " << path << " opened after Close");
+  int fd = ::open (path.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot write trace file " << path);
+  m_fds.push_back (fd);
+  m_streams.push_back (new Stream (this, fd));
+  m_ostreams.push_back (new std::ostream (m_streams.back ()));
+  return m_ostreams.back ();
+}
+
+inline Ptr<OutputStreamWrapper>
+AsyncTraceWriter::CreateFileStream (const std::string &path)
+{
+  return Create<OutputStreamWrapper> (Open (path));
+}
+
+inline void
+AsyncTraceWriter::EnablePcap (NodeContainer nodes, const std::string &prefix, bool promiscuous)
+{
+  PcapHelper pcapHelper;
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      for (uint32_t i = 0; i < (*it)->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> device = (*it)->GetDevice (i);
+          uint32_t linkType;
+          if (DynamicCast<CsmaNetDevice> (device) != 0)
+            {
+              linkType = PcapHelper::DLT_EN10MB;
+            }
+          else if (DynamicCast<PointToPointNetDevice> (device) != 0)
+            {
+              linkType = PcapHelper::DLT_PPP;
+            }
+          else
+            {
+              continue;
+            }
+          std::ostream *os = Open (pcapHelper.GetFilenameFromDevice (prefix, device));
+          // Classic pcap header: microsecond timestamps, Ethernet or PPP frames.
+          uint32_t header[6] = { 0xa1b2c3d4, 2 | (4 << 16), 0, 0, 65535, linkType };
+          os->write (reinterpret_cast<const char *> (header), sizeof (header));
+          device->TraceConnectWithoutContext (promiscuous ? "PromiscSniffer" : "Sniffer",
+                                              MakeBoundCallback (&AsyncTraceWriter::WritePcapRecord, os));
+        }
+    }
+}
+
+inline void
+AsyncTraceWriter::WritePcapRecord (std::ostream *os, Ptr<const Packet> packet)
+{
+  static std::vector<uint8_t> scratch;
+  uint32_t size = packet->GetSize ();
+  uint32_t captured = std::min<uint32_t> (size, 65535);
+  if (scratch.size () < captured)
+    {
+      scratch.resize (captured);
+    }
+  packet->CopyData (scratch.data (), captured);
+  int64_t us = Simulator::Now ().GetMicroSeconds ();
+  uint32_t record[4] = { uint32_t (us / 1000000), uint32_t (us % 1000000), captured, size };
+  os->write (reinterpret_cast<const char *> (record), sizeof (record));
+  os->write (reinterpret_cast<const char *> (scratch.data ()), captured);
+}
+
+inline AsyncTraceWriter::Buffer *
+AsyncTraceWriter::Acquire (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (m_free.empty () && m_allocated >= m_maxBuffers && m_inFlight > 0)
+    {
+      ++m_stalls;
+      m_returned.wait (lock, [this] { return !m_free.empty () || m_inFlight == 0; });
+    }
+  if (m_free.empty ())
+    {
+      ++m_allocated;
+      Buffer *buffer = new Buffer;
+      buffer->data.resize (m_bufferSize);
+      return buffer;
+    }
+  Buffer *buffer = m_free.back ();
+  m_free.pop_back ();
+  return buffer;
+}
+
+inline void
+AsyncTraceWriter::Submit (Buffer *buffer)
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_queue.push_back (buffer);
+    ++m_inFlight;
+  }
+  m_work.notify_one ();
+}
+
+inline void
+AsyncTraceWriter::Release (Buffer *buffer)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_free.push_back (buffer);
+}
+
+inline void
+AsyncTraceWriter::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_work.wait (lock, [this] { return m_stop || !m_queue.empty (); });
+      if (m_queue.empty ())
+        {
+          return;
+        }
+      std::vector<Buffer *> batch (m_queue.begin (), m_queue.end ());
+      m_queue.clear ();
+      lock.unlock ();
+      WriteBatch (batch);
+      lock.lock ();
+      m_free.insert (m_free.end (), batch.begin (), batch.end ());
+      m_inFlight -= batch.size ();
+      m_returned.notify_all ();
+    }
+}
+
+inline void
+AsyncTraceWriter::WriteBatch (const std::vector<Buffer *> &batch)
+{
+  // Buffers of one file stay in submission order; consecutive ones go out
+  // in a single writev.
+  size_t i = 0;
+  while (i < batch.size ())
+    {
+      std::vector<struct iovec> iov;
+      int fd = batch[i]->fd;
+      for (; i < batch.size () && batch[i]->fd == fd && iov.size () < IOV_MAX; ++i)
+        {
+          struct iovec v;
+          v.iov_base = batch[i]->data.data ();
+          v.iov_len = batch[i]->length;
+          iov.push_back (v);
+          m_bytes += v.iov_len;
+        }
+      size_t first = 0;
+      while (first < iov.size () && m_error == 0)
+        {
+          ssize_t n = ::writev (fd, &iov[first], int (iov.size () - first));
+          if (n < 0)
+            {
+              m_error = errno;
+              break;
+            }
+          while (first < iov.size () && size_t (n) >= iov[first].iov_len)
+            {
+              n -= iov[first++].iov_len;
+            }
+          if (first < iov.size ())
+            {
+              iov[first].iov_base = static_cast<char *> (iov[first].iov_base) + n;
+              iov[first].iov_len -= n;
+            }
+        }
+    }
+}
+
+inline void
+AsyncTraceWriter::Close (void)
+{
+  if (m_closed)
+    {
+      return;
+    }
+  m_closed = true;
+  for (size_t i = 0; i < m_streams.size (); ++i)
+    {
+      m_streams[i]->Flush ();
+    }
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_one ();
+  m_thread.join ();
+  for (size_t i = 0; i < m_fds.size (); ++i)
+    {
+      ::close (m_fds[i]);
+    }
+  NS_ABORT_MSG_IF (m_error != 0, "Writing trace files failed: " << std::strerror (m_error));
+  std::cout<<"INFO: Async trace writer wrote "<<m_bytes<<" bytes to "<<m_fds.size ()<<" files, "
+           <<m_allocated<<" buffers, "<<m_stalls<<" stalls\n";
+}
+
+} // namespace ns3
+
+#endif /* ASYNC_TRACE_WRITER_H */
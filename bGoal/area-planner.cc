@@ -0,0 +1,86 @@
+#include <cstdlib>
+#include "area-planner.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+AreaPlanner::AreaPlanner (Ipv4Address pool, uint32_t poolPrefix, uint32_t linkPrefix, uint32_t nAreas, uint32_t linksPerArea)
+{
+  NS_ABORT_MSG_IF (nAreas == 0 || linksPerArea == 0, "AreaPlanner: need at least one area and one link per area");
+  uint32_t bits = 0;
+  while ((1u << bits) < linksPerArea)
+    {
+      ++bits;
+    }
+  NS_ABORT_MSG_IF (bits > linkPrefix - poolPrefix,
+                   "AreaPlanner: " << linksPerArea << " /" << linkPrefix << " links do not fit in pool /" << poolPrefix);
+  m_areaPrefix = linkPrefix - bits;
+  uint64_t blocks = uint64_t (1) << (m_areaPrefix - poolPrefix);
+  NS_ABORT_MSG_IF (nAreas > blocks,
+                   "AreaPlanner: pool " << pool << "/" << poolPrefix << " only has room for " << blocks
+                   << " areas of /" << m_areaPrefix << ", " << nAreas << " needed");
+
+  // The areas are the first nAreas /m_areaPrefix blocks of the pool.
+  SubnetAllocator pools (pool, poolPrefix, linkPrefix);
+  uint32_t base = pools.GetBase ().Get ();
+  uint32_t blockSize = 1u << (32 - m_areaPrefix);
+  m_areas.reserve (nAreas);
+  for (uint32_t a = 0; a < nAreas; ++a)
+    {
+      m_areas.push_back (SubnetAllocator (Ipv4Address (base + a * blockSize), m_areaPrefix, linkPrefix));
+    }
+}
+
+AreaPlanner
+AreaPlanner::FromString (const std::string &pool, uint32_t linkPrefix, uint32_t nAreas, uint32_t linksPerArea)
+{
+  std::string::size_type slash = pool.find ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos, "AreaPlanner: pool \"" << pool << "\" is not in a.b.c.d/len form");
+  Ipv4Address base (pool.substr (0, slash).c_str ());
+  uint32_t prefix = std::atoi (pool.substr (slash + 1).c_str ());
+  return AreaPlanner (base, prefix, linkPrefix, nAreas, linksPerArea);
+}
+
+Ipv4InterfaceContainer
+AreaPlanner::AssignLink (uint32_t area, const NetDeviceContainer &devices)
+{
+  NS_ABORT_MSG_IF (area >= m_areas.size (), "AreaPlanner: no area " << area);
+  return m_areas[area].AssignLink (devices);
+}
+
+uint32_t
+AreaPlanner::GetNAreas (void) const
+{
+  return m_areas.size ();
+}
+
+Ipv4Address
+AreaPlanner::GetAreaNetwork (uint32_t area) const
+{
+  return m_areas[area].GetBase ();
+}
+
+Ipv4Mask
+AreaPlanner::GetAreaMask (void) const
+{
+  return Ipv4Mask (m_areaPrefix == 0 ? 0 : 0xffffffffu << (32 - m_areaPrefix));
+}
+
+uint32_t
+AreaPlanner::GetAreaPrefix (void) const
+{
+  return m_areaPrefix;
+}
+
+uint32_t
+AreaPlanner::GetAllocated (void) const
+{
+  uint32_t allocated = 0;
+  for (size_t a = 0; a < m_areas.size (); ++a)
+    {
+      allocated += m_areas[a].GetAllocated ();
+    }
+  return allocated;
+}
+
+} // namespace ns3
@@ -0,0 +1,56 @@
+#ifndef AREA_PLANNER_H
+#define AREA_PLANNER_H
+
+#include <string>
+#include <vector>
+#include "subnet-allocator.h"
+
+namespace ns3 {
+
+/**
+ * \brief Hands out link subnets by area, one aligned block per area.
+ *
+ * Each area gets the smallest power-of-two block of the pool that holds
+ * linksPerArea links, and its links are allocated inside that block with a
+ * SubnetAllocator of its own. Every link of an area is then covered by one
+ * prefix, which a border router can advertise in place of all of them
+ * (RipTrie::AddSummary).
+ */
+class AreaPlanner
+{
+public:
+  /**
+   * \param pool network address of the pool
+   * \param poolPrefix prefix length of the pool
+   * \param linkPrefix prefix length of each link (30 or 31)
+   * \param nAreas number of areas
+   * \param linksPerArea most links any area will take
+   */
+  AreaPlanner (Ipv4Address pool, uint32_t poolPrefix, uint32_t linkPrefix, uint32_t nAreas, uint32_t linksPerArea);
+
+  /**
+   * \brief Parse a pool given as "a.b.c.d/len". Only used once at startup.
+   */
+  static AreaPlanner FromString (const std::string &pool, uint32_t linkPrefix, uint32_t nAreas, uint32_t linksPerArea);
+
+  /**
+   * \brief Allocate a link in an area and assign its host addresses, as
+   * SubnetAllocator::AssignLink.
+   */
+  Ipv4InterfaceContainer AssignLink (uint32_t area, const NetDeviceContainer &devices);
+
+  uint32_t GetNAreas (void) const;
+  Ipv4Address GetAreaNetwork (uint32_t area) const;
+  Ipv4Mask GetAreaMask (void) const;
+  uint32_t GetAreaPrefix (void) const;
+  /// Links allocated in all areas.
+  uint32_t GetAllocated (void) const;
+
+private:
+  uint32_t m_areaPrefix;
+  std::vector<SubnetAllocator> m_areas;
+};
+
+} // namespace ns3
+
+#endif /* AREA_PLANNER_H */
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -13,17 +14,36 @@
 #include "ns3/mobility-module.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/point-to-point-module.h"
+#ifdef NS3_MPI
+#include <mpi.h>
+#include "ns3/mpi-interface.h"
+#endif
+#include "subnet-allocator.h"
+#include "area-planner.h"
+#include "topology-generator.h"
+#include "run-result.h"
+#include "rip-trie-helper.h"
+#include "rip-trie.h"
+#include "../rip-convergence.h"
+#include "../rip-snapshot.h"
+#include "../rip-journal.h"
+#include "../packet-capture.h"
+#include "../async-trace-writer.h"
+#include "../anim-mode.h"
+#include "../fault-schedule.h"
+#include "../ping-stats.h"
+#include "../bulk-traffic.h"
+#include "../traffic-matrix.h"
+#include "../rip-warm-start.h"
+#include "../rip-overhead.h"
+#include "../rip-oracle.h"
+#include "../sim-progress.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("PoiRipRouting");
 
-void TearDownLink (Ptr<Node> nodeA, Ptr<Node> nodeB, uint32_t interfaceA, uint32_t interfaceB)
-{
-  nodeA->GetObject<Ipv4> ()->SetDown (interfaceA);
-  nodeB->GetObject<Ipv4> ()->SetDown (interfaceB);
-}
-
 void MoveOutNode (Ptr<Node> nodeA)
 {
   ListPositionAllocator nodesPositionAllocator;
@@ -35,45 +55,77 @@ void MoveOutNode (Ptr<Node> nodeA)
   nodesmobility.Install(nodeA);
 }
 
-void removeConnRandomly(int routersAmount, std::vector<int>& ableNodesVec,NodeContainer& routers)
+NetDeviceContainer InstallLink (CsmaHelper& csma, PointToPointHelper& p2p, bool pointToPoint, Ptr<Node> nodeA, Ptr<Node> nodeB)
 {
-
-	RngSeedManager::SetSeed(routersAmount); // Random Seed
-    double minRandom = 0.0;
-    double maxRandom = 10.0;
-    Ptr<UniformRandomVariable> uvRandom = CreateObject<UniformRandomVariable>();
-    uvRandom->SetAttribute("Min",DoubleValue(minRandom));
-    uvRandom->SetAttribute("Max",DoubleValue(maxRandom));
-    bool isDelRandomly = false;
-
-    for(int x:ableNodesVec)
-    {
-    	double r = uvRandom->GetValue();
-    	if(r > 5) //percent : 50%
-    	{
-    		TearDownLink(routers.Get(x),routers.Get(x+2),3,3);
-    		isDelRandomly = true;
-
-    		std::cout<<"INFO: Connection between "<< x+2 <<" "<< x+4 <<" has been teared down\n";
-    	}
-//    	if(removeAmount <= 0)
-//    		break;
-//    	TearDownLink(routers.Get(x),routers.Get(x+2),3,3);
-//    	removeAmount --;
-    }
-
-    if(!isDelRandomly)
+  // ns-3 can only split a simulation across point-to-point channels, so a
+  // link whose ends live on different MPI ranks becomes a remote p2p link.
+  if (pointToPoint || nodeA->GetSystemId () != nodeB->GetSystemId ())
     {
-    	TearDownLink(routers.Get(ableNodesVec.at(0)),routers.Get(ableNodesVec.at(0)+2),3,3);
+      return p2p.Install (nodeA, nodeB);
     }
+  return csma.Install (NodeContainer (nodeA, nodeB));
 }
+
 int main (int argc, char **argv)
 {
+  std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now ();
   bool verbose = false;
   bool printRoutingTables = true;
   bool showPings = true;
   int routersAmount = 4;
+  std::string topology ("chain");
+  double avgDegree = 4.0;
+  uint32_t topologyStream = 0;
   std::string SplitHorizon ("PoisonReverse");
+  std::string chainPool ("10.0.0.0/14");
+  std::string skipPool ("10.168.0.0/14");
+  uint32_t linkPrefix = 30;
+  std::string linkType ("csma");
+  std::string ripTable ("list");
+  uint32_t areaSize = 0;
+  bool summarize = false;
+  std::string scheduler ("map");
+  std::string progressFile;
+  double progressInterval = 10.0;
+  bool buildOnly = false;
+  std::string resultFile;
+  bool distributed = false;
+  bool stopOnConvergence = false;
+  double quietPeriod = 60.0;
+  bool tableChanges = false;
+  std::string snapshotPrefix;
+  bool compressSnapshots = true;
+  std::string journalFile;
+  std::string overheadFile;
+  std::string oraclePrefix;
+  uint32_t oracleThreads = 0;
+  double overheadBucket = 10.0;
+  std::string captureMode ("all");
+  std::string captureNodes;
+  std::string captureProtocol ("any");
+  uint32_t ringPackets = 100000;
+  double ringWindow = 5.0;
+  bool asyncTraces = false;
+  std::string animMode ("full");
+  std::string faultFile;
+  std::string pingStatsPrefix;
+  bool headless = false;
+  std::string checkpointFile;
+  double checkpointAt = 39.0;
+  std::string warmStartFile;
+  double warmFailureAt = 5.0;
+  std::string trafficMode ("none");
+  std::string udpRate ("1Mbps");
+  double trafficStart = 10.0;
+  double trafficStop = 100.0;
+  double trafficInterval = 0.5;
+  std::string trafficPrefix ("rip-poi-B-traffic");
+  std::string matrixFile;
+  std::string hostPool ("10.9.0.0/16");
+  double animStart = 35.0;
+  double animStop = 60.0;
+  uint32_t animSampleEvery = 10;
+  double animSlot = 1.0;
 
   CommandLine cmd;
   cmd.AddValue ("verbose", "turn on log components", verbose);
@@ -81,14 +133,153 @@ int main (int argc, char **argv)
   cmd.AddValue ("showPings", "Show Ping6 reception", showPings);
   cmd.AddValue ("splitHorizonStrategy", "Split Horizon strategy to use (NoSplitHorizon, SplitHorizon, PoisonReverse)", SplitHorizon);
   cmd.AddValue ("amount","The amount of routers", routersAmount);
+  cmd.AddValue ("topology", "Router graph: chain (with random i -> i+2 skip links), grid, ring (with chords), er (Erdos-Renyi) or ba (Barabasi-Albert)", topology);
+  cmd.AddValue ("avgDegree", "Average router degree of the ring, er and ba topologies (ba is a tree below 3)", avgDegree);
+  cmd.AddValue ("topologyStream", "Random stream of the ring, er and ba topologies; the graph also follows RngSeed and RngRun", topologyStream);
+  cmd.AddValue ("chainPool", "Address pool for the i -> i+1 chain links (a.b.c.d/len)", chainPool);
+  cmd.AddValue ("skipPool", "Address pool for the i -> i+2 skip links (a.b.c.d/len)", skipPool);
+  cmd.AddValue ("linkPrefix", "Prefix length of every router-router link (30 or 31)", linkPrefix);
+  cmd.AddValue ("linkType", "Device of every two-node link: csma or p2p (point-to-point, no CSMA backoff or broadcast channel)", linkType);
+  cmd.AddValue ("ripTable", "RIP route table: list (stock ns3::Rip) or trie (RipTrie, longest-prefix match in a prefix trie)", ripTable);
+  cmd.AddValue ("areaSize", "Routers per address area of the chain; each area's links come from one block of chainPool (0: flat plan)", areaSize);
+  cmd.AddValue ("summarize", "Advertise each area as one prefix across its borders instead of its links (needs areaSize and ripTable=trie)", summarize);
+  cmd.AddValue ("scheduler", "Event scheduler: map (ns-3 default), heap, list, calendar or priority-queue", scheduler);
+  cmd.AddValue ("progress", "Append simulated time, wall time, events, events/s and pending events to this CSV file as the run goes", progressFile);
+  cmd.AddValue ("progressInterval", "Simulated seconds between two progress rows", progressInterval);
+  cmd.AddValue ("buildOnly", "Report the topology build time and exit without simulating", buildOnly);
+  cmd.AddValue ("resultFile", "Write a key=value summary of the run to this file", resultFile);
+  cmd.AddValue ("distributed", "Split the router chain across MPI ranks (run under mpirun -np N); disables tracing and NetAnim", distributed);
+  cmd.AddValue ("stopOnConvergence", "Stop once no RIP table changed for quietPeriod after the last failure", stopOnConvergence);
+  cmd.AddValue ("quietPeriod", "Seconds without RIP table changes that count as converged", quietPeriod);
+  cmd.AddValue ("tableChanges", "Watch every RIP table and put the convergence time and table changes in the result file", tableChanges);
+  cmd.AddValue ("snapshotPrefix", "Write binary RIP snapshots of all routers to <prefix>-<time>s.snap instead of printing tables", snapshotPrefix);
+  cmd.AddValue ("compressSnapshots", "Delta/varint-encode the snapshot columns", compressSnapshots);
+  cmd.AddValue ("journalFile", "Append every RIP route change of every router to this binary journal", journalFile);
+  cmd.AddValue ("ripOverhead", "Count RIP messages and bytes per interface and write them to this CSV file", overheadFile);
+  cmd.AddValue ("overheadBucket", "Time bucket of the RIP overhead counters, in seconds", overheadBucket);
+  cmd.AddValue ("oracle", "Check all RIP tables against shortest paths of the live topology when the tables are printed; reports go to <prefix>-<time>s.txt", oraclePrefix);
+  cmd.AddValue ("oracleThreads", "Threads of the RIP table check (0: one per core)", oracleThreads);
+  cmd.AddValue ("capture", "Packet capture: all (every device, pcap and ascii), none, selective or ring", captureMode);
+  cmd.AddValue ("captureNodes", "Comma-separated node ids to capture on in selective and ring mode (default: all)", captureNodes);
+  cmd.AddValue ("captureProtocol", "Only capture these packets in selective and ring mode: any, icmp or rip", captureProtocol);
+  cmd.AddValue ("ringPackets", "Packets the ring mode keeps in memory", ringPackets);
+  cmd.AddValue ("ringWindow", "Seconds before and after each failure that ring mode writes out", ringWindow);
+  cmd.AddValue ("asyncTraces", "Write the capture=all traces from a background thread", asyncTraces);
+  cmd.AddValue ("faultSchedule", "Take links down/up and move nodes as listed in this file instead of the random skip-link failures", faultFile);
+  cmd.AddValue ("pingStats", "Keep ping RTT/loss statistics in memory and write <prefix>-*.csv at the end instead of printing every reply", pingStatsPrefix);
+  cmd.AddValue ("traffic", "Bulk flows from src to dst, measured with FlowMonitor: none, tcp (BulkSend), udp (OnOff) or both", trafficMode);
+  cmd.AddValue ("udpRate", "Sending rate of each UDP flow", udpRate);
+  cmd.AddValue ("trafficStart", "Start of the bulk flows, in seconds", trafficStart);
+  cmd.AddValue ("trafficStop", "End of the bulk flows, in seconds", trafficStop);
+  cmd.AddValue ("trafficInterval", "Seconds between two samples of the flow timeline", trafficInterval);
+  cmd.AddValue ("trafficPrefix", "Write the flow statistics to <prefix>-flows.csv and <prefix>-timeline.csv", trafficPrefix);
+  cmd.AddValue ("trafficMatrix", "Attach the hosts and run the bulk flows listed in this traffic matrix file, besides src -> dst; routers are node ids (router i is node i+2)", matrixFile);
+  cmd.AddValue ("hostPool", "Address pool of the links of traffic matrix hosts (a.b.c.d/len)", hostPool);
+  cmd.AddValue ("ripCheckpoint", "Write the RIP tables of all routers to this file at checkpointAt, for a later --warmStart", checkpointFile);
+  cmd.AddValue ("checkpointAt", "Time of the RIP checkpoint, in seconds (after convergence, before the failure)", checkpointAt);
+  cmd.AddValue ("warmStart", "Preload the RIP tables from this checkpoint and move the failures, traffic, animation window and all later events earlier", warmStartFile);
+  cmd.AddValue ("warmFailureAt", "Time of the built-in failure in a warm-started run, in seconds", warmFailureAt);
+  cmd.AddValue ("headless", "Large-run mode: no mobility, node names, NetAnim or packet capture", headless);
+  cmd.AddValue ("anim", "NetAnim output: full, off, topology, window (animStart..animStop) or sampled", animMode);
+  cmd.AddValue ("animStart", "Start of the window mode, in seconds", animStart);
+  cmd.AddValue ("animStop", "End of the window mode, in seconds", animStop);
+  cmd.AddValue ("animSampleEvery", "Sampled mode animates one slot out of this many", animSampleEvery);
+  cmd.AddValue ("animSlot", "Length of a sampled mode slot, in seconds", animSlot);
   cmd.Parse (argc, argv);
 
+  // A warm start skips the initial convergence: the built-in failure and
+  // everything scheduled relative to it move earlier by the same amount.
+  Time failureAt = Seconds (warmStartFile.empty () ? 40.0 : warmFailureAt);
+  Time shift = Seconds (40.0) - failureAt;
+
+  PacketCapture capture (headless ? "none" : captureMode, captureNodes, captureProtocol, ringPackets);
+  capture.SetRingWindow (Seconds (ringWindow), Seconds (ringWindow));
+  AnimationMode animation (distributed || headless ? "off" : animMode);
+  animation.SetWindow (Max (Seconds (animStart) - shift, Seconds (0)), Max (Seconds (animStop) - shift, Seconds (0)));
+  animation.SetSampling (animSampleEvery, Seconds (animSlot));
+  BulkTraffic traffic (trafficMode, DataRate (udpRate), Seconds (trafficInterval));
+
+  NS_ABORT_MSG_UNLESS (linkType == "csma" || linkType == "p2p", "Unknown link type \"" << linkType << "\" (csma, p2p)");
+  bool pointToPoint = linkType == "p2p";
+  NS_ABORT_MSG_UNLESS (ripTable == "list" || ripTable == "trie", "Unknown RIP table \"" << ripTable << "\" (list, trie)");
+  NS_ABORT_MSG_IF (areaSize > 0 && topology != "chain", "--areaSize only plans the chain topology");
+  NS_ABORT_MSG_IF (summarize && areaSize == 0, "--summarize needs an area plan (--areaSize)");
+  NS_ABORT_MSG_IF (summarize && ripTable != "trie", "ns3::Rip cannot advertise summaries; --summarize needs --ripTable=trie");
+  NS_ABORT_MSG_IF (summarize && !oraclePrefix.empty (), "The RIP oracle expects every link in every table and does not work with --summarize");
+  NS_ABORT_MSG_IF (distributed && stopOnConvergence, "--stopOnConvergence needs a global view and does not work with --distributed");
+  NS_ABORT_MSG_IF (distributed && tableChanges, "--tableChanges needs a global view and does not work with --distributed");
+  NS_ABORT_MSG_IF (distributed && !checkpointFile.empty (), "Write the RIP checkpoint from a sequential run; --warmStart works with --distributed");
+  NS_ABORT_MSG_IF (distributed && !oraclePrefix.empty (), "The RIP oracle needs a global view and does not work with --distributed");
+  NS_ABORT_MSG_IF (distributed && traffic.IsEnabled (), "FlowMonitor needs both flow ends on one rank; --traffic does not work with --distributed");
+  NS_ABORT_MSG_IF (!matrixFile.empty () && !traffic.IsEnabled (), "--trafficMatrix needs --traffic=tcp, udp or both");
+
+  uint32_t systemId = 0;
+  uint32_t systemCount = 1;
+  if (distributed)
+    {
+#ifdef NS3_MPI
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+      systemId = MpiInterface::GetSystemId ();
+      systemCount = MpiInterface::GetSize ();
+      NS_ABORT_MSG_IF (uint32_t (routersAmount) < systemCount, "Need at least one router per MPI rank");
+#else
+      NS_FATAL_ERROR ("--distributed needs ns-3 configured with --enable-mpi");
+#endif
+    }
+
+  // After the simulator implementation is chosen, before the first event.
+  std::ostringstream progressPath;
+  if (!progressFile.empty ())
+    {
+      progressPath << progressFile;
+      if (distributed)
+        {
+          progressPath << ".rank" << systemId;
+        }
+    }
+  SimProgress progress (scheduler, progressPath.str (), Seconds (progressInterval));
+
+  SubnetAllocator chainSubnets = SubnetAllocator::FromString (chainPool, linkPrefix);
+  SubnetAllocator skipSubnets = SubnetAllocator::FromString (skipPool, linkPrefix);
+  NS_ABORT_MSG_IF (chainSubnets.Contains (skipSubnets.GetBase ()) || skipSubnets.Contains (chainSubnets.GetBase ()),
+                   "chainPool and skipPool overlap");
+  NS_ABORT_MSG_IF (chainSubnets.Contains (Ipv4Address ("10.6.0.0")) || chainSubnets.Contains (Ipv4Address ("10.7.0.0"))
+                   || skipSubnets.Contains (Ipv4Address ("10.6.0.0")) || skipSubnets.Contains (Ipv4Address ("10.7.0.0")),
+                   "Link pools must not cover the 10.6.0.0/24 and 10.7.0.0/24 host networks");
+  if (!matrixFile.empty ())
+    {
+      SubnetAllocator hostSubnets = SubnetAllocator::FromString (hostPool, 30);
+      NS_ABORT_MSG_IF (hostSubnets.Contains (chainSubnets.GetBase ()) || chainSubnets.Contains (hostSubnets.GetBase ())
+                       || hostSubnets.Contains (skipSubnets.GetBase ()) || skipSubnets.Contains (hostSubnets.GetBase ()),
+                       "hostPool overlaps chainPool or skipPool");
+      NS_ABORT_MSG_IF (hostSubnets.Contains (Ipv4Address ("10.6.0.0")) || hostSubnets.Contains (Ipv4Address ("10.7.0.0")),
+                       "hostPool must not cover the 10.6.0.0/24 and 10.7.0.0/24 host networks");
+    }
+  NS_ABORT_MSG_IF (topology == "chain" && areaSize == 0 && uint32_t (routersAmount) > chainSubnets.GetCapacity () + 1,
+                   "chainPool only has room for " << chainSubnets.GetCapacity () + 1 << " routers");
+
+  // Area a holds routers a*areaSize .. (a+1)*areaSize-1 and the chain and
+  // skip links that start there: areaSize chain links and, since skip links
+  // never overlap, at most half as many skip links.
+  AreaPlanner *areas = 0;
+  if (areaSize > 0)
+    {
+      areas = new AreaPlanner (AreaPlanner::FromString (chainPool, linkPrefix, (routersAmount + areaSize - 1) / areaSize,
+                                                        areaSize + (areaSize + 1) / 2));
+    }
+  // Links whose ends are in different areas, with their router indices.
+  std::vector<std::pair<NetDeviceContainer, TopologyGenerator::Edge> > crossingLinks;
+
+  std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now ();
+
   std::vector<int> hasConnectionVec;
   if (verbose)
     {
       LogComponentEnableAll (LogLevel (LOG_PREFIX_TIME | LOG_PREFIX_NODE));
       LogComponentEnable ("RipSimpleRouting", LOG_LEVEL_INFO);
       LogComponentEnable ("Rip", LOG_LEVEL_ALL);
+      LogComponentEnable ("RipTrie", LOG_LEVEL_ALL);
       LogComponentEnable ("Ipv4Interface", LOG_LEVEL_ALL);
       LogComponentEnable ("Icmpv4L4Protocol", LOG_LEVEL_ALL);
       LogComponentEnable ("Ipv4L3Protocol", LOG_LEVEL_ALL);
@@ -112,31 +303,66 @@ int main (int argc, char **argv)
 
   // Create source and destination nodes
   NS_LOG_INFO ("Create nodes.");
-  Ptr<Node> src = CreateObject<Node> ();
-  Names::Add ("SrcNode", src);
-  Ptr<Node> dst = CreateObject<Node> ();
-  Names::Add ("DstNode", dst);
+  Ptr<Node> src = CreateObject<Node> (0);
+  Ptr<Node> dst = CreateObject<Node> (systemCount - 1);
+  // Fault files and traffic matrices may name these two even when headless.
+  if (!headless || !faultFile.empty () || !matrixFile.empty ())
+    {
+      Names::Add ("SrcNode", src);
+      Names::Add ("DstNode", dst);
+    }
 
-  // Create routers
+  // Create routers, as contiguous segments of the chain when distributed.
+  // Every rank builds the whole topology; only RIP on local routers runs.
   NodeContainer routers;
-  routers.Create(routersAmount);
+  NodeContainer localRouters;
+  NodeContainer remoteRouters;
+  for (uint32_t rank = 0; rank < systemCount; rank++)
+    {
+      NodeContainer segment;
+      segment.Create ((uint64_t (rank + 1) * routersAmount) / systemCount - (uint64_t (rank) * routersAmount) / systemCount, rank);
+      routers.Add (segment);
+      (rank == systemId ? localRouters : remoteRouters).Add (segment);
+    }
 
   NodeContainer allNodes(src,dst);
   allNodes.Add(routers);
 
   NodeContainer nodesContainer(src,dst);
-  NodeContainer srcNodes(src,routers.Get(0));
-  NodeContainer dstNodes(routers.Get(routersAmount - 1),dst);
+
+  // Generated graphs are laid out before the stacks go in, since the
+  // host-facing interface of a router is numbered after all its links.
+  // src hangs off router 0 and dst off the router farthest from it.
+  TopologyGenerator *graph = 0;
+  uint32_t dstRouter = routersAmount - 1;
+  uint32_t srcDstHops = routersAmount - 1;
+  if (topology != "chain")
+    {
+      graph = new TopologyGenerator (topology, routersAmount, avgDegree, topologyStream);
+      dstRouter = graph->GetFarthest (0, srcDstHops);
+      NS_ABORT_MSG_IF (graph->GetEdges ().size () > uint64_t (chainSubnets.GetCapacity ()) + skipSubnets.GetCapacity (),
+                       "chainPool and skipPool only have room for " << uint64_t (chainSubnets.GetCapacity ()) + skipSubnets.GetCapacity ()
+                       << " links, the " << topology << " topology needs " << graph->GetEdges ().size ());
+    }
 
   // Begin : RIP routing settings
   NS_LOG_INFO ("Create IPv4 and routing");
-  RipHelper ripRouting;
+  RipTrieHelper ripRouting;
+  ripRouting.UseTrie (ripTable == "trie");
 
   // Rule of thumb:
   // Interfaces are added sequentially, starting from 0
   // However, interface 0 is always the loopback...
-  ripRouting.ExcludeInterface (allNodes.Get(2), 2);
-  ripRouting.ExcludeInterface (allNodes.Get(routersAmount + 1), 2);
+  if (graph == 0)
+    {
+      ripRouting.ExcludeInterface (allNodes.Get(2), 2);
+      ripRouting.ExcludeInterface (allNodes.Get(routersAmount + 1), 2);
+    }
+  else
+    {
+      ripRouting.ExcludeInterface (routers.Get (0), graph->GetDegree (0) + 1);
+      ripRouting.ExcludeInterface (routers.Get (dstRouter), graph->GetDegree (dstRouter) + 1);
+    }
 
   Ipv4ListRoutingHelper listRH;
   listRH.Add (ripRouting, 0);
@@ -144,35 +370,42 @@ int main (int argc, char **argv)
   InternetStackHelper internet;
   internet.SetIpv6StackInstall (false);
   internet.SetRoutingHelper (listRH);
-  internet.Install (routers);
+  internet.Install (localRouters);
 
   InternetStackHelper internetNodes;
   internetNodes.SetIpv6StackInstall (false);
   internetNodes.Install (src);
   internetNodes.Install(dst);
+  // Routers owned by other ranks only need interfaces, not a RIP that would
+  // send on their behalf.
+  internetNodes.Install (remoteRouters);
 
 
-  // set concrete static position
-  ListPositionAllocator routersPositionAllocator;
-  for(int i = 0;i<routersAmount;i++)
-  {
-	  Vector currentPos(50+i*10,i % 2 == 0 ? 30 : 50,0);
-	  routersPositionAllocator.Add(currentPos);
-  }
-  MobilityHelper routersMobility;
-  routersMobility.SetPositionAllocator(&routersPositionAllocator);
-  routersMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-  routersMobility.Install(routers);
-
-  ListPositionAllocator nodesPositionAllocator;
-  Vector srcPos(30, 40, 0);
-  Vector dstPos(60 + routersAmount * 10, 40, 0);
-  nodesPositionAllocator.Add(srcPos);
-  nodesPositionAllocator.Add(dstPos);
-  MobilityHelper nodesMobility;
-  nodesMobility.SetPositionAllocator(&nodesPositionAllocator);
-  nodesMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-  nodesMobility.Install(nodesContainer);
+  // set concrete static position; only NetAnim looks at it, so a headless
+  // run saves the mobility model and its position per node.
+  if (!headless)
+    {
+      ListPositionAllocator routersPositionAllocator;
+      for(int i = 0;i<routersAmount;i++)
+      {
+        Vector currentPos(50+i*10,i % 2 == 0 ? 30 : 50,0);
+        routersPositionAllocator.Add(currentPos);
+      }
+      MobilityHelper routersMobility;
+      routersMobility.SetPositionAllocator(&routersPositionAllocator);
+      routersMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+      routersMobility.Install(routers);
+
+      ListPositionAllocator nodesPositionAllocator;
+      Vector srcPos(30, 40, 0);
+      Vector dstPos(60 + routersAmount * 10, 40, 0);
+      nodesPositionAllocator.Add(srcPos);
+      nodesPositionAllocator.Add(dstPos);
+      MobilityHelper nodesMobility;
+      nodesMobility.SetPositionAllocator(&nodesPositionAllocator);
+      nodesMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+      nodesMobility.Install(nodesContainer);
+    }
 
   // Create channels
   NS_LOG_INFO ("Create channels.");
@@ -180,6 +413,12 @@ int main (int argc, char **argv)
   csma.SetChannelAttribute ("DataRate", DataRateValue (5000000));
   csma.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (2)));
 
+  // Used for the links that cross ranks, where its delay is the MPI
+  // lookahead, and for every link with --linkType=p2p.
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", DataRateValue (5000000));
+  p2p.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
   // Assign addresses and channels
   // The source and destination networks have global addresses
   // The "core" network just needs link-local addresses for routing.
@@ -188,56 +427,76 @@ int main (int argc, char **argv)
   NS_LOG_INFO ("Assign IPv4 Addresses.");
   Ipv4AddressHelper ipv4;
 
-  std::string currentAddr("10.0.");
-
-  for(int i = 0;i < routersAmount - 1;i++)
-  {
-	  NodeContainer currentRouters(routers.Get(i),routers.Get(i+1));
-	  NetDeviceContainer currentDevice = csma.Install(currentRouters);
-	  currentAddr += char('0' + i);
-	  currentAddr.append(".0");
-	  ipv4.SetBase(Ipv4Address(currentAddr.c_str()), Ipv4Mask("255.255.255.0"));
-	  Ipv4InterfaceContainer currentIIC = ipv4.Assign(currentDevice);
-
-	  currentAddr = "10.0.";
-  }
-  RngSeedManager::SetSeed(routersAmount); // Random Seed
-  double minRandom = 0.0;
-  double maxRandom = 10.0;
-  Ptr<UniformRandomVariable> uvRandom = CreateObject<UniformRandomVariable>();
-  uvRandom->SetAttribute("Min",DoubleValue(minRandom));
-  uvRandom->SetAttribute("Max",DoubleValue(maxRandom));
-
-  currentAddr = "10.168.";
-
-  for(int i=1;i < routersAmount - 3 ;)
-  {
-	  double r = uvRandom->GetValue();
-	  std::cout<<r<<"\n";
-	  if(r > 4.0) // Percent: 0.6
-	  {
-		  hasConnectionVec.push_back(i);
-
-		  NodeContainer pairRouters(routers.Get(i),routers.Get(i+2));
-		  NetDeviceContainer currentDevice = csma.Install(pairRouters);
-		  currentAddr += char('0' + i);
-		  currentAddr.append(".0");
-		  ipv4.SetBase(Ipv4Address(currentAddr.c_str()), Ipv4Mask("255.255.255.0"));
-		  Ipv4InterfaceContainer currentIIC = ipv4.Assign(currentDevice);
-
-		  std::cout<<"Node:"<<i+2<<" and "<<i+4<<" connected!"<<"\n";
-
-		  currentAddr = "10.168.";
-		  i = i+2;
-	  }
-	  else {
-		  i = i+1;
-		  continue;
-	  }
-  }
+  Ptr<UniformRandomVariable> uvRandom;
+  if (graph != 0)
+    {
+      const std::vector<TopologyGenerator::Edge> &edges = graph->GetEdges ();
+      for (size_t k = 0; k < edges.size (); k++)
+        {
+          NetDeviceContainer currentDevice = InstallLink (csma, p2p, pointToPoint, routers.Get (edges[k].first), routers.Get (edges[k].second));
+          (chainSubnets.GetAllocated () < chainSubnets.GetCapacity () ? chainSubnets : skipSubnets).AssignLink (currentDevice);
+        }
+    }
+  else
+    {
+      for(int i = 0;i < routersAmount - 1;i++)
+      {
+        NetDeviceContainer currentDevice = InstallLink(csma, p2p, pointToPoint, routers.Get(i), routers.Get(i+1));
+        if (areas != 0)
+          {
+            areas->AssignLink (i / areaSize, currentDevice);
+            if ((i + 1) / areaSize != i / areaSize)
+              {
+                crossingLinks.push_back (std::make_pair (currentDevice, TopologyGenerator::Edge (i, i + 1)));
+              }
+          }
+        else
+          {
+            chainSubnets.AssignLink(currentDevice);
+          }
+      }
+      RngSeedManager::SetSeed(routersAmount); // Random Seed
+      double minRandom = 0.0;
+      double maxRandom = 10.0;
+      uvRandom = CreateObject<UniformRandomVariable>();
+      uvRandom->SetAttribute("Min",DoubleValue(minRandom));
+      uvRandom->SetAttribute("Max",DoubleValue(maxRandom));
+
+      for(int i=1;i < routersAmount - 3 ;)
+      {
+        double r = uvRandom->GetValue();
+        std::cout<<r<<"\n";
+        if(r > 4.0) // Percent: 0.6
+        {
+          hasConnectionVec.push_back(i);
+
+          NetDeviceContainer currentDevice = InstallLink(csma, p2p, pointToPoint, routers.Get(i), routers.Get(i+2));
+          if (areas != 0)
+            {
+              areas->AssignLink (i / areaSize, currentDevice);
+              if ((i + 2) / areaSize != i / areaSize)
+                {
+                  crossingLinks.push_back (std::make_pair (currentDevice, TopologyGenerator::Edge (i, i + 2)));
+                }
+            }
+          else
+            {
+              skipSubnets.AssignLink(currentDevice);
+            }
+
+          std::cout<<"Node:"<<i+2<<" and "<<i+4<<" connected!"<<"\n";
+
+          i = i+2;
+        }
+        else {
+          i = i+1;
+          continue;
+        }
+      }
+    }
 
-  NetDeviceContainer srcConn = csma.Install(srcNodes);
-  NetDeviceContainer dstConn = csma.Install(dstNodes);
+  NetDeviceContainer srcConn = InstallLink(csma, p2p, pointToPoint, src, routers.Get(0));
+  NetDeviceContainer dstConn = InstallLink(csma, p2p, pointToPoint, routers.Get(dstRouter), dst);
 
   ipv4.SetBase(Ipv4Address("10.6.0.0"), Ipv4Mask("255.255.255.0"));
   Ipv4InterfaceContainer srcIIC = ipv4.Assign(srcConn);
@@ -245,22 +504,117 @@ int main (int argc, char **argv)
   ipv4.SetBase(Ipv4Address("10.7.0.0"), Ipv4Mask("255.255.255.0"));
   Ipv4InterfaceContainer dstIIC = ipv4.Assign(dstConn);
 
+  // Each end of a crossing link advertises its own area there in place of
+  // the area's links. Only local routers run RIP.
+  uint32_t nSummaries = 0;
+  if (summarize)
+    {
+      for (size_t k = 0; k < crossingLinks.size (); k++)
+        {
+          for (uint32_t end = 0; end < 2; end++)
+            {
+              uint32_t router = end == 0 ? crossingLinks[k].second.first : crossingLinks[k].second.second;
+              Ptr<NetDevice> device = crossingLinks[k].first.Get (end);
+              if (device->GetNode ()->GetSystemId () != systemId)
+                {
+                  continue;
+                }
+              Ptr<RipTrie> rip = DynamicCast<RipTrie> (RipTableWatcher::GetRip (device->GetNode ()));
+              NS_ABORT_MSG_IF (rip == 0, "Router " << router << " does not run RipTrie");
+              rip->AddSummary (device->GetNode ()->GetObject<Ipv4> ()->GetInterfaceForDevice (device),
+                               areas->GetAreaNetwork (router / areaSize), areas->GetAreaMask ());
+              nSummaries++;
+            }
+        }
+    }
+
+  uint32_t chainLinks = areas != 0 ? routersAmount - 1 : chainSubnets.GetAllocated ();
+  uint32_t skipLinks = areas != 0 ? hasConnectionVec.size () : skipSubnets.GetAllocated ();
+  double buildMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - buildStart).count ();
+  std::cout<<"INFO: Topology of "<<routersAmount<<" routers ("<<chainLinks<<" chain, "
+           <<skipLinks<<" skip links) built in "<<buildMs<<" ms, "
+           <<buildMs * 1000.0 / routersAmount<<" us/router\n";
+  if (areas != 0)
+    {
+      std::cout<<"INFO: "<<areas->GetNAreas ()<<" areas of "<<areaSize<<" routers, one /"<<areas->GetAreaPrefix ()
+               <<" each from "<<chainPool<<", "<<crossingLinks.size ()<<" links between areas, "
+               <<nSummaries<<" summaries advertised\n";
+    }
+  uint32_t diameter = 0;
+  if (graph != 0)
+    {
+      diameter = graph->EstimateDiameter ();
+      std::cout<<"INFO: "<<topology<<" graph with "<<graph->GetEdges ().size ()<<" links, diameter >= "<<diameter
+               <<", src router 0 and dst router "<<dstRouter<<" are "<<srcDstHops<<" hops apart\n";
+    }
+  if (buildOnly)
+    {
+      uint64_t rssKb = GetPeakRssKb ();
+      std::cout<<"INFO: Peak RSS after build "<<rssKb<<" kB, "<<rssKb * 1024.0 / routersAmount<<" bytes/router"
+               <<(headless ? " (headless)" : "")<<"\n";
+      Simulator::Destroy ();
+#ifdef NS3_MPI
+      MpiInterface::Disable ();
+#endif
+      return 0;
+    }
+
   Ptr<Ipv4StaticRouting> staticRouting;
   staticRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (src->GetObject<Ipv4> ()->GetRoutingProtocol ());
   staticRouting->SetDefaultRoute ("10.6.0.2", 1 );
   staticRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (dst->GetObject<Ipv4> ()->GetRoutingProtocol ());
   staticRouting->SetDefaultRoute ("10.7.0.1", 1 );
 
-  //TO-DO: modify table output
-  if (printRoutingTables)
+  // After the src and dst default routes, which the matrix keeps.
+  TrafficMatrix matrix;
+  if (!matrixFile.empty ())
+    {
+      std::chrono::steady_clock::time_point matrixStart = std::chrono::steady_clock::now ();
+      matrix.Load (matrixFile);
+      matrix.AttachHosts (csma, p2p, pointToPoint, hostPool);
+      std::cout<<"INFO: Traffic matrix hosts attached in "
+               <<std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - matrixStart).count ()<<" ms\n";
+    }
+
+  RipWarmStart warmStart;
+  if (!warmStartFile.empty ())
+    {
+      warmStart.Load (warmStartFile);
+      warmStart.Start ();
+    }
+  if (!checkpointFile.empty ())
+    {
+      Simulator::Schedule (Seconds (checkpointAt), &WriteRipSnapshot, localRouters, checkpointFile, compressSnapshots);
+    }
+
+  if (!snapshotPrefix.empty ())
+    {
+      std::ostringstream prefix;
+      prefix << snapshotPrefix;
+      if (distributed)
+        {
+          prefix << "-rank" << systemId;
+        }
+      ScheduleRipSnapshot (Seconds (40.0) - shift, localRouters, prefix.str (), compressSnapshots);
+      ScheduleRipSnapshot (Seconds (50.0) - shift, localRouters, prefix.str (), compressSnapshots);
+      ScheduleRipSnapshot (Seconds (90.0) - shift, localRouters, prefix.str (), compressSnapshots);
+    }
+  else if (printRoutingTables && routers.Get(3)->GetSystemId () == systemId)
     {
       RipHelper routingHelper;
 
       Ptr<OutputStreamWrapper> routingStream = Create<OutputStreamWrapper> (&std::cout);
 
-      routingHelper.PrintRoutingTableAt (Seconds (40.0), routers.Get(3), routingStream);
-      routingHelper.PrintRoutingTableAt (Seconds (50.0), routers.Get(3), routingStream);
-      routingHelper.PrintRoutingTableAt (Seconds (90.0), routers.Get(3), routingStream);
+      routingHelper.PrintRoutingTableAt (Seconds (40.0) - shift, routers.Get(3), routingStream);
+      routingHelper.PrintRoutingTableAt (Seconds (50.0) - shift, routers.Get(3), routingStream);
+      routingHelper.PrintRoutingTableAt (Seconds (90.0) - shift, routers.Get(3), routingStream);
+    }
+  RipOracle oracle (oracleThreads);
+  if (!oraclePrefix.empty ())
+    {
+      oracle.Schedule (Seconds (40.0) - shift, routers, oraclePrefix);
+      oracle.Schedule (Seconds (50.0) - shift, routers, oraclePrefix);
+      oracle.Schedule (Seconds (90.0) - shift, routers, oraclePrefix);
     }
 
   NS_LOG_INFO ("Create Applications.");
@@ -275,38 +629,304 @@ int main (int argc, char **argv)
 //  pingWifi.SetAttribute ("Interval", TimeValue (interPacketInterval));
 //  pingWifi.SetAttribute ("Size", UintegerValue (packetSize));
 
-  if (showPings)
+  if (showPings && pingStatsPrefix.empty ())
   {
     ping.SetAttribute ("Verbose", BooleanValue (true));
 //      pingWifi.SetAttribute("Verbose", BooleanValue (true));
   }
-  ApplicationContainer apps = ping.Install (src);
+  if (src->GetSystemId () == systemId)
+    {
+      ApplicationContainer apps = ping.Install (src);
+      apps.Start (Seconds (2.0));
+      apps.Stop (Seconds (800.0) - shift);
+    }
 //  ApplicationContainer wifiApps = pingWifi.Install(a);
 
-  apps.Start (Seconds (2.0));
-  apps.Stop (Seconds (800.0));
+  TrafficCounters counters;
+  if (!resultFile.empty ())
+    {
+      counters.Connect (localRouters, src);
+    }
+
+  if (traffic.IsEnabled ())
+    {
+      Time start = Max (Seconds (trafficStart) - shift, Seconds (0));
+      Time stop = Max (Seconds (trafficStop) - shift, Seconds (0));
+      traffic.AddFlows (src, dst, start, stop);
+      std::chrono::steady_clock::time_point flowStart = std::chrono::steady_clock::now ();
+      matrix.AddFlows (traffic, start, stop);
+      traffic.Start ();
+      if (!matrixFile.empty ())
+        {
+          std::cout<<"INFO: Traffic matrix flows set up in "
+                   <<std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - flowStart).count ()<<" ms\n";
+        }
+    }
 
 //  wifiApps.Start (Seconds (2.0));
 //  wifiApps.Stop (Seconds (150.0));
 
-  AsciiTraceHelper ascii;
-  csma.EnableAsciiAll (ascii.CreateFileStream ("rip-poi-B-project.tr"));
-  csma.EnablePcapAll ("rip-poi-B-project", true);
+  // Without a schedule file, each skip link fails at 40s with a 50% chance
+  // (at least one does), drawn from the same stream that placed them.
+  FaultSchedule faults;
+  if (!faultFile.empty ())
+    {
+      faults.Load (faultFile, shift);
+    }
+  else if (graph != 0)
+    {
+      // Cut the src-dst path somewhere RIP can route around.
+      size_t edge = graph->FindDetourEdge (0, dstRouter);
+      NS_ABORT_MSG_IF (edge == graph->GetEdges ().size (),
+                       "No link on the src-dst path of the " << topology << " topology can fail without cutting dst off"
+                       " (ba with avgDegree below 3 is a tree); raise avgDegree or give a faultFile");
+      const TopologyGenerator::Edge &e = graph->GetEdges ()[edge];
+      faults.AddLinkDown (failureAt, routers.Get (e.first), routers.Get (e.second));
+      std::cout<<"INFO: Connection between "<< e.first+2 <<" "<< e.second+2 <<" will be torn down at "<<failureAt.GetSeconds ()<<"s\n";
+    }
+  else
+    {
+      for (size_t k = 0; k < hasConnectionVec.size (); k++)
+        {
+          int x = hasConnectionVec[k];
+          if (uvRandom->GetValue () > 5)
+            {
+              faults.AddLinkDown (failureAt, routers.Get (x), routers.Get (x + 2));
+              std::cout<<"INFO: Connection between "<< x+2 <<" "<< x+4 <<" will be torn down at "<<failureAt.GetSeconds ()<<"s\n";
+            }
+        }
+      if (faults.GetNEvents () == 0 && !hasConnectionVec.empty ())
+        {
+          int x = hasConnectionVec[0];
+          faults.AddLinkDown (failureAt, routers.Get (x), routers.Get (x + 2));
+        }
+    }
+  std::vector<Time> faultTimes = faults.GetTimes ();
+  faults.Start ();
 
-  Simulator::Schedule(Seconds(40),&removeConnRandomly,routersAmount,hasConnectionVec,routers);
+  // The result file reports the ping quantiles and outages too.
+  PingStats pingStats;
+  if (src->GetSystemId () == systemId && (!pingStatsPrefix.empty () || !resultFile.empty ()))
+    {
+      pingStats.Connect (src);
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          pingStats.NotifyFailureAt (faultTimes[i]);
+        }
+    }
+
+  // Every rank holds every device, so per-device traces would be written
+  // once per rank; keep them for sequential runs only.
+  AsyncTraceWriter *traceWriter = 0;
+  if (!distributed && capture.GetMode () == PacketCapture::ALL && asyncTraces)
+    {
+      traceWriter = new AsyncTraceWriter;
+      Ptr<OutputStreamWrapper> stream = traceWriter->CreateFileStream ("rip-poi-B-project.tr");
+      csma.EnableAsciiAll (stream);
+      p2p.EnableAsciiAll (stream);
+      traceWriter->EnablePcap (allNodes, "rip-poi-B-project", true);
+    }
+  else if (!distributed && capture.GetMode () == PacketCapture::ALL)
+    {
+      AsciiTraceHelper ascii;
+      Ptr<OutputStreamWrapper> stream = ascii.CreateFileStream ("rip-poi-B-project.tr");
+      csma.EnableAsciiAll (stream);
+      p2p.EnableAsciiAll (stream);
+      csma.EnablePcapAll ("rip-poi-B-project", true);
+      p2p.EnablePcapAll ("rip-poi-B-project", true);
+    }
+  else if (!distributed)
+    {
+      capture.Install (allNodes, "rip-poi-B-project");
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          capture.NotifyFailureAt (faultTimes[i]);
+        }
+    }
+
+  // The watcher re-reads a table whenever it may have changed, so it only
+  // runs when something asks for table changes.
+  RipTableWatcher ripWatcher;
+  RipConvergenceDetector *convergence = 0;
+  if (stopOnConvergence || tableChanges)
+    {
+      ripWatcher.Watch (localRouters);
+      convergence = new RipConvergenceDetector (ripWatcher, Seconds (quietPeriod), stopOnConvergence);
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          convergence->NotifyFailureAt (faultTimes[i]);
+        }
+    }
+  RipJournal *journal = 0;
+  if (!journalFile.empty ())
+    {
+      std::ostringstream path;
+      path << journalFile;
+      if (distributed)
+        {
+          path << ".rank" << systemId;
+        }
+      ripWatcher.Watch (localRouters);
+      journal = new RipJournal (ripWatcher, path.str ());
+    }
+  if (convergence != 0 || journal != 0)
+    {
+      faults.AddLinkChangedCallback (MakeCallback (&RipTableWatcher::MarkDirty, &ripWatcher));
+    }
+  // Also feeds the per-kind RIP totals of the result file, when given.
+  RipOverhead overhead (Seconds (overheadBucket));
+  if (!overheadFile.empty ())
+    {
+      overhead.Connect (localRouters);
+      for (size_t i = 0; i < faultTimes.size (); i++)
+        {
+          overhead.NotifyFailureAt (faultTimes[i]);
+        }
+    }
 
   /* Now, do the actual simulation. */
   NS_LOG_INFO ("Run Simulation.");
-  Simulator::Stop (Seconds (800.0));
+  Simulator::Stop (Seconds (800.0) - shift);
 
-  AnimationInterface anim ("xmls/poi-B-project.xml");
-  anim.UpdateNodeDescription(src,"source");
-  anim.UpdateNodeDescription(dst,"destination");
+  AnimationInterface *anim = animation.Create ("xmls/poi-B-project.xml");
+  if (anim != 0)
+    {
+      anim->UpdateNodeDescription(src,"source");
+      anim->UpdateNodeDescription(dst,"destination");
 
-  anim.UpdateNodeColor(src,10,240,10);
-  anim.UpdateNodeColor(dst,10,10,240);
+      anim->UpdateNodeColor(src,10,240,10);
+      anim->UpdateNodeColor(dst,10,10,240);
+    }
 
+  progress.Start (Seconds (800.0) - shift);
+  std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now ();
   Simulator::Run ();
+  double runSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - runStart).count ();
+  if (systemId == 0)
+    {
+      // Benchmarks read this line, so that they need no result file.
+      std::cout<<"INFO: "<<Simulator::GetEventCount ()<<" events in "<<runSeconds<<" s, "
+               <<(runSeconds > 0 ? Simulator::GetEventCount () / runSeconds : 0.0)<<" events/s, peak RSS "
+               <<GetPeakRssKb ()<<" kB\n";
+    }
+
+#ifdef NS3_MPI
+  if (distributed)
+    {
+      // RIP packets are counted on the rank that sends them.
+      uint64_t local[2] = { counters.ripPackets, counters.ripBytes };
+      uint64_t total[2];
+      MPI_Allreduce (local, total, 2, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+      counters.ripPackets = total[0];
+      counters.ripBytes = total[1];
+    }
+#endif
+
+  if (!resultFile.empty () && systemId == 0)
+    {
+      RunResult result;
+      result.Set ("amount", routersAmount);
+      result.Set ("splitHorizonStrategy", SplitHorizon);
+      result.Set ("RngRun", RngSeedManager::GetRun ());
+      result.Set ("skipLinks", skipLinks);
+      result.Set ("topology", topology);
+      result.Set ("topologyStream", topologyStream);
+      result.Set ("linkType", linkType);
+      result.Set ("ripTable", ripTable);
+      result.Set ("scheduler", scheduler);
+      result.Set ("areaSize", areaSize);
+      result.Set ("summarize", summarize);
+      result.Set ("srcDstHops", srcDstHops);
+      if (graph != 0)
+        {
+          result.Set ("links", graph->GetEdges ().size ());
+          result.Set ("diameter", diameter);
+        }
+      result.Set ("simulatedSeconds", Simulator::Now ().GetSeconds ());
+      result.Set ("buildMs", buildMs);
+      result.Set ("runSeconds", runSeconds);
+      result.Set ("events", Simulator::GetEventCount ());
+      result.Set ("eventsPerSecond", runSeconds > 0 ? Simulator::GetEventCount () / runSeconds : 0.0);
+      result.Set ("peakRssKb", GetPeakRssKb ());
+      result.Set ("totalSeconds", std::chrono::duration<double> (std::chrono::steady_clock::now () - processStart).count ());
+      result.Set ("ranks", systemCount);
+      result.Set ("headless", headless);
+      result.Set ("warmStart", !warmStartFile.empty ());
+      result.Set ("warmRoutes", warmStart.GetNRoutes ());
+      result.Set ("faultEvents", faults.GetNApplied ());
+      if (convergence != 0)
+        {
+          result.Set ("converged", convergence->HasConverged ());
+          result.Set ("convergenceSeconds", convergence->GetConvergenceTime ().GetSeconds ());
+          result.Set ("tableChanges", ripWatcher.GetNChanges ());
+        }
+      counters.Export (result);
+      uint32_t nRipRouters = 0;
+      size_t nRipRoutes = TakeRipSnapshot (localRouters, nRipRouters).GetNRoutes ();
+      result.Set ("ripRoutes", nRipRoutes);
+      result.Set ("ripRoutesPerRouter", nRipRouters > 0 ? double (nRipRoutes) / nRipRouters : 0.0);
+      if (!overheadFile.empty () && !distributed)
+        {
+          RipOverhead::Counters tx = overhead.GetTotal (RipOverhead::TX);
+          RipOverhead::Counters txAfter = overhead.GetTotal (RipOverhead::TX, true);
+          result.Set ("ripRequests", tx.messages[RipOverhead::REQUEST]);
+          result.Set ("ripReplies", tx.messages[RipOverhead::REPLY]);
+          result.Set ("ripPeriodic", tx.messages[RipOverhead::PERIODIC]);
+          result.Set ("ripTriggered", tx.messages[RipOverhead::TRIGGERED]);
+          result.Set ("ripRtes", tx.rtes);
+          result.Set ("ripPoisoned", tx.poisoned);
+          result.Set ("ripBytesAfterFailure", txAfter.bytes);
+          result.Set ("ripTriggeredAfterFailure", txAfter.messages[RipOverhead::TRIGGERED]);
+        }
+      if (!oraclePrefix.empty ())
+        {
+          const RipOracle::Report &check = oracle.GetLastReport ();
+          result.Set ("oracleRoutes", check.routes);
+          result.Set ("oracleErrors", check.GetNErrors ());
+          result.Set ("oracleMissing", check.missing);
+          result.Set ("oracleStale", check.stale);
+        }
+      result.Set ("pingRttP50Ms", pingStats.GetRttQuantile (0.5).GetSeconds () * 1000.0);
+      result.Set ("pingRttP99Ms", pingStats.GetRttQuantile (0.99).GetSeconds () * 1000.0);
+      result.Set ("pingOutages", pingStats.GetNOutages ());
+      result.Set ("longestOutageSeconds", pingStats.GetLongestOutage ().GetSeconds ());
+      if (traffic.IsEnabled ())
+        {
+          result.Set ("traffic", trafficMode);
+          result.Set ("goodputMbps", traffic.GetGoodputMbps ());
+          result.Set ("matrixHosts", matrix.GetHosts ().GetN ());
+          result.Set ("matrixFlows", matrix.GetNFlows ());
+        }
+      result.Write (resultFile);
+    }
+
+  if (!pingStatsPrefix.empty () && src->GetSystemId () == systemId)
+    {
+      pingStats.Write (pingStatsPrefix);
+    }
+  if (traffic.IsEnabled ())
+    {
+      traffic.Write (trafficPrefix);
+    }
+  if (!overheadFile.empty ())
+    {
+      std::ostringstream path;
+      path << overheadFile;
+      if (distributed)
+        {
+          path << ".rank" << systemId;
+        }
+      overhead.Write (path.str ());
+    }
   Simulator::Destroy ();
+  animation.Finish ();
+  delete traceWriter;
+  delete convergence;
+  delete journal;
+  delete graph;
+  delete areas;
+#ifdef NS3_MPI
+  MpiInterface::Disable ();
+#endif
   NS_LOG_INFO ("Done.");
 }
@@ -0,0 +1,127 @@
+#include "rip-trie-helper.h"
+#include "rip-trie.h"
+
+namespace ns3 {
+
+RipTrieHelper::RipTrieHelper ()
+  : m_trie (true)
+{
+  m_factory.SetTypeId (RipTrie::GetTypeId ());
+}
+
+RipTrieHelper::RipTrieHelper (const RipTrieHelper &o)
+  : m_trie (o.m_trie),
+    m_factory (o.m_factory),
+    m_interfaceExclusions (o.m_interfaceExclusions),
+    m_interfaceMetrics (o.m_interfaceMetrics)
+{
+}
+
+RipTrieHelper::~RipTrieHelper ()
+{
+}
+
+RipTrieHelper *
+RipTrieHelper::Copy (void) const
+{
+  return new RipTrieHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+RipTrieHelper::Create (Ptr<Node> node) const
+{
+  Ptr<Rip> rip = m_factory.Create<Rip> ();
+  std::map<Ptr<Node>, std::set<uint32_t> >::const_iterator it = m_interfaceExclusions.find (node);
+  if (it != m_interfaceExclusions.end ())
+    {
+      Ptr<RipTrie> trie = DynamicCast<RipTrie> (rip);
+      if (trie != 0)
+        {
+          trie->SetInterfaceExclusions (it->second);
+        }
+      else
+        {
+          rip->SetInterfaceExclusions (it->second);
+        }
+    }
+  std::map<Ptr<Node>, std::map<uint32_t, uint8_t> >::const_iterator iter = m_interfaceMetrics.find (node);
+  if (iter != m_interfaceMetrics.end ())
+    {
+      for (std::map<uint32_t, uint8_t>::const_iterator subiter = iter->second.begin (); subiter != iter->second.end (); subiter++)
+        {
+          rip->SetInterfaceMetric (subiter->first, subiter->second);
+        }
+    }
+  node->AggregateObject (rip);
+  return rip;
+}
+
+void
+RipTrieHelper::UseTrie (bool trie)
+{
+  m_trie = trie;
+  m_factory.SetTypeId (trie ? RipTrie::GetTypeId () : Rip::GetTypeId ());
+}
+
+bool
+RipTrieHelper::IsTrie (void) const
+{
+  return m_trie;
+}
+
+void
+RipTrieHelper::Set (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+int64_t
+RipTrieHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (ipv4, "Ipv4 not installed on node");
+      Ptr<Rip> rip = Ipv4RoutingHelper::GetRouting<Rip> (ipv4->GetRoutingProtocol ());
+      if (rip == 0)
+        {
+          continue;
+        }
+      Ptr<RipTrie> trie = DynamicCast<RipTrie> (rip);
+      currentStream += trie != 0 ? trie->AssignStreams (currentStream) : rip->AssignStreams (currentStream);
+    }
+  return currentStream - stream;
+}
+
+void
+RipTrieHelper::SetDefaultRouter (Ptr<Node> node, Ipv4Address nextHop, uint32_t interface)
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, "Ipv4 not installed on node");
+  Ptr<Rip> rip = Ipv4RoutingHelper::GetRouting<Rip> (ipv4->GetRoutingProtocol ());
+  NS_ABORT_MSG_IF (rip == 0, "RipTrieHelper: node " << node->GetId () << " does not run RIP");
+  Ptr<RipTrie> trie = DynamicCast<RipTrie> (rip);
+  if (trie != 0)
+    {
+      trie->AddDefaultRouteTo (nextHop, interface);
+    }
+  else
+    {
+      rip->AddDefaultRouteTo (nextHop, interface);
+    }
+}
+
+void
+RipTrieHelper::ExcludeInterface (Ptr<Node> node, uint32_t interface)
+{
+  m_interfaceExclusions[node].insert (interface);
+}
+
+void
+RipTrieHelper::SetInterfaceMetric (Ptr<Node> node, uint32_t interface, uint8_t metric)
+{
+  m_interfaceMetrics[node][interface] = metric;
+}
+
+} // namespace ns3
@@ -0,0 +1,54 @@
+#ifndef RIP_TRIE_HELPER_H
+#define RIP_TRIE_HELPER_H
+
+#include <map>
+#include <set>
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Routing helper that installs RipTrie, or ns3::Rip.
+ *
+ * Takes the place of RipHelper in an Ipv4ListRoutingHelper: interface
+ * exclusions, interface metrics and attributes are set the same way. With
+ * UseTrie (false) it installs the stock ns3::Rip, so a program can choose
+ * the table at run time and otherwise configure one helper.
+ *
+ * It is no RipHelper: RipHelper::AssignStreams and SetDefaultRouter call
+ * Rip's non-virtual methods, which on a RipTrie reach the idle base class.
+ * Its own versions call RipTrie's.
+ */
+class RipTrieHelper : public Ipv4RoutingHelper
+{
+public:
+  RipTrieHelper ();
+  RipTrieHelper (const RipTrieHelper &o);
+  virtual ~RipTrieHelper ();
+
+  virtual RipTrieHelper *Copy (void) const;
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /// Install RipTrie (the default) or ns3::Rip.
+  void UseTrie (bool trie);
+  bool IsTrie (void) const;
+
+  // As in RipHelper.
+  void Set (std::string name, const AttributeValue &value);
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+  void SetDefaultRouter (Ptr<Node> node, Ipv4Address nextHop, uint32_t interface);
+  void ExcludeInterface (Ptr<Node> node, uint32_t interface);
+  void SetInterfaceMetric (Ptr<Node> node, uint32_t interface, uint8_t metric);
+
+private:
+  RipTrieHelper &operator = (const RipTrieHelper &);
+
+  bool m_trie;
+  ObjectFactory m_factory;
+  std::map<Ptr<Node>, std::set<uint32_t> > m_interfaceExclusions;
+  std::map<Ptr<Node>, std::map<uint32_t, uint8_t> > m_interfaceMetrics;
+};
+
+} // namespace ns3
+
+#endif /* RIP_TRIE_HELPER_H */
@@ -0,0 +1,981 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "rip-trie.h"
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/loopback-net-device.h"
+#include "ns3/ipv4-packet-info-tag.h"
+#include "ns3/udp-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RipTrie");
+
+NS_OBJECT_ENSURE_REGISTERED (RipTrie);
+
+static const uint16_t RIP_PORT = 520;
+static const char *RIP_ALL_NODE = "224.0.0.9";
+
+TypeId
+RipTrie::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RipTrie")
+    .SetParent<Rip> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<RipTrie> ()
+    .AddTraceSource ("TableChanged",
+                     "A route was added to, changed in or withdrawn from the table",
+                     MakeTraceSourceAccessor (&RipTrie::m_tableChangedTrace),
+                     "ns3::RipTrie::TableChangedCallback")
+  ;
+  return tid;
+}
+
+RipTrie::RipTrie ()
+  : m_initialized (false),
+    m_nodeId (0),
+    m_splitHorizonStrategy (Rip::POISON_REVERSE),
+    m_linkDown (16)
+{
+  m_rng = CreateObject<UniformRandomVariable> ();
+}
+
+RipTrie::~RipTrie ()
+{
+}
+
+void
+RipTrie::LoadAttributes (void)
+{
+  TimeValue time;
+  GetAttribute ("UnsolicitedRoutingUpdate", time);
+  m_unsolicitedUpdate = time.Get ();
+  GetAttribute ("StartupDelay", time);
+  m_startupDelay = time.Get ();
+  GetAttribute ("TimeoutDelay", time);
+  m_timeoutDelay = time.Get ();
+  GetAttribute ("GarbageCollectionDelay", time);
+  m_garbageCollectionDelay = time.Get ();
+  GetAttribute ("MinTriggeredCooldown", time);
+  m_minTriggeredUpdateDelay = time.Get ();
+  GetAttribute ("MaxTriggeredCooldown", time);
+  m_maxTriggeredUpdateDelay = time.Get ();
+  EnumValue splitHorizon;
+  GetAttribute ("SplitHorizon", splitHorizon);
+  m_splitHorizonStrategy = splitHorizon.Get ();
+  UintegerValue linkDown;
+  GetAttribute ("LinkDownValue", linkDown);
+  m_linkDown = linkDown.Get ();
+  m_exclusions = GetInterfaceExclusions ();
+}
+
+int64_t
+RipTrie::AssignStreams (int64_t stream)
+{
+  m_rng->SetStream (stream);
+  return 1;
+}
+
+uint32_t
+RipTrie::GetNRoutes (void) const
+{
+  return m_trie.GetSize ();
+}
+
+void
+RipTrie::SetInterfaceExclusions (std::set<uint32_t> exceptions)
+{
+  Rip::SetInterfaceExclusions (exceptions);
+  m_exclusions.swap (exceptions);
+}
+
+bool
+RipTrie::IsExcluded (uint32_t interface) const
+{
+  return m_exclusions.find (interface) != m_exclusions.end ();
+}
+
+void
+RipTrie::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  LoadAttributes ();
+  m_initialized = true;
+
+  Time delay = m_unsolicitedUpdate + Seconds (m_rng->GetValue (0, 0.5 * m_unsolicitedUpdate.GetSeconds ()));
+  m_nextUnsolicitedUpdate = Simulator::Schedule (delay, &RipTrie::SendUnsolicitedRouteUpdate, this);
+
+  for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
+    {
+      if (DynamicCast<LoopbackNetDevice> (m_ipv4->GetNetDevice (i)) == 0)
+        {
+          OpenSockets (i);
+        }
+    }
+
+  delay = Seconds (m_rng->GetValue (0.01, m_startupDelay.GetSeconds ()));
+  m_nextTriggeredUpdate = Simulator::Schedule (delay, &RipTrie::SendRouteRequest, this);
+
+  // Not Rip::DoInitialize: the base class would start a second, empty RIP.
+  Ipv4RoutingProtocol::DoInitialize ();
+}
+
+void
+RipTrie::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (size_t slot = 0; slot < m_routes.size (); slot++)
+    {
+      m_routes[slot].timer.Cancel ();
+    }
+  m_routes.clear ();
+  m_freeSlots.clear ();
+  m_trie.Clear ();
+  m_summaries.clear ();
+  m_summariesOn.clear ();
+  m_ownSummaries.Clear ();
+  m_nextTriggeredUpdate.Cancel ();
+  m_nextUnsolicitedUpdate.Cancel ();
+  for (SocketList::iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+    {
+      iter->first->Close ();
+    }
+  m_unicastSocketList.clear ();
+  if (m_multicastRecvSocket)
+    {
+      m_multicastRecvSocket->Close ();
+      m_multicastRecvSocket = 0;
+    }
+  m_ipv4 = 0;
+  // Not Rip::DoDispose: the base class never started and owns nothing.
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+RipTrie::OpenSockets (uint32_t interface)
+{
+  for (SocketList::const_iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+    {
+      if (iter->second == interface)
+        {
+          return;
+        }
+    }
+  if (!IsExcluded (interface))
+    {
+      m_ipv4->SetForwarding (interface, true);
+      for (uint32_t j = 0; j < m_ipv4->GetNAddresses (interface); j++)
+        {
+          Ipv4InterfaceAddress address = m_ipv4->GetAddress (interface, j);
+          if (address.GetScope () == Ipv4InterfaceAddress::HOST)
+            {
+              continue;
+            }
+          Ptr<Socket> socket = Socket::CreateSocket (GetObject<Node> (), UdpSocketFactory::GetTypeId ());
+          socket->BindToNetDevice (m_ipv4->GetNetDevice (interface));
+          int ret = socket->Bind (InetSocketAddress (address.GetLocal (), RIP_PORT));
+          NS_ASSERT_MSG (ret == 0, "Bind unsuccessful");
+          socket->SetRecvCallback (MakeCallback (&RipTrie::Receive, this));
+          socket->SetIpRecvTtl (true);
+          socket->SetRecvPktInfo (true);
+          m_unicastSocketList[socket] = interface;
+        }
+    }
+  if (!m_multicastRecvSocket)
+    {
+      m_multicastRecvSocket = Socket::CreateSocket (GetObject<Node> (), UdpSocketFactory::GetTypeId ());
+      m_multicastRecvSocket->Bind (InetSocketAddress (Ipv4Address (RIP_ALL_NODE), RIP_PORT));
+      m_multicastRecvSocket->SetRecvCallback (MakeCallback (&RipTrie::Receive, this));
+      m_multicastRecvSocket->SetIpRecvTtl (true);
+      m_multicastRecvSocket->SetRecvPktInfo (true);
+    }
+}
+
+void
+RipTrie::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+  LoadAttributes ();
+  m_ipv4 = ipv4;
+  m_nodeId = m_ipv4->GetObject<Node> ()->GetId ();
+  for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
+    {
+      if (m_ipv4->IsUp (i))
+        {
+          NotifyInterfaceUp (i);
+        }
+      else
+        {
+          NotifyInterfaceDown (i);
+        }
+    }
+}
+
+void
+RipTrie::NotifyInterfaceUp (uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << interface);
+  for (uint32_t j = 0; j < m_ipv4->GetNAddresses (interface); j++)
+    {
+      Ipv4InterfaceAddress address = m_ipv4->GetAddress (interface, j);
+      if (address.GetScope () == Ipv4InterfaceAddress::GLOBAL)
+        {
+          AddNetworkRouteTo (address.GetLocal ().CombineMask (address.GetMask ()), address.GetMask (), interface);
+        }
+    }
+  if (m_initialized)
+    {
+      OpenSockets (interface);
+    }
+}
+
+void
+RipTrie::NotifyInterfaceDown (uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << interface);
+  for (size_t slot = 0; slot < m_routes.size (); slot++)
+    {
+      if (m_routes[slot].used && m_routes[slot].interface == interface)
+        {
+          InvalidateRoute (slot);
+        }
+    }
+  for (SocketList::iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+    {
+      if (iter->second == interface)
+        {
+          iter->first->Close ();
+          m_unicastSocketList.erase (iter);
+          break;
+        }
+    }
+  if (m_initialized && !IsExcluded (interface))
+    {
+      SendTriggeredRouteUpdate ();
+    }
+}
+
+void
+RipTrie::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+  if (!m_ipv4->IsUp (interface) || IsExcluded (interface))
+    {
+      return;
+    }
+  if (address.GetScope () == Ipv4InterfaceAddress::GLOBAL)
+    {
+      AddNetworkRouteTo (address.GetLocal ().CombineMask (address.GetMask ()), address.GetMask (), interface);
+    }
+  if (m_initialized)
+    {
+      SendTriggeredRouteUpdate ();
+    }
+}
+
+void
+RipTrie::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+  if (!m_ipv4->IsUp (interface) || address.GetScope () != Ipv4InterfaceAddress::GLOBAL)
+    {
+      return;
+    }
+  Ipv4Mask mask = address.GetMask ();
+  uint32_t slot = m_trie.Find (address.GetLocal ().CombineMask (mask).Get (), mask.GetPrefixLength ());
+  if (slot != PrefixTrie::NONE && m_routes[slot].interface == interface && m_routes[slot].gateway.IsAny ())
+    {
+      InvalidateRoute (slot);
+    }
+  if (m_initialized && !IsExcluded (interface))
+    {
+      SendTriggeredRouteUpdate ();
+    }
+}
+
+uint32_t
+RipTrie::AddRoute (Ipv4Address network, Ipv4Mask mask, Ipv4Address gateway, uint32_t interface)
+{
+  uint32_t slot;
+  if (m_freeSlots.empty ())
+    {
+      slot = m_routes.size ();
+      m_routes.push_back (Route ());
+    }
+  else
+    {
+      slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+    }
+  Route &route = m_routes[slot];
+  route.network = network;
+  route.mask = mask;
+  route.gateway = gateway;
+  route.interface = interface;
+  route.metric = 1;
+  route.tag = 0;
+  route.valid = true;
+  route.changed = true;
+  route.used = true;
+  route.timer = EventId ();
+  m_trie.Insert (network.Get (), mask.GetPrefixLength (), slot);
+  NotifyTableChanged ();
+  return slot;
+}
+
+void
+RipTrie::AddNetworkRouteTo (Ipv4Address network, Ipv4Mask mask, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << network << mask << interface);
+  // ns3::Rip would add a second entry for the prefix; a connected network
+  // replaces whatever was learned for it instead.
+  uint32_t slot = m_trie.Find (network.Get (), mask.GetPrefixLength ());
+  if (slot != PrefixTrie::NONE)
+    {
+      DeleteRoute (slot);
+    }
+  AddRoute (network, mask, Ipv4Address::GetAny (), interface);
+}
+
+void
+RipTrie::AddDefaultRouteTo (Ipv4Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << nextHop << interface);
+  uint32_t slot = m_trie.Find (0, 0);
+  if (slot != PrefixTrie::NONE)
+    {
+      DeleteRoute (slot);
+    }
+  slot = AddRoute (Ipv4Address::GetAny (), Ipv4Mask::GetZero (), nextHop, interface);
+  m_routes[slot].metric = 0;
+}
+
+void
+RipTrie::InvalidateRoute (uint32_t slot)
+{
+  Route &route = m_routes[slot];
+  NS_LOG_FUNCTION (this << route.network << route.mask);
+  route.valid = false;
+  route.metric = m_linkDown;
+  route.changed = true;
+  route.timer.Cancel ();
+  route.timer = Simulator::Schedule (m_garbageCollectionDelay, &RipTrie::DeleteRoute, this, slot);
+  NotifyTableChanged ();
+}
+
+void
+RipTrie::DeleteRoute (uint32_t slot)
+{
+  Route &route = m_routes[slot];
+  NS_LOG_FUNCTION (this << route.network << route.mask);
+  route.timer.Cancel ();
+  m_trie.Remove (route.network.Get (), route.mask.GetPrefixLength ());
+  route.used = false;
+  m_freeSlots.push_back (slot);
+}
+
+void
+RipTrie::NotifyTableChanged (void)
+{
+  m_tableChangedTrace (m_nodeId);
+}
+
+void
+RipTrie::RefreshTimeout (uint32_t slot)
+{
+  Route &route = m_routes[slot];
+  route.timer.Cancel ();
+  route.timer = Simulator::Schedule (m_timeoutDelay, &RipTrie::InvalidateRoute, this, slot);
+}
+
+Ptr<Ipv4Route>
+RipTrie::Lookup (Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
+{
+  if (dst.IsLocalMulticast ())
+    {
+      NS_ASSERT_MSG (interface, "Try to send on local multicast address, and no interface index is given!");
+      Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+      rtentry->SetSource (m_ipv4->SourceAddressSelection (m_ipv4->GetInterfaceForDevice (interface), dst));
+      rtentry->SetDestination (dst);
+      rtentry->SetGateway (Ipv4Address::GetZero ());
+      rtentry->SetOutputDevice (interface);
+      return rtentry;
+    }
+
+  // Longest valid prefix, leaving the route on the given device if any.
+  int32_t oif = interface ? m_ipv4->GetInterfaceForDevice (interface) : -1;
+  const std::vector<Route> &routes = m_routes;
+  uint32_t slot = m_trie.Lookup (dst.Get (), [&routes, oif] (uint32_t s)
+                                 {
+                                   return routes[s].valid && (oif < 0 || routes[s].interface == uint32_t (oif));
+                                 });
+  if (slot == PrefixTrie::NONE)
+    {
+      return 0;
+    }
+  const Route &route = m_routes[slot];
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  if (setSource)
+    {
+      rtentry->SetSource (m_ipv4->SourceAddressSelection (route.interface, route.network.IsAny () ? route.gateway : route.network));
+    }
+  rtentry->SetDestination (route.network);
+  rtentry->SetGateway (route.gateway);
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (route.interface));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+RipTrie::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << header << oif);
+  Ptr<Ipv4Route> rtentry = Lookup (header.GetDestination (), true, oif);
+  sockerr = rtentry ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+  return rtentry;
+}
+
+bool
+RipTrie::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                     UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                     LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << header.GetSource () << header.GetDestination () << idev);
+  NS_ASSERT (m_ipv4 != 0);
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+  Ipv4Address dst = header.GetDestination ();
+
+  if (m_ipv4->IsDestinationAddress (dst, iif))
+    {
+      if (lcb.IsNull ())
+        {
+          return false;
+        }
+      lcb (p, header, iif);
+      return true;
+    }
+  if (dst.IsMulticast ())
+    {
+      return false;
+    }
+  if (dst.IsBroadcast ())
+    {
+      if (!ecb.IsNull ())
+        {
+          ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+      return false;
+    }
+  if (!m_ipv4->IsForwarding (iif))
+    {
+      if (!ecb.IsNull ())
+        {
+          ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+      return true;
+    }
+  Ptr<Ipv4Route> rtentry = Lookup (dst, false);
+  if (rtentry == 0)
+    {
+      return false;
+    }
+  ucb (rtentry, p, header);
+  return true;
+}
+
+void
+RipTrie::Receive (Ptr<Socket> socket)
+{
+  Address sender;
+  Ptr<Packet> packet = socket->RecvFrom (sender);
+  InetSocketAddress senderAddr = InetSocketAddress::ConvertFrom (sender);
+  Ipv4Address senderAddress = senderAddr.GetIpv4 ();
+  NS_LOG_INFO ("Received " << *packet << " from " << senderAddress << ":" << senderAddr.GetPort ());
+
+  Ipv4PacketInfoTag interfaceInfo;
+  NS_ABORT_MSG_UNLESS (packet->RemovePacketTag (interfaceInfo), "No incoming interface on RIP message, aborting.");
+  Ptr<NetDevice> dev = GetObject<Node> ()->GetDevice (interfaceInfo.GetRecvIf ());
+  uint32_t ipInterfaceIndex = m_ipv4->GetInterfaceForDevice (dev);
+  SocketIpTtlTag hoplimitTag;
+  NS_ABORT_MSG_UNLESS (packet->RemovePacketTag (hoplimitTag), "No incoming Hop Count on RIP message, aborting.");
+
+  if (m_ipv4->GetInterfaceForAddress (senderAddress) != -1)
+    {
+      NS_LOG_LOGIC ("Ignoring a packet sent by myself.");
+      return;
+    }
+
+  RipHeader hdr;
+  packet->RemoveHeader (hdr);
+  if (hdr.GetCommand () == RipHeader::RESPONSE)
+    {
+      HandleResponses (hdr, senderAddress, ipInterfaceIndex);
+    }
+  else if (hdr.GetCommand () == RipHeader::REQUEST)
+    {
+      HandleRequests (hdr, senderAddress, senderAddr.GetPort (), ipInterfaceIndex);
+    }
+}
+
+uint16_t
+RipTrie::GetMaxRtes (uint32_t interface) const
+{
+  return (m_ipv4->GetMtu (interface) - Ipv4Header ().GetSerializedSize () - UdpHeader ().GetSerializedSize ()
+          - RipHeader ().GetSerializedSize ()) / RipRte ().GetSerializedSize ();
+}
+
+void
+RipTrie::AddRte (std::vector<RipRte> &rtes, const Route &route, uint32_t interface) const
+{
+  bool splitHorizoning = route.interface == interface;
+  if (splitHorizoning && m_splitHorizonStrategy == Rip::SPLIT_HORIZON)
+    {
+      return;
+    }
+  RipRte rte;
+  rte.SetPrefix (route.network);
+  rte.SetSubnetMask (route.mask);
+  rte.SetRouteMetric (splitHorizoning && m_splitHorizonStrategy == Rip::POISON_REVERSE ? m_linkDown : route.metric);
+  rte.SetRouteTag (route.tag);
+  rtes.push_back (rte);
+}
+
+void
+RipTrie::CollectRtes (uint32_t interface, bool periodic, bool request, std::vector<RipRte> &rtes)
+{
+  // An update leaves out the networks of the interface itself and, unless
+  // periodic, unchanged routes; a reply to a full-table request sends the
+  // valid routes. Both as ns3::Rip.
+  std::vector<Ipv4Address> ownNetworks;
+  if (!request)
+    {
+      for (uint32_t j = 0; j < m_ipv4->GetNAddresses (interface); j++)
+        {
+          Ipv4InterfaceAddress addr = m_ipv4->GetAddress (interface, j);
+          ownNetworks.push_back (addr.GetLocal ().CombineMask (addr.GetMask ()));
+        }
+    }
+
+  std::map<uint32_t, PrefixTrie>::const_iterator summaries = m_summariesOn.find (interface);
+  if (summaries != m_summariesOn.end ())
+    {
+      for (size_t s = 0; s < m_summaries.size (); s++)
+        {
+          m_summaries[s].metric = m_linkDown;
+          m_summaries[s].covers = false;
+          m_summaries[s].changed = false;
+        }
+    }
+  bool splitHorizon = m_splitHorizonStrategy != Rip::NO_SPLIT_HORIZON;
+
+  for (size_t slot = 0; slot < m_routes.size (); slot++)
+    {
+      const Route &route = m_routes[slot];
+      if (!route.used || (request && !route.valid))
+        {
+          continue;
+        }
+      if (summaries != m_summariesOn.end ())
+        {
+          uint8_t length = route.mask.GetPrefixLength ();
+          const std::vector<Summary> &all = m_summaries;
+          uint32_t s = summaries->second.Lookup (route.network.Get (), [&all, length] (uint32_t i)
+                                                 {
+                                                   return all[i].mask.GetPrefixLength () <= length;
+                                                 });
+          if (s != PrefixTrie::NONE)
+            {
+              Summary &summary = m_summaries[s];
+              summary.covers = true;
+              summary.changed = summary.changed || route.changed;
+              if (!splitHorizon || route.interface != interface)
+                {
+                  summary.metric = std::min (summary.metric, route.metric);
+                }
+              continue;
+            }
+        }
+      if (!request && ((!periodic && !route.changed)
+                       || std::find (ownNetworks.begin (), ownNetworks.end (), route.network) != ownNetworks.end ()))
+        {
+          continue;
+        }
+      AddRte (rtes, route, interface);
+    }
+
+  if (summaries != m_summariesOn.end ())
+    {
+      for (size_t s = 0; s < m_summaries.size (); s++)
+        {
+          const Summary &summary = m_summaries[s];
+          if (summary.interface != interface || !summary.covers
+              || (request ? summary.metric >= m_linkDown : !periodic && !summary.changed))
+            {
+              continue;
+            }
+          RipRte rte;
+          rte.SetPrefix (summary.network);
+          rte.SetSubnetMask (summary.mask);
+          rte.SetRouteMetric (summary.metric);
+          rte.SetRouteTag (0);
+          rtes.push_back (rte);
+        }
+    }
+}
+
+void
+RipTrie::SendRtes (Ptr<Socket> socket, uint32_t interface, const std::vector<RipRte> &rtes,
+                   Ipv4Address to, uint16_t port, uint8_t ttl) const
+{
+  uint16_t maxRte = GetMaxRtes (interface);
+  for (size_t first = 0; first < rtes.size (); first += maxRte)
+    {
+      Ptr<Packet> p = Create<Packet> ();
+      SocketIpTtlTag tag;
+      tag.SetTtl (ttl);
+      p->AddPacketTag (tag);
+      RipHeader hdr;
+      hdr.SetCommand (RipHeader::RESPONSE);
+      for (size_t r = first; r < rtes.size () && r < first + maxRte; r++)
+        {
+          hdr.AddRte (rtes[r]);
+        }
+      p->AddHeader (hdr);
+      socket->SendTo (p, 0, InetSocketAddress (to, port));
+    }
+}
+
+void
+RipTrie::AddSummary (uint32_t interface, Ipv4Address network, Ipv4Mask mask)
+{
+  NS_LOG_FUNCTION (this << interface << network << mask);
+  network = network.CombineMask (mask);
+  PrefixTrie &summaries = m_summariesOn[interface];
+  if (summaries.Find (network.Get (), mask.GetPrefixLength ()) != PrefixTrie::NONE)
+    {
+      return;
+    }
+  Summary summary;
+  summary.interface = interface;
+  summary.network = network;
+  summary.mask = mask;
+  summary.metric = m_linkDown;
+  summary.covers = false;
+  summary.changed = false;
+  summaries.Insert (network.Get (), mask.GetPrefixLength (), m_summaries.size ());
+  m_ownSummaries.Insert (network.Get (), mask.GetPrefixLength (), m_summaries.size ());
+  m_summaries.push_back (summary);
+}
+
+uint32_t
+RipTrie::GetNSummaries (void) const
+{
+  return m_summaries.size ();
+}
+
+void
+RipTrie::HandleRequests (RipHeader requestHdr, Ipv4Address senderAddress, uint16_t senderPort, uint32_t incomingInterface)
+{
+  NS_LOG_FUNCTION (this << senderAddress << int (senderPort) << incomingInterface);
+  std::list<RipRte> rtes = requestHdr.GetRteList ();
+  if (rtes.empty ())
+    {
+      return;
+    }
+
+  uint8_t ttl = senderAddress == Ipv4Address (RIP_ALL_NODE) ? 1 : 255;
+  if (rtes.size () == 1 && rtes.begin ()->GetPrefix () == Ipv4Address::GetAny ()
+      && rtes.begin ()->GetSubnetMask ().GetPrefixLength () == 0 && rtes.begin ()->GetRouteMetric () == m_linkDown)
+    {
+      // The whole table, from the send socket of the interface the request
+      // came in on.
+      Ptr<Socket> sendingSocket;
+      for (SocketList::const_iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+        {
+          if (iter->second == incomingInterface)
+            {
+              sendingSocket = iter->first;
+            }
+        }
+      if (!sendingSocket)
+        {
+          return;
+        }
+      std::vector<RipRte> reply;
+      CollectRtes (incomingInterface, true, true, reply);
+      SendRtes (sendingSocket, incomingInterface, reply, senderAddress, RIP_PORT, ttl);
+      return;
+    }
+
+  // Specific prefixes: answer each with our metric, or infinity.
+  Ptr<Packet> p = Create<Packet> ();
+  SocketIpTtlTag tag;
+  tag.SetTtl (ttl);
+  p->AddPacketTag (tag);
+  RipHeader hdr;
+  hdr.SetCommand (RipHeader::RESPONSE);
+  for (std::list<RipRte>::iterator iter = rtes.begin (); iter != rtes.end (); iter++)
+    {
+      Ipv4Mask mask = iter->GetSubnetMask ();
+      uint32_t slot = m_trie.Find (iter->GetPrefix ().CombineMask (mask).Get (), mask.GetPrefixLength ());
+      if (slot != PrefixTrie::NONE && m_routes[slot].valid)
+        {
+          iter->SetRouteMetric (m_routes[slot].metric);
+          iter->SetRouteTag (m_routes[slot].tag);
+        }
+      else
+        {
+          iter->SetRouteMetric (m_linkDown);
+          iter->SetRouteTag (0);
+        }
+      hdr.AddRte (*iter);
+    }
+  p->AddHeader (hdr);
+  m_multicastRecvSocket->SendTo (p, 0, InetSocketAddress (senderAddress, senderPort));
+}
+
+void
+RipTrie::HandleResponses (RipHeader hdr, Ipv4Address senderAddress, uint32_t incomingInterface)
+{
+  NS_LOG_FUNCTION (this << senderAddress << incomingInterface);
+  if (IsExcluded (incomingInterface))
+    {
+      NS_LOG_LOGIC ("Ignoring an update message from an excluded interface: " << incomingInterface);
+      return;
+    }
+
+  std::list<RipRte> rtes = hdr.GetRteList ();
+  for (std::list<RipRte>::const_iterator iter = rtes.begin (); iter != rtes.end (); iter++)
+    {
+      if (iter->GetRouteMetric () == 0 || iter->GetRouteMetric () > m_linkDown)
+        {
+          NS_LOG_LOGIC ("Ignoring an update message with malformed metric: " << int (iter->GetRouteMetric ()));
+          return;
+        }
+      if (iter->GetPrefix ().IsLocalhost () || iter->GetPrefix ().IsBroadcast () || iter->GetPrefix ().IsMulticast ())
+        {
+          NS_LOG_LOGIC ("Ignoring an update message with wrong prefixes: " << iter->GetPrefix ());
+          return;
+        }
+    }
+
+  uint32_t interfaceMetric = GetInterfaceMetric (incomingInterface);
+  bool changed = false;
+  for (std::list<RipRte>::const_iterator iter = rtes.begin (); iter != rtes.end (); iter++)
+    {
+      Ipv4Mask mask = iter->GetSubnetMask ();
+      Ipv4Address network = iter->GetPrefix ().CombineMask (mask);
+      uint32_t metric = std::min<uint32_t> (iter->GetRouteMetric () + interfaceMetric, m_linkDown);
+      if (m_ownSummaries.Find (network.Get (), mask.GetPrefixLength ()) != PrefixTrie::NONE)
+        {
+          // Our own summary, back from another border of the area.
+          continue;
+        }
+
+      uint32_t slot = m_trie.Find (network.Get (), mask.GetPrefixLength ());
+      if (slot == PrefixTrie::NONE)
+        {
+          if (metric != m_linkDown)
+            {
+              slot = AddRoute (network, mask, senderAddress, incomingInterface);
+              m_routes[slot].metric = metric;
+              RefreshTimeout (slot);
+              changed = true;
+            }
+          continue;
+        }
+
+      // The decisions of ns3::Rip::HandleResponses: a better metric wins, an
+      // equal one from another gateway only once the route is half-way to
+      // timing out, and the current gateway is believed when it gets worse.
+      Route &route = m_routes[slot];
+      bool sameGateway = senderAddress == route.gateway;
+      bool replace = metric < route.metric
+        || (metric == route.metric && metric < m_linkDown && !sameGateway
+            && Simulator::GetDelayLeft (route.timer) < m_timeoutDelay / 2);
+      if (replace)
+        {
+          route.gateway = senderAddress;
+          route.interface = incomingInterface;
+          route.metric = metric;
+          route.valid = true;
+          route.tag = iter->GetRouteTag ();
+          route.changed = true;
+          RefreshTimeout (slot);
+          changed = true;
+        }
+      else if (metric == route.metric && sameGateway)
+        {
+          RefreshTimeout (slot);
+        }
+      else if (metric > route.metric && sameGateway)
+        {
+          if (metric < m_linkDown)
+            {
+              route.metric = metric;
+              route.valid = true;
+              route.tag = iter->GetRouteTag ();
+              route.changed = true;
+              RefreshTimeout (slot);
+            }
+          else
+            {
+              InvalidateRoute (slot);
+            }
+          changed = true;
+        }
+    }
+
+  if (changed)
+    {
+      NotifyTableChanged ();
+      SendTriggeredRouteUpdate ();
+    }
+}
+
+void
+RipTrie::SendRouteRequest (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Packet> p = Create<Packet> ();
+  SocketIpTtlTag tag;
+  tag.SetTtl (1);
+  p->AddPacketTag (tag);
+
+  RipHeader hdr;
+  hdr.SetCommand (RipHeader::REQUEST);
+  RipRte rte;
+  rte.SetPrefix (Ipv4Address::GetAny ());
+  rte.SetSubnetMask (Ipv4Mask::GetZero ());
+  rte.SetRouteMetric (m_linkDown);
+  hdr.AddRte (rte);
+  p->AddHeader (hdr);
+
+  for (SocketList::const_iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+    {
+      if (!IsExcluded (iter->second))
+        {
+          iter->first->SendTo (p, 0, InetSocketAddress (Ipv4Address (RIP_ALL_NODE), RIP_PORT));
+        }
+    }
+}
+
+void
+RipTrie::SendTriggeredRouteUpdate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_nextTriggeredUpdate.IsRunning ())
+    {
+      NS_LOG_LOGIC ("Skipping Triggered Update due to cooldown");
+      return;
+    }
+  // Changes made during the cooldown go out with the update that ends it,
+  // as in ns3::Rip (RFC 2453, section 3.10.1).
+  Time delay = Seconds (m_rng->GetValue (m_minTriggeredUpdateDelay.GetSeconds (), m_maxTriggeredUpdateDelay.GetSeconds ()));
+  m_nextTriggeredUpdate = Simulator::Schedule (delay, &RipTrie::DoSendRouteUpdate, this, false);
+}
+
+void
+RipTrie::SendUnsolicitedRouteUpdate (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nextTriggeredUpdate.Cancel ();
+  DoSendRouteUpdate (true);
+  Time delay = m_unsolicitedUpdate + Seconds (m_rng->GetValue (0, 0.5 * m_unsolicitedUpdate.GetSeconds ()));
+  m_nextUnsolicitedUpdate = Simulator::Schedule (delay, &RipTrie::SendUnsolicitedRouteUpdate, this);
+}
+
+void
+RipTrie::DoSendRouteUpdate (bool periodic)
+{
+  NS_LOG_FUNCTION (this << periodic);
+  for (SocketList::const_iterator iter = m_unicastSocketList.begin (); iter != m_unicastSocketList.end (); iter++)
+    {
+      uint32_t interface = iter->second;
+      if (IsExcluded (interface))
+        {
+          continue;
+        }
+      std::vector<RipRte> rtes;
+      CollectRtes (interface, periodic, false, rtes);
+      SendRtes (iter->first, interface, rtes, Ipv4Address (RIP_ALL_NODE), RIP_PORT, 1);
+    }
+  for (size_t slot = 0; slot < m_routes.size (); slot++)
+    {
+      m_routes[slot].changed = false;
+    }
+}
+
+void
+RipTrie::GetRoutes (std::vector<RipRoute> &routes) const
+{
+  routes.clear ();
+  routes.reserve (m_trie.GetSize ());
+  for (size_t slot = 0; slot < m_routes.size (); slot++)
+    {
+      const Route &route = m_routes[slot];
+      if (route.used && route.valid)
+        {
+          RipRoute r = { route.network.Get (), route.mask.Get (), route.gateway.Get (), route.interface, route.metric };
+          routes.push_back (r);
+        }
+    }
+}
+
+void
+RipTrie::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  // The layout of Rip::PrintRoutingTable.
+  std::ostream *os = stream->GetStream ();
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << m_ipv4->GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", IPv4 RIP table" << std::endl;
+  if (m_trie.GetSize () > 0)
+    {
+      *os << "Destination     Gateway         Genmask         Flags Metric Ref    Use Iface" << std::endl;
+      for (size_t slot = 0; slot < m_routes.size (); slot++)
+        {
+          const Route &route = m_routes[slot];
+          if (!route.used || !route.valid)
+            {
+              continue;
+            }
+          std::ostringstream dest, gw, mask, flags;
+          dest << route.network;
+          gw << route.gateway;
+          mask << route.mask;
+          flags << "U";
+          if (route.mask == Ipv4Mask::GetOnes ())
+            {
+              flags << "HS";
+            }
+          else if (!route.gateway.IsAny ())
+            {
+              flags << "GS";
+            }
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ();
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << gw.str ();
+          *os << std::setiosflags (std::ios::left) << std::setw (16) << mask.str ();
+          *os << std::setiosflags (std::ios::left) << std::setw (6) << flags.str ();
+          *os << std::setiosflags (std::ios::left) << std::setw (7) << route.metric;
+          *os << "-" << "      ";
+          *os << "-" << "   ";
+          std::string name = Names::FindName (m_ipv4->GetNetDevice (route.interface));
+          if (name != "")
+            {
+              *os << name;
+            }
+          else
+            {
+              *os << route.interface;
+            }
+          *os << std::endl;
+        }
+    }
+  *os << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,183 @@
+#ifndef RIP_TRIE_H
+#define RIP_TRIE_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "../prefix-trie.h"
+#include "../rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief ns3::Rip with its routes indexed by a prefix trie.
+ *
+ * ns3::Rip keeps its routes in a list: forwarding a packet scans the whole
+ * list for the longest match, and every entry of a received response scans
+ * it again for its prefix. RipTrie keeps the routes in a slot vector and a
+ * PrefixTrie from prefix to slot, updated in place as routes are added,
+ * changed and garbage-collected, so both become a walk of at most 33 trie
+ * nodes. Updates and full-table replies still walk every route.
+ *
+ * The protocol is ns3::Rip's: the same requests, responses, split horizon,
+ * route timeout, garbage collection and triggered-update cooldown, driven
+ * by ns3::Rip's attributes (Config::SetDefault ("ns3::Rip::...") applies).
+ * Because it derives from Rip, everything that finds RIP through
+ * Ipv4RoutingHelper::GetRouting<Rip> keeps working, and so do the
+ * inherited interface exclusions and metrics. The jitter comes from its own
+ * random stream, so a run is not event-for-event that of ns3::Rip.
+ * Rip::AssignStreams and Rip::AddDefaultRouteTo are not virtual and would
+ * act on the idle base class through a Ptr<Rip>: call RipTrie's, or go
+ * through RipTrieHelper, which does.
+ *
+ * The TableChanged trace fires whenever a route is added, changed or
+ * withdrawn, so RipTableWatcher does not have to look at every packet, and
+ * as a RipRouteSource the table is read without printing it.
+ *
+ * AddSummary makes a router advertise an aggregate on an interface
+ * instead of the routes it covers, which ns3::Rip cannot do.
+ *
+ * Use RipTrieHelper to install it.
+ */
+class RipTrie : public Rip, public RipRouteSource
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /// TracedCallback signature of TableChanged, with the node id.
+  typedef void (*TableChangedCallback) (uint32_t nodeId);
+
+  RipTrie ();
+  virtual ~RipTrie ();
+
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                      Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+  virtual void GetRoutes (std::vector<RipRoute> &routes) const;
+
+  /// As Rip::AssignStreams, which is not virtual.
+  int64_t AssignStreams (int64_t stream);
+  /// As Rip::AddDefaultRouteTo, which is not virtual.
+  void AddDefaultRouteTo (Ipv4Address nextHop, uint32_t interface);
+  /// As Rip::SetInterfaceExclusions, which is not virtual. Exclusions set
+  /// through Ptr<Rip> are picked up when the protocol is attached and started.
+  void SetInterfaceExclusions (std::set<uint32_t> exceptions);
+  /// Routes in the table, valid or waiting for garbage collection.
+  uint32_t GetNRoutes (void) const;
+
+  /**
+   * \brief Advertise network/mask on an interface in place of the routes
+   * it covers.
+   *
+   * The summary goes out whenever one of the covered routes would have,
+   * with the best metric among them; routes learned on the interface
+   * itself do not count unless split horizon is off. It is withdrawn
+   * (metric infinity) once none of them is left. Responses carrying one of
+   * the router's own summaries are ignored, so a summary that reaches the
+   * area again from another border does not draw its traffic away.
+   */
+  void AddSummary (uint32_t interface, Ipv4Address network, Ipv4Mask mask);
+  uint32_t GetNSummaries (void) const;
+
+protected:
+  virtual void DoDispose (void);
+  virtual void DoInitialize (void);
+
+private:
+  struct Route
+  {
+    Ipv4Address network;
+    Ipv4Mask mask;
+    Ipv4Address gateway; // 0.0.0.0 for a connected network
+    uint32_t interface;
+    uint32_t metric;
+    uint16_t tag;
+    bool valid;
+    bool changed;
+    bool used;           // the slot holds a route
+    EventId timer;       // timeout while valid, garbage collection after
+  };
+
+  struct Summary
+  {
+    uint32_t interface;
+    Ipv4Address network;
+    Ipv4Mask mask;
+    // Folded from the covered routes while an update is put together
+    uint32_t metric;
+    bool covers;
+    bool changed;
+  };
+
+  typedef std::map<Ptr<Socket>, uint32_t> SocketList;
+
+  void LoadAttributes (void);
+  void OpenSockets (uint32_t interface);
+
+  uint32_t AddRoute (Ipv4Address network, Ipv4Mask mask, Ipv4Address gateway, uint32_t interface);
+  void AddNetworkRouteTo (Ipv4Address network, Ipv4Mask mask, uint32_t interface);
+  void InvalidateRoute (uint32_t slot);
+  void DeleteRoute (uint32_t slot);
+  void NotifyTableChanged (void);
+  void RefreshTimeout (uint32_t slot);
+  Ptr<Ipv4Route> Lookup (Ipv4Address dst, bool setSource, Ptr<NetDevice> interface = 0);
+
+  void Receive (Ptr<Socket> socket);
+  void HandleRequests (RipHeader requestHdr, Ipv4Address senderAddress, uint16_t senderPort, uint32_t incomingInterface);
+  void HandleResponses (RipHeader hdr, Ipv4Address senderAddress, uint32_t incomingInterface);
+  void SendRouteRequest (void);
+  void SendTriggeredRouteUpdate (void);
+  void SendUnsolicitedRouteUpdate (void);
+  void DoSendRouteUpdate (bool periodic);
+  /// Append a route to a response for an interface, with split horizon.
+  void AddRte (std::vector<RipRte> &rtes, const Route &route, uint32_t interface) const;
+  /// The entries of an update (or of a reply to a full-table request) for an interface.
+  void CollectRtes (uint32_t interface, bool periodic, bool request, std::vector<RipRte> &rtes);
+  /// Send entries as responses of at most one MTU each.
+  void SendRtes (Ptr<Socket> socket, uint32_t interface, const std::vector<RipRte> &rtes,
+                 Ipv4Address to, uint16_t port, uint8_t ttl) const;
+  uint16_t GetMaxRtes (uint32_t interface) const;
+  bool IsExcluded (uint32_t interface) const;
+
+  Ptr<Ipv4> m_ipv4;
+  std::vector<Route> m_routes;
+  std::vector<uint32_t> m_freeSlots;
+  PrefixTrie m_trie;              // prefix -> slot in m_routes
+  std::vector<Summary> m_summaries;
+  std::map<uint32_t, PrefixTrie> m_summariesOn; // interface -> prefix -> index in m_summaries
+  PrefixTrie m_ownSummaries;
+  SocketList m_unicastSocketList; // send sockets, by interface
+  Ptr<Socket> m_multicastRecvSocket;
+  EventId m_nextUnsolicitedUpdate;
+  EventId m_nextTriggeredUpdate;
+  Ptr<UniformRandomVariable> m_rng;
+  bool m_initialized;
+  std::set<uint32_t> m_exclusions; // Rip::GetInterfaceExclusions, which returns a copy
+  uint32_t m_nodeId;
+  TracedCallback<uint32_t> m_tableChangedTrace;
+
+  // ns3::Rip's attributes, read when the protocol is attached and started
+  Time m_unsolicitedUpdate;
+  Time m_startupDelay;
+  Time m_timeoutDelay;
+  Time m_garbageCollectionDelay;
+  Time m_minTriggeredUpdateDelay;
+  Time m_maxTriggeredUpdateDelay;
+  int m_splitHorizonStrategy;
+  uint32_t m_linkDown;
+};
+
+} // namespace ns3
+
+#endif /* RIP_TRIE_H */
@@ -0,0 +1,119 @@
+#include <cstdio>
+#include <fstream>
+#include <sys/resource.h>
+#include "run-result.h"
+#include "ns3/abort.h"
+#include "ns3/callback.h"
+#include "ns3/config.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+
+namespace ns3 {
+
+static const uint16_t RIP_PORT = 520;
+
+void
+RunResult::Write (const std::string &path) const
+{
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream os (tmp.c_str (), std::ios::out | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS (os, "Cannot write result file " << tmp);
+    for (size_t i = 0; i < m_values.size (); ++i)
+      {
+        os << m_values[i].first << "=" << m_values[i].second << "\n";
+      }
+  }
+  NS_ABORT_MSG_IF (std::rename (tmp.c_str (), path.c_str ()) != 0, "Cannot rename " << tmp << " to " << path);
+}
+
+uint64_t
+GetPeakRssKb (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss; // kilobytes on Linux
+}
+
+static const uint32_t HEADER_BUFFER = 64; // the longest IP header and the UDP ports
+
+/// The IP protocol of a packet and, for UDP, its destination port (else 0).
+static bool
+PeekPorts (Ptr<const Packet> packet, uint8_t &protocol, uint16_t &port)
+{
+  uint8_t buf[HEADER_BUFFER];
+  uint32_t size = packet->CopyData (buf, HEADER_BUFFER);
+  if (size < 20)
+    {
+      return false;
+    }
+  uint32_t ihl = (buf[0] & 0x0f) * 4;
+  protocol = buf[9];
+  port = protocol == UdpL4Protocol::PROT_NUMBER && size >= ihl + 4 ? uint16_t ((buf[ihl + 2] << 8) | buf[ihl + 3]) : 0;
+  return true;
+}
+
+static void
+CountRipTx (TrafficCounters *counters, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  uint8_t protocol;
+  uint16_t port;
+  if (PeekPorts (packet, protocol, port) && port == RIP_PORT)
+    {
+      counters->ripPackets++;
+      counters->ripBytes += packet->GetSize ();
+    }
+}
+
+static void
+CountPingTx (TrafficCounters *counters, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  uint8_t protocol;
+  uint16_t port;
+  if (PeekPorts (packet, protocol, port) && protocol == Icmpv4L4Protocol::PROT_NUMBER)
+    {
+      counters->pingSent++;
+    }
+}
+
+static void
+CountPingReply (TrafficCounters *counters, Time rtt)
+{
+  counters->pingReceived++;
+}
+
+TrafficCounters::TrafficCounters ()
+  : srcId (0),
+    pingSent (0),
+    pingReceived (0),
+    ripPackets (0),
+    ripBytes (0)
+{
+}
+
+void
+TrafficCounters::Connect (NodeContainer routers, Ptr<Node> src)
+{
+  srcId = src->GetId ();
+  for (NodeContainer::Iterator it = routers.Begin (); it != routers.End (); ++it)
+    {
+      (*it)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&CountRipTx, this));
+    }
+  src->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&CountPingTx, this));
+  std::ostringstream path;
+  path << "/NodeList/" << srcId << "/ApplicationList/*/$ns3::V4Ping/Rtt";
+  Config::ConnectWithoutContext (path.str (), MakeBoundCallback (&CountPingReply, this));
+}
+
+void
+TrafficCounters::Export (RunResult &result) const
+{
+  result.Set ("pingSent", pingSent);
+  result.Set ("pingReceived", pingReceived);
+  result.Set ("pingLoss", pingSent == 0 ? 0.0 : 1.0 - double (pingReceived) / pingSent);
+  result.Set ("ripPackets", ripPackets);
+  result.Set ("ripBytes", ripBytes);
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+#ifndef RUN_RESULT_H
+#define RUN_RESULT_H
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4.h"
+
+namespace ns3 {
+
+/**
+ * \brief Summary of one bGoal run as "key=value" lines.
+ *
+ * The file is written under a temporary name and renamed into place, so a
+ * result file that exists is always complete. The sweep runner relies on
+ * this to skip finished runs when it is resumed.
+ */
+class RunResult
+{
+public:
+  template <typename T>
+  void Set (const std::string &key, const T &value);
+  void Write (const std::string &path) const;
+
+private:
+  std::vector<std::pair<std::string, std::string> > m_values;
+};
+
+template <typename T>
+void
+RunResult::Set (const std::string &key, const T &value)
+{
+  std::ostringstream oss;
+  oss << value;
+  for (size_t i = 0; i < m_values.size (); ++i)
+    {
+      if (m_values[i].first == key)
+        {
+          m_values[i].second = oss.str ();
+          return;
+        }
+    }
+  m_values.push_back (std::make_pair (key, oss.str ()));
+}
+
+/// Peak resident set size of this process so far, in kilobytes.
+uint64_t GetPeakRssKb (void);
+
+/**
+ * \brief Ping and RIP packet counts, fed by Ipv4L3Protocol and V4Ping traces.
+ *
+ * Only the routers' and src's Tx traces are hooked, and a packet is
+ * classified from its IP and UDP headers copied into a stack buffer.
+ */
+struct TrafficCounters
+{
+  TrafficCounters ();
+  /**
+   * \brief Hook the RIP counters on these routers and the ping counters on
+   * src. Call after the ping application is installed.
+   */
+  void Connect (NodeContainer routers, Ptr<Node> src);
+  void Export (RunResult &result) const;
+
+  uint32_t srcId;
+  uint64_t pingSent;
+  uint64_t pingReceived;
+  uint64_t ripPackets;
+  uint64_t ripBytes;
+};
+
+} // namespace ns3
+
+#endif /* RUN_RESULT_H */
@@ -0,0 +1,116 @@
+#include <cstdlib>
+#include "subnet-allocator.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/ipv4.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/traffic-control-helper.h"
+
+namespace ns3 {
+
+static uint32_t
+PrefixToMask (uint32_t prefix)
+{
+  return prefix == 0 ? 0 : 0xffffffffu << (32 - prefix);
+}
+
+SubnetAllocator::SubnetAllocator (Ipv4Address pool, uint32_t poolPrefix, uint32_t linkPrefix)
+  : m_linkPrefix (linkPrefix),
+    m_next (0)
+{
+  NS_ABORT_MSG_UNLESS (linkPrefix == 30 || linkPrefix == 31,
+                       "SubnetAllocator: link prefix must be /30 or /31, got /" << linkPrefix);
+  NS_ABORT_MSG_UNLESS (poolPrefix >= 8 && poolPrefix <= linkPrefix,
+                       "SubnetAllocator: pool prefix /" << poolPrefix << " cannot hold /" << linkPrefix << " blocks");
+  m_poolMask = PrefixToMask (poolPrefix);
+  m_base = pool.Get () & m_poolMask;
+  m_blockSize = 1u << (32 - linkPrefix);
+  m_capacity = 1u << (linkPrefix - poolPrefix);
+}
+
+SubnetAllocator
+SubnetAllocator::FromString (const std::string &pool, uint32_t linkPrefix)
+{
+  std::string::size_type slash = pool.find ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos, "SubnetAllocator: pool \"" << pool << "\" is not in a.b.c.d/len form");
+  Ipv4Address base (pool.substr (0, slash).c_str ());
+  uint32_t prefix = std::atoi (pool.substr (slash + 1).c_str ());
+  return SubnetAllocator (base, prefix, linkPrefix);
+}
+
+Ipv4Address
+SubnetAllocator::Allocate (void)
+{
+  NS_ABORT_MSG_IF (m_next >= m_capacity,
+                   "SubnetAllocator: pool " << Ipv4Address (m_base) << " exhausted after " << m_capacity << " /" << m_linkPrefix << " blocks");
+  return Ipv4Address (m_base + (m_next++) * m_blockSize);
+}
+
+Ipv4InterfaceContainer
+SubnetAllocator::AssignLink (const NetDeviceContainer &devices)
+{
+  NS_ABORT_MSG_UNLESS (devices.GetN () == 2, "SubnetAllocator: a link block only fits two devices");
+  uint32_t network = Allocate ().Get ();
+  // A /31 has no network or broadcast address (RFC 3021), a /30 skips both.
+  uint32_t firstHost = m_linkPrefix == 31 ? network : network + 1;
+  Ipv4Mask mask (PrefixToMask (m_linkPrefix));
+
+  Ipv4InterfaceContainer retval;
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      Ptr<NetDevice> device = devices.Get (i);
+      Ptr<Node> node = device->GetNode ();
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      NS_ABORT_MSG_IF (ipv4 == 0, "SubnetAllocator: install an Internet stack on node " << node->GetId () << " first");
+
+      int32_t interface = ipv4->GetInterfaceForDevice (device);
+      if (interface == -1)
+        {
+          interface = ipv4->AddInterface (device);
+        }
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (firstHost + i), mask));
+      ipv4->SetMetric (interface, 1);
+      ipv4->SetUp (interface);
+      retval.Add (ipv4, interface);
+
+      Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+      if (tc && tc->GetRootQueueDiscOnDevice (device) == 0)
+        {
+          TrafficControlHelper tcHelper = TrafficControlHelper::Default ();
+          tcHelper.Install (device);
+        }
+    }
+  return retval;
+}
+
+Ipv4Address
+SubnetAllocator::GetBase (void) const
+{
+  return Ipv4Address (m_base);
+}
+
+Ipv4Mask
+SubnetAllocator::GetLinkMask (void) const
+{
+  return Ipv4Mask (PrefixToMask (m_linkPrefix));
+}
+
+uint32_t
+SubnetAllocator::GetCapacity (void) const
+{
+  return m_capacity;
+}
+
+uint32_t
+SubnetAllocator::GetAllocated (void) const
+{
+  return m_next;
+}
+
+bool
+SubnetAllocator::Contains (Ipv4Address address) const
+{
+  return (address.Get () & m_poolMask) == m_base;
+}
+
+} // namespace ns3
@@ -0,0 +1,61 @@
+#ifndef SUBNET_ALLOCATOR_H
+#define SUBNET_ALLOCATOR_H
+
+#include <string>
+#include "ns3/ipv4-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-interface-container.h"
+
+namespace ns3 {
+
+/**
+ * \brief Hands out fixed-size link subnets (/30 or /31) from an address pool.
+ *
+ * Blocks are computed with integer arithmetic on the pool base, so building
+ * a chain of N links costs O(N) and never formats or parses an address string.
+ */
+class SubnetAllocator
+{
+public:
+  /**
+   * \param pool network address of the pool
+   * \param poolPrefix prefix length of the pool
+   * \param linkPrefix prefix length of each handed-out block (30 or 31)
+   */
+  SubnetAllocator (Ipv4Address pool, uint32_t poolPrefix, uint32_t linkPrefix);
+
+  /**
+   * \brief Parse a pool given as "a.b.c.d/len". Only used once at startup.
+   */
+  static SubnetAllocator FromString (const std::string &pool, uint32_t linkPrefix);
+
+  /**
+   * \brief Take the next free block. Aborts when the pool is exhausted.
+   * \return the network address of the block
+   */
+  Ipv4Address Allocate (void);
+
+  /**
+   * \brief Allocate a block and assign its host addresses to the two devices
+   * of a point-to-point style link, the same way Ipv4AddressHelper::Assign does.
+   */
+  Ipv4InterfaceContainer AssignLink (const NetDeviceContainer &devices);
+
+  Ipv4Address GetBase (void) const;
+  Ipv4Mask GetLinkMask (void) const;
+  uint32_t GetCapacity (void) const;
+  uint32_t GetAllocated (void) const;
+  bool Contains (Ipv4Address address) const;
+
+private:
+  uint32_t m_base;
+  uint32_t m_poolMask;
+  uint32_t m_linkPrefix;
+  uint32_t m_blockSize;
+  uint32_t m_capacity;
+  uint32_t m_next;
+};
+
+} // namespace ns3
+
+#endif /* SUBNET_ALLOCATOR_H */
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include "topology-generator.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+const uint32_t TopologyGenerator::UNREACHABLE;
+
+bool
+TopologyGenerator::IsKnown (const std::string &kind)
+{
+  return kind == "grid" || kind == "ring" || kind == "er" || kind == "ba";
+}
+
+TopologyGenerator::TopologyGenerator (const std::string &kind, uint32_t n, double avgDegree, int64_t stream)
+  : m_n (n),
+    m_random (CreateObject<UniformRandomVariable> ())
+{
+  m_random->SetStream (stream);
+  NS_ABORT_MSG_UNLESS (IsKnown (kind), "Unknown topology \"" << kind << "\" (chain, grid, ring, er, ba)");
+  NS_ABORT_MSG_IF (n < 4, "Generated topologies need at least 4 routers");
+  NS_ABORT_MSG_IF (kind != "grid" && avgDegree < 2, "avgDegree must be at least 2");
+  if (kind == "grid")
+    {
+      Grid ();
+    }
+  else if (kind == "ring")
+    {
+      Ring (avgDegree);
+    }
+  else if (kind == "er")
+    {
+      ErdosRenyi (avgDegree);
+    }
+  else
+    {
+      BarabasiAlbert (avgDegree);
+    }
+  BuildAdjacency ();
+}
+
+void
+TopologyGenerator::Grid (void)
+{
+  uint32_t width = uint32_t (std::ceil (std::sqrt (double (m_n))));
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      if ((v + 1) % width != 0 && v + 1 < m_n)
+        {
+          m_edges.push_back (Edge (v, v + 1));
+        }
+      if (v + width < m_n)
+        {
+          m_edges.push_back (Edge (v, v + width));
+        }
+    }
+}
+
+void
+TopologyGenerator::Ring (double avgDegree)
+{
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      m_edges.push_back (Edge (std::min (v, (v + 1) % m_n), std::max (v, (v + 1) % m_n)));
+    }
+  uint64_t chords = uint64_t (m_n * (avgDegree - 2) / 2 + 0.5);
+  uint64_t possible = uint64_t (m_n) * (m_n - 1) / 2 - m_n;
+  NS_ABORT_MSG_IF (chords > possible / 2, "avgDegree " << avgDegree << " is too dense for a ring of " << m_n);
+  std::unordered_set<uint64_t> seen;
+  seen.reserve (m_edges.size () + chords);
+  for (size_t i = 0; i < m_edges.size (); ++i)
+    {
+      seen.insert (uint64_t (m_edges[i].first) << 32 | m_edges[i].second);
+    }
+  while (chords > 0)
+    {
+      uint32_t a = m_random->GetInteger (0, m_n - 1);
+      uint32_t b = m_random->GetInteger (0, m_n - 1);
+      if (a == b)
+        {
+          continue;
+        }
+      Edge e (std::min (a, b), std::max (a, b));
+      if (seen.insert (uint64_t (e.first) << 32 | e.second).second)
+        {
+          m_edges.push_back (e);
+          --chords;
+        }
+    }
+}
+
+void
+TopologyGenerator::ErdosRenyi (double avgDegree)
+{
+  double p = std::min (1.0, avgDegree / (m_n - 1));
+  // Batagelj and Brandes, "Efficient generation of large random networks":
+  // jump over the pairs (v, w), w < v, that get no edge.
+  double logq = std::log (1.0 - p);
+  int64_t v = 1;
+  int64_t w = -1;
+  while (v < m_n)
+    {
+      double r = m_random->GetValue (0.0, 1.0);
+      w += 1 + (p >= 1.0 ? 0 : int64_t (std::floor (std::log (1.0 - r) / logq)));
+      while (w >= v && v < m_n)
+        {
+          w -= v;
+          ++v;
+        }
+      if (v < m_n)
+        {
+          m_edges.push_back (Edge (uint32_t (w), uint32_t (v)));
+        }
+    }
+  Connect ();
+}
+
+void
+TopologyGenerator::BarabasiAlbert (double avgDegree)
+{
+  uint32_t m = std::max (1u, uint32_t (avgDegree / 2 + 0.5));
+  NS_ABORT_MSG_IF (m + 1 > m_n, "avgDegree " << avgDegree << " needs more than " << m_n << " routers");
+  // Every edge end once: drawing from it picks a node with probability
+  // proportional to its degree.
+  std::vector<uint32_t> ends;
+  ends.reserve (2 * (uint64_t (m) * m_n));
+  for (uint32_t a = 0; a <= m; ++a)
+    {
+      for (uint32_t b = a + 1; b <= m; ++b)
+        {
+          m_edges.push_back (Edge (a, b));
+          ends.push_back (a);
+          ends.push_back (b);
+        }
+    }
+  std::vector<uint32_t> chosen;
+  for (uint32_t v = m + 1; v < m_n; ++v)
+    {
+      chosen.clear ();
+      while (chosen.size () < m)
+        {
+          uint32_t t = ends[m_random->GetInteger (0, ends.size () - 1)];
+          if (std::find (chosen.begin (), chosen.end (), t) == chosen.end ())
+            {
+              chosen.push_back (t);
+            }
+        }
+      for (size_t i = 0; i < chosen.size (); ++i)
+        {
+          m_edges.push_back (Edge (chosen[i], v));
+          ends.push_back (chosen[i]);
+          ends.push_back (v);
+        }
+    }
+}
+
+void
+TopologyGenerator::Connect (void)
+{
+  // Union-find over the edges, then one link from every other component
+  // into the largest.
+  std::vector<uint32_t> parent (m_n);
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      parent[v] = v;
+    }
+  struct Find
+  {
+    static uint32_t Root (std::vector<uint32_t> &parent, uint32_t v)
+    {
+      while (parent[v] != v)
+        {
+          parent[v] = parent[parent[v]];
+          v = parent[v];
+        }
+      return v;
+    }
+  };
+  for (size_t i = 0; i < m_edges.size (); ++i)
+    {
+      uint32_t a = Find::Root (parent, m_edges[i].first);
+      uint32_t b = Find::Root (parent, m_edges[i].second);
+      parent[a] = b;
+    }
+  std::vector<uint32_t> size (m_n, 0);
+  uint32_t giant = 0;
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      uint32_t r = Find::Root (parent, v);
+      if (++size[r] > size[giant])
+        {
+          giant = r;
+        }
+    }
+  std::vector<uint32_t> giantNodes;
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      if (Find::Root (parent, v) == giant)
+        {
+          giantNodes.push_back (v);
+        }
+    }
+  // Chaining the small components would stretch the diameter; hang each
+  // one off a random router of the largest component instead.
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      uint32_t r = Find::Root (parent, v);
+      if (r != giant)
+        {
+          uint32_t to = giantNodes[m_random->GetInteger (0, giantNodes.size () - 1)];
+          m_edges.push_back (Edge (std::min (v, to), std::max (v, to)));
+          parent[r] = giant;
+        }
+    }
+}
+
+void
+TopologyGenerator::BuildAdjacency (void)
+{
+  m_offset.assign (m_n + 1, 0);
+  for (size_t i = 0; i < m_edges.size (); ++i)
+    {
+      m_offset[m_edges[i].first + 1]++;
+      m_offset[m_edges[i].second + 1]++;
+    }
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      m_offset[v + 1] += m_offset[v];
+    }
+  m_neighbor.resize (m_offset[m_n]);
+  m_edgeOf.resize (m_offset[m_n]);
+  std::vector<uint32_t> fill (m_offset.begin (), m_offset.end () - 1);
+  for (size_t i = 0; i < m_edges.size (); ++i)
+    {
+      uint32_t a = m_edges[i].first;
+      uint32_t b = m_edges[i].second;
+      m_neighbor[fill[a]] = b;
+      m_edgeOf[fill[a]++] = i;
+      m_neighbor[fill[b]] = a;
+      m_edgeOf[fill[b]++] = i;
+    }
+}
+
+const std::vector<TopologyGenerator::Edge> &
+TopologyGenerator::GetEdges (void) const
+{
+  return m_edges;
+}
+
+uint32_t
+TopologyGenerator::GetDegree (uint32_t node) const
+{
+  return m_offset[node + 1] - m_offset[node];
+}
+
+std::vector<uint32_t>
+TopologyGenerator::GetDistances (uint32_t from, size_t without) const
+{
+  std::vector<uint32_t> distance (m_n, UNREACHABLE);
+  std::vector<uint32_t> queue;
+  queue.reserve (m_n);
+  distance[from] = 0;
+  queue.push_back (from);
+  for (size_t head = 0; head < queue.size (); ++head)
+    {
+      uint32_t v = queue[head];
+      for (uint32_t k = m_offset[v]; k < m_offset[v + 1]; ++k)
+        {
+          uint32_t w = m_neighbor[k];
+          if (distance[w] == UNREACHABLE && m_edgeOf[k] != without)
+            {
+              distance[w] = distance[v] + 1;
+              queue.push_back (w);
+            }
+        }
+    }
+  return distance;
+}
+
+uint32_t
+TopologyGenerator::GetFarthest (uint32_t from, uint32_t &distance) const
+{
+  std::vector<uint32_t> d = GetDistances (from, m_edges.size ());
+  uint32_t farthest = from;
+  for (uint32_t v = 0; v < m_n; ++v)
+    {
+      if (d[v] != UNREACHABLE && d[v] > d[farthest])
+        {
+          farthest = v;
+        }
+    }
+  distance = d[farthest];
+  return farthest;
+}
+
+uint32_t
+TopologyGenerator::EstimateDiameter (void) const
+{
+  uint32_t distance;
+  uint32_t end = GetFarthest (0, distance);
+  GetFarthest (end, distance);
+  return distance;
+}
+
+std::vector<size_t>
+TopologyGenerator::GetShortestPath (uint32_t from, uint32_t to) const
+{
+  // Walk back from "to" along strictly decreasing distances.
+  std::vector<uint32_t> d = GetDistances (from, m_edges.size ());
+  std::vector<size_t> path;
+  if (d[to] == UNREACHABLE)
+    {
+      return path;
+    }
+  uint32_t v = to;
+  while (v != from)
+    {
+      for (uint32_t k = m_offset[v]; k < m_offset[v + 1]; ++k)
+        {
+          if (d[m_neighbor[k]] + 1 == d[v])
+            {
+              path.push_back (m_edgeOf[k]);
+              v = m_neighbor[k];
+              break;
+            }
+        }
+    }
+  return path;
+}
+
+size_t
+TopologyGenerator::FindDetourEdge (uint32_t from, uint32_t to) const
+{
+  std::vector<size_t> path = GetShortestPath (from, to);
+  // Each try is a BFS; a handful keeps this linear in the graph size.
+  const size_t maxTries = 16;
+  size_t middle = path.size () / 2;
+  for (size_t t = 0; t < std::min (path.size (), maxTries); ++t)
+    {
+      size_t i = t % 2 == 0 ? middle + t / 2 : middle - (t + 1) / 2;
+      if (i < path.size () && GetDistances (from, path[i])[to] != UNREACHABLE)
+        {
+          return path[i];
+        }
+    }
+  return m_edges.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,90 @@
+#ifndef TOPOLOGY_GENERATOR_H
+#define TOPOLOGY_GENERATOR_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \brief Router graphs for bGoal, built as an edge list plus adjacency.
+ *
+ * Kinds:
+ *  - grid: ceil(sqrt(n)) routers wide, each linked to its right and lower
+ *    neighbour
+ *  - ring: a ring with random chords added up to the average degree
+ *  - er: Erdos-Renyi G(n, p) with p = avgDegree / (n - 1), drawn by
+ *    geometric skipping (Batagelj and Brandes), so O(n + m) rather than
+ *    O(n^2)
+ *  - ba: Barabasi-Albert preferential attachment with avgDegree / 2 links
+ *    per new router
+ *
+ * Nodes are router indices 0 .. n-1. A generated graph is always
+ * connected: er joins its components with one extra link each. All kinds
+ * run in time linear in the number of links, and the graph queries below
+ * are breadth-first searches over the adjacency.
+ *
+ * The random kinds draw from their own stream of the ns-3 generator, so
+ * the graph follows RngSeed, RngRun and the stream number, and does not
+ * shift when other random variables are created first.
+ */
+class TopologyGenerator
+{
+public:
+  typedef std::pair<uint32_t, uint32_t> Edge;
+
+  /// True for the kinds above; "chain" is built by bGoal itself.
+  static bool IsKnown (const std::string &kind);
+
+  /**
+   * \param kind grid, ring, er or ba
+   * \param n number of routers
+   * \param avgDegree target average degree (ring, er, ba)
+   * \param stream random stream of ring, er and ba
+   */
+  TopologyGenerator (const std::string &kind, uint32_t n, double avgDegree, int64_t stream = 0);
+
+  const std::vector<Edge> &GetEdges (void) const;
+  uint32_t GetDegree (uint32_t node) const;
+
+  /**
+   * \brief Hop count from a node to every node, or UNREACHABLE.
+   * \param without index of an edge to leave out, or GetEdges().size()
+   */
+  std::vector<uint32_t> GetDistances (uint32_t from, size_t without) const;
+  /// The node farthest from a node, and its distance.
+  uint32_t GetFarthest (uint32_t from, uint32_t &distance) const;
+  /// Lower bound of the diameter by a double BFS sweep (exact on grids and trees).
+  uint32_t EstimateDiameter (void) const;
+  /// Edge indices of one shortest path.
+  std::vector<size_t> GetShortestPath (uint32_t from, uint32_t to) const;
+  /**
+   * \brief An edge on a shortest path whose loss leaves "to" reachable,
+   * tried from the middle of the path outwards; GetEdges().size() if none.
+   */
+  size_t FindDetourEdge (uint32_t from, uint32_t to) const;
+
+  static const uint32_t UNREACHABLE = 0xffffffff;
+
+private:
+  void Grid (void);
+  void Ring (double avgDegree);
+  void ErdosRenyi (double avgDegree);
+  void BarabasiAlbert (double avgDegree);
+  void Connect (void);
+  void BuildAdjacency (void);
+
+  uint32_t m_n;
+  Ptr<UniformRandomVariable> m_random;
+  std::vector<Edge> m_edges;
+  std::vector<uint32_t> m_offset;   // CSR: neighbours of v at m_offset[v] .. m_offset[v + 1]
+  std::vector<uint32_t> m_neighbor;
+  std::vector<uint32_t> m_edgeOf;   // edge index of each m_neighbor entry
+};
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_GENERATOR_H */
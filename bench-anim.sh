@@ -0,0 +1,28 @@
+#!/bin/sh
+# NetAnim file size and simulation wall time of the bGoal chain for each
+# --anim mode. Run from the ns-3 top-level directory with this repository
+# in scratch/:
+#   scratch/bench-anim.sh [amount] [modes ...]
+
+AMOUNT=${1:-500}
+shift 2> /dev/null
+MODES=${*:-"full off topology window sampled"}
+ARGS="--amount=$AMOUNT --printRoutingTables=false --showPings=false --capture=none"
+OUT=$(mktemp -d)
+XML=xmls/poi-B-project.xml
+
+./waf build > /dev/null || exit 1
+mkdir -p xmls
+
+printf "%-10s %-12s %-12s\n" anim run_s xml_kib
+for mode in $MODES
+do
+  rm -f "$XML"
+  ./waf --run "bGoal $ARGS --anim=$mode --resultFile=$OUT/r.txt" > "$OUT/run.log" 2>&1 \
+    || { cat "$OUT/run.log"; exit 1; }
+  T=$(sed -n 's/^runSeconds=//p' "$OUT/r.txt")
+  KIB=0
+  [ -f "$XML" ] && KIB=$(( $(wc -c < "$XML") / 1024 ))
+  printf "%-10s %-12s %-12s\n" "$mode" "$T" "$KIB"
+done
+rm -rf "$OUT"
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Stress test of the fault-schedule engine: generates FLAPS link flaps
+# (down, then up again) spread over the chain links of bGoal and
+# runs them. Run from the ns-3 top-level directory with this repository in
+# scratch/:
+#   scratch/bench-faults.sh [flaps] [amount]
+
+FLAPS=${1:-100000}
+AMOUNT=${2:-200}
+OUT=$(mktemp -d)
+SCHEDULE=$OUT/flaps.txt
+
+# Routers are node ids 2 .. AMOUNT+1; router i is chained to i+1. Flaps
+# start after RIP has converged and are 5 ms apart, each link staying down
+# for 2 ms.
+awk -v flaps="$FLAPS" -v amount="$AMOUNT" 'BEGIN {
+  srand (1);
+  for (k = 0; k < flaps; k++)
+    {
+      r = 2 + int (rand () * (amount - 1));
+      t = 30 + k * 0.005;
+      printf "%.3f down %d %d\n%.3f up %d %d\n", t, r, r + 1, t + 0.002, r, r + 1;
+    }
+}' > "$SCHEDULE"
+
+./waf build > /dev/null || exit 1
+./waf --run "bGoal --amount=$AMOUNT --printRoutingTables=false --showPings=false --capture=none --anim=off \
+  --faultSchedule=$SCHEDULE --resultFile=$OUT/r.txt" > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+grep '^INFO: Loaded' "$OUT/run.log"
+grep '^faultEvents=\|^runSeconds=\|^buildMs=' "$OUT/r.txt"
+rm -rf "$OUT"
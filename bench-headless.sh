@@ -0,0 +1,24 @@
+#!/bin/sh
+# Memory per router of the bGoal chain with and without --headless.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-headless.sh [amount ...]
+# Each size is built twice with --buildOnly, so the peak RSS covers the
+# topology only; the last column is what headless mode saves per router.
+
+AMOUNTS=${*:-"10000 100000 1000000"}
+
+./waf build > /dev/null || exit 1
+
+bytes_per_router ()
+{
+  ./waf --run "bGoal --amount=$1 --buildOnly=true --printRoutingTables=false --showPings=false $2" 2>&1 \
+    | sed -n 's/^INFO: Peak RSS after build [0-9]* kB, \([0-9.e+]*\) bytes\/router.*$/\1/p'
+}
+
+printf "%-10s %-14s %-14s %-14s\n" routers full_B headless_B saved_B
+for n in $AMOUNTS
+do
+  FULL=$(bytes_per_router "$n" "")
+  LEAN=$(bytes_per_router "$n" "--headless=true")
+  printf "%-10s %-14s %-14s %-14s\n" "$n" "$FULL" "$LEAN" "$(echo "$FULL - $LEAN" | bc -l | cut -d. -f1)"
+done
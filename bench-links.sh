@@ -0,0 +1,37 @@
+#!/bin/sh
+# Simulated events per second with CSMA versus point-to-point links, for
+# the aGoal graph and the bGoal chain. Run from the ns-3 top-level
+# directory with this repository in scratch/:
+#   scratch/bench-links.sh [amount ...]
+# bGoal runs stop on convergence, so both link types simulate the same
+# RIP story; the events column shows how much of the work was the CSMA
+# channel itself.
+
+AMOUNTS=${*:-"100 1000 10000"}
+ARGS="--printRoutingTables=false --showPings=false --capture=none --anim=off"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-8s %-10s %-6s %-12s %-12s %-10s\n" program routers link events events_per_s run_s
+for link in csma p2p
+do
+  ./waf --run "aGoal $ARGS --linkType=$link" > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+  sed -n 's/^INFO: \([0-9]*\) events in \([0-9.e+-]*\) s, \([0-9.e+-]*\) events\/s$/\1 \3 \2/p' "$OUT/run.log" \
+    | while read EVENTS RATE T
+      do
+        printf "%-8s %-10s %-6s %-12s %-12s %-10s\n" aGoal 7 "$link" "$EVENTS" "$RATE" "$T"
+      done
+done
+for n in $AMOUNTS
+do
+  for link in csma p2p
+  do
+    ./waf --run "bGoal --amount=$n $ARGS --stopOnConvergence=true --linkType=$link --resultFile=$OUT/r.txt" \
+      > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+    printf "%-8s %-10s %-6s %-12s %-12s %-10s\n" bGoal "$n" "$link" \
+      "$(sed -n 's/^events=//p' "$OUT/r.txt")" "$(sed -n 's/^eventsPerSecond=//p' "$OUT/r.txt")" \
+      "$(sed -n 's/^runSeconds=//p' "$OUT/r.txt")"
+  done
+done
+rm -rf "$OUT"
@@ -0,0 +1,37 @@
+#!/bin/sh
+# RIP route lookup with ns3::Rip's route list versus RipTrie's prefix trie.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-lookup.sh [amount ...]
+# First the per-lookup cost at 1k, 10k and 50k prefixes (lookup-bench),
+# then the run time of bGoal with either table. The bGoal runs use the
+# Barabasi-Albert topology, whose small diameter puts every link in every
+# table (about 2 * amount prefixes); a chain's tables stop at the 15-hop
+# RIP horizon whatever its length. UDP bulk traffic keeps the forwarding
+# path busy. Tables of 10k prefixes and more on every router are beyond
+# the memory of one machine, so the run-time amounts stay smaller.
+
+AMOUNTS=${*:-"500 1000 2500"}
+ARGS="--topology=ba --headless=true --printRoutingTables=false --showPings=false --traffic=udp --udpRate=10Mbps"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+./waf --run "lookup-bench --prefixes=1000,10000,50000" || exit 1
+echo
+
+printf "%-10s %-10s %-6s %-12s %-12s %-10s\n" routers prefixes table events run_s peak_rss_kb
+for n in $AMOUNTS
+do
+  for table in list trie
+  do
+    # No result file, so only RIP and the traffic are timed.
+    ./waf --run "bGoal --amount=$n $ARGS --ripTable=$table --trafficPrefix=$OUT/traffic" \
+      > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+    printf "%-10s %-10s %-6s %-12s %-12s %-10s\n" "$n" \
+      "$(($(sed -n 's/^INFO: .* graph with \([0-9]*\) links.*/\1/p' "$OUT/run.log") + 2))" "$table" \
+      "$(sed -n 's/^INFO: \([0-9]*\) events in .*/\1/p' "$OUT/run.log")" \
+      "$(sed -n 's/^INFO: [0-9]* events in \([0-9.e+-]*\) s.*/\1/p' "$OUT/run.log")" \
+      "$(sed -n 's/^INFO: [0-9]* events in .*peak RSS \([0-9]*\) kB/\1/p' "$OUT/run.log")"
+  done
+done
+rm -rf "$OUT"
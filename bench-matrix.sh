@@ -0,0 +1,35 @@
+#!/bin/sh
+# Setup time of bGoal's traffic matrix against its number of flows.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-matrix.sh [flows ...]
+# Each run attaches HOSTS hosts (default 500) at random routers of a
+# ROUTERS-router chain (default 200) and draws a gravity matrix of the
+# given number of flows with random host weights. The flows only run for
+# one second at a low total rate: the point is the setup cost, which
+# should grow linearly with the flows.
+
+FLOWS=${*:-"1000 10000 50000"}
+HOSTS=${HOSTS:-500}
+ROUTERS=${ROUTERS:-200}
+ARGS="--amount=$ROUTERS --headless=true --printRoutingTables=false --showPings=false --traffic=udp --trafficStart=10 --trafficStop=11 --trafficInterval=10"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-10s %-10s %-12s %-12s %-12s\n" hosts flows attach_ms flows_ms us_per_flow
+for f in $FLOWS
+do
+  # Router i of the chain is node i + 2.
+  awk -v hosts="$HOSTS" -v routers="$ROUTERS" -v flows="$f" 'BEGIN {
+    srand (1);
+    for (h = 0; h < hosts; h++)
+      printf "host h%d %d %.2f\n", h, 2 + int (rand () * routers), 0.1 + rand () * 10;
+    printf "matrix gravity %d 10Mbps\n", flows;
+  }' > "$OUT/matrix.txt"
+  ./waf --run "bGoal $ARGS --trafficMatrix=$OUT/matrix.txt --trafficPrefix=$OUT/traffic" \
+    > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+  ATTACH=$(sed -n 's/^INFO: Traffic matrix hosts attached in \([0-9.e+]*\) ms$/\1/p' "$OUT/run.log")
+  SETUP=$(sed -n 's/^INFO: Traffic matrix flows set up in \([0-9.e+]*\) ms$/\1/p' "$OUT/run.log")
+  printf "%-10s %-10s %-12s %-12s %-12s\n" "$HOSTS" "$f" "$ATTACH" "$SETUP" "$(echo "$SETUP * 1000 / $f" | bc -l | cut -c1-8)"
+done
+rm -rf "$OUT"
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Wall-clock speedup of the distributed bGoal chain against the sequential run.
+# Needs ns-3 configured with --enable-mpi. Run from the ns-3 top-level
+# directory with this repository in scratch/:
+#   scratch/bench-mpi.sh [amount] [ranks ...]
+
+AMOUNT=${1:-10000}
+shift 2> /dev/null
+RANKS=${*:-"2 4 8"}
+ARGS="--amount=$AMOUNT --printRoutingTables=false --showPings=false"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+run_seconds ()
+{
+  sed -n 's/^runSeconds=//p' "$1"
+}
+
+./waf --run "bGoal $ARGS --resultFile=$OUT/seq.txt" > "$OUT/seq.log" 2>&1 || { cat "$OUT/seq.log"; exit 1; }
+SEQ=$(run_seconds "$OUT/seq.txt")
+printf "%-8s %-12s %-8s\n" ranks run_s speedup
+printf "%-8s %-12s %-8s\n" 1 "$SEQ" 1.00
+
+for np in $RANKS
+do
+  ./waf --run bGoal --command-template="mpirun -np $np %s $ARGS --distributed=true --resultFile=$OUT/np$np.txt" \
+    > "$OUT/np$np.log" 2>&1 || { cat "$OUT/np$np.log"; exit 1; }
+  T=$(run_seconds "$OUT/np$np.txt")
+  printf "%-8s %-12s %-8s\n" "$np" "$T" "$(echo "$SEQ / $T" | bc -l | cut -c1-4)"
+done
+rm -rf "$OUT"
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Time of the RIP oracle check on the bGoal chain, per table check, and
+# what it found. Run from the ns-3 top-level directory with this repository
+# in scratch/:
+#   scratch/bench-oracle.sh [amount ...]
+# THREADS sets --oracleThreads (default: one per core). Each run checks the
+# tables before the failure (40s), just after it (50s) and at 90s.
+
+AMOUNTS=${*:-"1000 10000 50000"}
+THREADS=${THREADS:-0}
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-10s %-8s %-12s %-10s %-10s %-10s\n" routers time_s routes errors stale check_ms
+for n in $AMOUNTS
+do
+  ./waf --run "bGoal --amount=$n --headless=true --printRoutingTables=false --showPings=false \
+    --oracle=$OUT/oracle --oracleThreads=$THREADS" > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+  for report in "$OUT"/oracle-*s.txt
+  do
+    awk -F '=' -v n="$n" '
+      { v[$1] = $2 }
+      END { printf "%-10s %-8s %-12s %-10s %-10s %-10s\n", n, v["time_s"], v["routes"],
+              v["wrongMetric"] + v["wrongNextHop"] + v["stale"] + v["missing"], v["stale"], v["checkMs"] }' "$report"
+  done
+  rm -f "$OUT"/oracle-*s.txt
+done
+rm -rf "$OUT"
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Offline pcap analysis of a bGoal capture: pcap-analyzer on one thread
+# against all cores. Run from the ns-3 top-level directory with this
+# repository in scratch/:
+#   scratch/bench-pcap.sh [amount ...]
+# Each amount is simulated once with every device captured; the analyzer
+# then reads the capture twice, so the second pass may come from the page
+# cache. The built-in failure is at 40 s.
+
+AMOUNTS=${*:-"200 1000 2000"}
+ARGS="--printRoutingTables=false --showPings=false --capture=all --anim=off"
+OUT=$(mktemp -d)
+THREADS=$(nproc)
+
+./waf build > /dev/null || exit 1
+
+printf "%-8s %-10s %-8s %-8s %-10s %-8s\n" amount pcap_mb files threads read_s gb_s
+for n in $AMOUNTS
+do
+  rm -f rip-poi-B-project*
+  ./waf --run "bGoal --amount=$n $ARGS --resultFile=$OUT/r.txt" > "$OUT/run.log" 2>&1 \
+    || { cat "$OUT/run.log"; exit 1; }
+  MB=$(du -cm rip-poi-B-project*.pcap | tail -1 | cut -f1)
+  FILES=$(ls rip-poi-B-project*.pcap | wc -l)
+  for t in 1 "$THREADS"
+  do
+    ./waf --run "pcap-analyzer --dir=. --teardowns=40 --threads=$t --out=$OUT/a" > "$OUT/a.log" 2>&1 \
+      || { cat "$OUT/a.log"; exit 1; }
+    printf "%-8s %-10s %-8s %-8s %-10s %-8s\n" "$n" "$MB" "$FILES" "$t" \
+      "$(sed -n 's/^INFO: Read .* in \([0-9.e+-]*\) s .*/\1/p' "$OUT/a.log")" \
+      "$(sed -n 's/^INFO: Read .*(\([0-9.e+-]*\) GB\/s.*/\1/p' "$OUT/a.log")"
+  done
+done
+echo
+cat "$OUT/a-teardowns.csv"
+rm -f rip-poi-B-project*
+rm -rf "$OUT"
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Scaling of the bGoal chain: build time, simulated events per second and
+# peak RSS versus router count, for every split horizon strategy. Runs go
+# one at a time so that timings and memory are not disturbed by parallel
+# runs. Run from the ns-3 top-level directory with this repository in
+# scratch/:
+#   scratch/bench-scaling.sh [outDir] [baseline.tsv]
+# The report is <outDir>/scaling.tsv. With a baseline (an earlier
+# scaling.tsv), any size/strategy whose runSeconds or peakRssKb grew by more
+# than TOLERANCE percent (default 20) is listed and the script exits 1.
+# AMOUNTS overrides the router counts, e.g. AMOUNTS="10 100" for a quick
+# check. Baselines written before the runs went without a result file and
+# table watcher timed those too; regenerate them.
+
+OUT=${1:-scaling-out}
+BASELINE=$2
+AMOUNTS=${AMOUNTS:-"10 100 1000 10000 100000"}
+TOLERANCE=${TOLERANCE:-20}
+ARGS="--printRoutingTables=false --showPings=false --capture=none --anim=off"
+
+./waf build > /dev/null || exit 1
+mkdir -p "$OUT" || exit 1
+
+printf "amount\tsplitHorizonStrategy\tbuildMs\tevents\teventsPerSecond\tpeakRssKb\trunSeconds\n" > "$OUT/scaling.tsv"
+for n in $(echo "$AMOUNTS" | tr ',' ' ')
+do
+  for strategy in NoSplitHorizon SplitHorizon PoisonReverse
+  do
+    # No result file and no table watcher, so only building and RIP are
+    # timed; the numbers come from bGoal's INFO lines.
+    LOG="$OUT/bGoal-$n-$strategy.log"
+    ./waf --run "bGoal --amount=$n --splitHorizonStrategy=$strategy $ARGS" \
+      > "$LOG" 2>&1 || { cat "$LOG"; exit 1; }
+    printf "%s\t%s\t%s\t%s\t%s\t%s\t%s\n" "$n" "$strategy" \
+      "$(sed -n 's/^INFO: Topology of .* built in \([0-9.e+-]*\) ms.*/\1/p' "$LOG")" \
+      "$(sed -n 's/^INFO: \([0-9]*\) events in .*/\1/p' "$LOG")" \
+      "$(sed -n 's/^INFO: [0-9]* events in .* s, \([0-9.e+-]*\) events\/s.*/\1/p' "$LOG")" \
+      "$(sed -n 's/^INFO: [0-9]* events in .*peak RSS \([0-9]*\) kB/\1/p' "$LOG")" \
+      "$(sed -n 's/^INFO: [0-9]* events in \([0-9.e+-]*\) s.*/\1/p' "$LOG")" >> "$OUT/scaling.tsv"
+  done
+done
+column -t "$OUT/scaling.tsv"
+
+[ -n "$BASELINE" ] || exit 0
+awk -F '\t' -v tol="$TOLERANCE" '
+  FNR == 1 { next }
+  NR == FNR { run[$1 " " $2] = $7; rss[$1 " " $2] = $6; next }
+  ($1 " " $2) in run {
+    k = $1 " " $2
+    if (run[k] > 0 && $7 > run[k] * (1 + tol / 100))
+      { printf "REGRESSION %s runSeconds %s -> %s\n", k, run[k], $7; bad = 1 }
+    if (rss[k] > 0 && $6 > rss[k] * (1 + tol / 100))
+      { printf "REGRESSION %s peakRssKb %s -> %s\n", k, rss[k], $6; bad = 1 }
+  }
+  END { exit bad }' "$BASELINE" "$OUT/scaling.tsv"
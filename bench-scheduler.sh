@@ -0,0 +1,36 @@
+#!/bin/sh
+# bGoal chain run time with each ns-3 event scheduler.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-scheduler.sh [amount ...]
+# The chain's events are mostly RIP timers: a periodic update, a route
+# timeout and garbage-collection timer per route, and triggered-update
+# cooldowns, so the queue holds many events per router, most of them far
+# in the future and many cancelled before they fire. A first run with
+# --progress shows the queue depth; the timed runs go without it, since
+# counting the pending events costs a virtual call per queue operation,
+# and without a result file, whose counters see every router packet.
+
+AMOUNTS=${*:-"200 1000 3000"}
+SCHEDULERS=${SCHEDULERS:-"map heap list calendar priority-queue"}
+ARGS="--headless=true --printRoutingTables=false --showPings=false"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-10s %-16s %-12s %-12s %-14s %-12s\n" routers scheduler events run_s events_per_s peak_pending
+for n in $AMOUNTS
+do
+  ./waf --run "bGoal --amount=$n $ARGS --progress=$OUT/progress.csv --progressInterval=5" \
+    > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+  PENDING=$(tail -n +2 "$OUT/progress.csv" | cut -d, -f5 | sort -n | tail -1)
+  for s in $SCHEDULERS
+  do
+    ./waf --run "bGoal --amount=$n $ARGS --scheduler=$s" \
+      > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+    printf "%-10s %-16s %-12s %-12s %-14s %-12s\n" "$n" "$s" \
+      "$(sed -n 's/^INFO: \([0-9]*\) events in .*/\1/p' "$OUT/run.log")" \
+      "$(sed -n 's/^INFO: [0-9]* events in \([0-9.e+-]*\) s.*/\1/p' "$OUT/run.log")" \
+      "$(sed -n 's/^INFO: [0-9]* events in .* s, \([0-9.e+-]*\) events\/s.*/\1/p' "$OUT/run.log")" "$PENDING"
+  done
+done
+rm -rf "$OUT"
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Topology build time of the bGoal chain versus router count.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-setup.sh [amount ...]
+# Each size runs in its own process with --buildOnly, so the numbers only
+# cover node creation, CSMA install, stack install and link addressing.
+
+AMOUNTS=${*:-"1000 2000 5000 10000 20000 50000"}
+
+./waf build > /dev/null || exit 1
+printf "%-10s %-12s %-12s\n" routers build_ms us_per_router
+for n in $AMOUNTS
+do
+  ./waf --run "bGoal --amount=$n --buildOnly=true --printRoutingTables=false --showPings=false" 2>&1 \
+    | sed -n 's/^INFO: Topology of \([0-9]*\) routers.* built in \([0-9.e+]*\) ms, \([0-9.e+]*\) us\/router$/\1 \2 \3/p' \
+    | while read routers ms per
+      do
+        printf "%-10s %-12s %-12s\n" "$routers" "$ms" "$per"
+      done
+done
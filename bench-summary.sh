@@ -0,0 +1,36 @@
+#!/bin/sh
+# RIP table size and update traffic of bGoal's chain with a flat address
+# plan, with links planned by area, and with areas advertised as summaries.
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-summary.sh [amount ...]
+# AREA sets the routers per area (default 8). All three runs use RipTrie,
+# so only the address plan and the summaries differ. A router's table is
+# bounded by the 15-hop RIP horizon, so the flat tables stop growing with
+# the chain; summaries cut them to the links of the router's own area plus
+# one route per area within reach.
+
+AMOUNTS=${*:-"200 500 1000"}
+AREA=${AREA:-8}
+ARGS="--headless=true --printRoutingTables=false --showPings=false --ripTable=trie"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-10s %-16s %-12s %-12s %-12s %-12s\n" routers plan routes routes/rtr rip_packets rip_bytes
+for n in $AMOUNTS
+do
+  for plan in flat areas summary
+  do
+    case $plan in
+      flat) PLAN="" ;;
+      areas) PLAN="--areaSize=$AREA" ;;
+      summary) PLAN="--areaSize=$AREA --summarize=true" ;;
+    esac
+    ./waf --run "bGoal --amount=$n $ARGS $PLAN --resultFile=$OUT/r.txt" \
+      > "$OUT/run.log" 2>&1 || { cat "$OUT/run.log"; exit 1; }
+    printf "%-10s %-16s %-12s %-12s %-12s %-12s\n" "$n" "$plan" \
+      "$(sed -n 's/^ripRoutes=//p' "$OUT/r.txt")" "$(sed -n 's/^ripRoutesPerRouter=//p' "$OUT/r.txt")" \
+      "$(sed -n 's/^ripPackets=//p' "$OUT/r.txt")" "$(sed -n 's/^ripBytes=//p' "$OUT/r.txt")"
+  done
+done
+rm -rf "$OUT"
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Simulation wall time of the bGoal chain with the default synchronous
+# trace files against the background trace writer (--asyncTraces).
+# Run from the ns-3 top-level directory with this repository in scratch/:
+#   scratch/bench-traces.sh [amount] [repetitions]
+
+AMOUNT=${1:-2000}
+REPS=${2:-3}
+ARGS="--amount=$AMOUNT --printRoutingTables=false --showPings=false"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+printf "%-8s %-4s %-12s %-12s\n" traces rep run_s trace_mb
+for rep in $(seq 1 "$REPS")
+do
+  for async in false true
+  do
+    rm -f rip-poi-B-project*
+    ./waf --run "bGoal $ARGS --asyncTraces=$async --resultFile=$OUT/r.txt" > "$OUT/run.log" 2>&1 \
+      || { cat "$OUT/run.log"; exit 1; }
+    T=$(sed -n 's/^runSeconds=//p' "$OUT/r.txt")
+    MB=$(du -cm rip-poi-B-project* | tail -1 | cut -f1)
+    printf "%-8s %-4s %-12s %-12s\n" "$([ $async = true ] && echo async || echo sync)" "$rep" "$T" "$MB"
+  done
+done
+rm -f rip-poi-B-project*
+rm -rf "$OUT"
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Wall time of a cold bGoal run against one warm-started from a RIP
+# checkpoint of the same topology. Run from the ns-3 top-level directory
+# with this repository in scratch/:
+#   scratch/bench-warm-start.sh [amount]
+
+AMOUNT=${1:-5000}
+ARGS="--amount=$AMOUNT --printRoutingTables=false --showPings=false --capture=none --anim=off --stopOnConvergence=true"
+OUT=$(mktemp -d)
+
+./waf build > /dev/null || exit 1
+
+# The cold run also writes the checkpoint, just before its failure at 40 s.
+./waf --run "bGoal $ARGS --ripCheckpoint=$OUT/converged.snap --resultFile=$OUT/cold.txt" > "$OUT/cold.log" 2>&1 \
+  || { cat "$OUT/cold.log"; exit 1; }
+./waf --run "bGoal $ARGS --warmStart=$OUT/converged.snap --resultFile=$OUT/warm.txt" > "$OUT/warm.log" 2>&1 \
+  || { cat "$OUT/warm.log"; exit 1; }
+grep '^INFO: Warm start' "$OUT/warm.log"
+
+printf "%-6s %-14s %-12s %-12s %-14s\n" run simulated_s run_s events convergence_s
+for run in cold warm
+do
+  printf "%-6s %-14s %-12s %-12s %-14s\n" $run \
+    "$(sed -n 's/^simulatedSeconds=//p' "$OUT/$run.txt")" "$(sed -n 's/^runSeconds=//p' "$OUT/$run.txt")" \
+    "$(sed -n 's/^events=//p' "$OUT/$run.txt")" "$(sed -n 's/^convergenceSeconds=//p' "$OUT/$run.txt")"
+done
+rm -rf "$OUT"
@@ -0,0 +1,274 @@
+#ifndef BULK_TRAFFIC_H
+#define BULK_TRAFFIC_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief TCP bulk and UDP constant-rate flows, measured with FlowMonitor.
+ *
+ * Mode "tcp" adds a BulkSend flow per AddFlows call, "udp" an OnOff flow at
+ * a fixed rate, "both" one of each. FlowMonitor is installed on the flow
+ * endpoints only; every interval its per-flow counters are sampled and the
+ * differences kept in memory, so a throughput dip while RIP reconverges
+ * shows up in the timeline.
+ *
+ * Write(prefix) produces:
+ *
+ *     <prefix>-flows.csv     whole-run totals per FlowMonitor flow
+ *     <prefix>-timeline.csv  per interval and flow: rx_mbps, delay, lost
+ *
+ * plus one INFO line per configured flow with the goodput seen by its sink.
+ */
+class BulkTraffic
+{
+public:
+  /**
+   * \param mode none, tcp, udp or both
+   * \param udpRate sending rate of the UDP flows
+   * \param interval timeline sampling interval
+   */
+  BulkTraffic (const std::string &mode, DataRate udpRate, Time interval);
+
+  bool IsEnabled (void) const;
+  /// Add the flows of the mode from one node to another.
+  void AddFlows (Ptr<Node> from, Ptr<Node> to, Time start, Time stop);
+  /// As above, with a UDP rate of its own.
+  void AddFlows (Ptr<Node> from, Ptr<Node> to, Time start, Time stop, DataRate udpRate);
+  /// Install FlowMonitor on the endpoints; call after every AddFlows.
+  void Start (void);
+  /// Call after Simulator::Run and before Simulator::Destroy.
+  void Write (const std::string &prefix);
+  /// Sum of all sinks' received bytes over their active time, in Mbit/s.
+  double GetGoodputMbps (void) const;
+
+private:
+  struct Flow
+  {
+    std::string name;
+    Ptr<PacketSink> sink;
+    Time start;
+    Time stop;
+  };
+
+  struct Sample
+  {
+    double time;
+    FlowId flow;
+    double rxMbps;
+    double delayMs;
+    uint32_t lost;
+  };
+
+  void Install (const std::string &name, Ptr<Node> from, Ptr<Node> to, bool tcp, DataRate udpRate, Time start, Time stop);
+  void TakeSample (void);
+
+  bool m_tcp;
+  bool m_udp;
+  DataRate m_udpRate;
+  Time m_interval;
+  std::unordered_map<uint32_t, uint16_t> m_nextPort; // by destination node
+  NodeContainer m_endpoints;
+  std::set<uint32_t> m_endpointIds; // a node must get one flow probe only
+  std::vector<Flow> m_flows;
+  FlowMonitorHelper m_flowHelper;
+  Ptr<FlowMonitor> m_monitor;
+  std::map<FlowId, FlowMonitor::FlowStats> m_last;
+  std::vector<Sample> m_timeline;
+};
+
+inline
+BulkTraffic::BulkTraffic (const std::string &mode, DataRate udpRate, Time interval)
+  : m_tcp (mode == "tcp" || mode == "both"),
+    m_udp (mode == "udp" || mode == "both"),
+    m_udpRate (udpRate),
+    m_interval (interval)
+{
+  NS_ABORT_MSG_UNLESS (mode == "none" || m_tcp || m_udp, "Unknown traffic mode \"" << mode << "\" (none, tcp, udp, both)");
+}
+
+inline bool
+BulkTraffic::IsEnabled (void) const
+{
+  return m_tcp || m_udp;
+}
+
+inline void
+BulkTraffic::AddFlows (Ptr<Node> from, Ptr<Node> to, Time start, Time stop)
+{
+  AddFlows (from, to, start, stop, m_udpRate);
+}
+
+inline void
+BulkTraffic::AddFlows (Ptr<Node> from, Ptr<Node> to, Time start, Time stop, DataRate udpRate)
+{
+  std::ostringstream name;
+  name << from->GetId () << "->" << to->GetId ();
+  if (m_tcp)
+    {
+      Install ("tcp " + name.str (), from, to, true, udpRate, start, stop);
+    }
+  if (m_udp)
+    {
+      Install ("udp " + name.str (), from, to, false, udpRate, start, stop);
+    }
+}
+
+inline void
+BulkTraffic::Install (const std::string &name, Ptr<Node> from, Ptr<Node> to, bool tcp, DataRate udpRate, Time start, Time stop)
+{
+  // Ports only need to differ per destination, which leaves room for many
+  // more flows than one port range.
+  std::unordered_map<uint32_t, uint16_t>::iterator next = m_nextPort.insert (std::make_pair (to->GetId (), uint16_t (5000))).first;
+  NS_ABORT_MSG_IF (next->second == 0, "BulkTraffic: out of ports on node " << to->GetId ());
+  uint16_t port = next->second++;
+  std::string factory = tcp ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory";
+  Address remote (InetSocketAddress (to->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal (), port));
+
+  ApplicationContainer source;
+  if (tcp)
+    {
+      BulkSendHelper bulk (factory, remote);
+      bulk.SetAttribute ("MaxBytes", UintegerValue (0));
+      source = bulk.Install (from);
+    }
+  else
+    {
+      OnOffHelper onOff (factory, remote);
+      onOff.SetConstantRate (udpRate, 1024);
+      source = onOff.Install (from);
+    }
+  source.Start (start);
+  source.Stop (stop);
+
+  PacketSinkHelper sinkHelper (factory, InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sink = sinkHelper.Install (to);
+  sink.Start (start);
+  sink.Stop (stop);
+
+  Flow flow;
+  flow.name = name;
+  flow.sink = DynamicCast<PacketSink> (sink.Get (0));
+  flow.start = start;
+  flow.stop = stop;
+  m_flows.push_back (flow);
+  if (m_endpointIds.insert (from->GetId ()).second)
+    {
+      m_endpoints.Add (from);
+    }
+  if (m_endpointIds.insert (to->GetId ()).second)
+    {
+      m_endpoints.Add (to);
+    }
+}
+
+inline void
+BulkTraffic::Start (void)
+{
+  if (m_flows.empty ())
+    {
+      return;
+    }
+  m_monitor = m_flowHelper.Install (m_endpoints);
+  Simulator::Schedule (m_interval, &BulkTraffic::TakeSample, this);
+}
+
+inline void
+BulkTraffic::TakeSample (void)
+{
+  m_monitor->CheckForLostPackets ();
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+    {
+      FlowMonitor::FlowStats &last = m_last[it->first];
+      Sample sample;
+      sample.time = Simulator::Now ().GetSeconds ();
+      sample.flow = it->first;
+      sample.rxMbps = (it->second.rxBytes - last.rxBytes) * 8.0 / m_interval.GetSeconds () / 1e6;
+      uint32_t rxPackets = it->second.rxPackets - last.rxPackets;
+      sample.delayMs = rxPackets == 0 ? 0.0 : (it->second.delaySum - last.delaySum).GetSeconds () * 1000.0 / rxPackets;
+      sample.lost = it->second.lostPackets - last.lostPackets;
+      m_timeline.push_back (sample);
+      last = it->second;
+    }
+  Simulator::Schedule (m_interval, &BulkTraffic::TakeSample, this);
+}
+
+inline void
+BulkTraffic::Write (const std::string &prefix)
+{
+  if (m_flows.empty ())
+    {
+      return;
+    }
+  m_monitor->CheckForLostPackets ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (m_flowHelper.GetClassifier ());
+
+  std::ofstream flows ((prefix + "-flows.csv").c_str ());
+  NS_ABORT_MSG_UNLESS (flows, "Cannot write " << prefix << "-flows.csv");
+  flows << "flow,protocol,source,destination,tx_packets,rx_packets,lost_packets,rx_mbps,delay_ms,jitter_ms\n";
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+    {
+      const FlowMonitor::FlowStats &s = it->second;
+      Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (it->first);
+      double active = (s.timeLastRxPacket - s.timeFirstTxPacket).GetSeconds ();
+      flows << it->first << "," << (t.protocol == 6 ? "tcp" : "udp") << ","
+            << t.sourceAddress << ":" << t.sourcePort << "," << t.destinationAddress << ":" << t.destinationPort << ","
+            << s.txPackets << "," << s.rxPackets << "," << s.lostPackets << ","
+            << (active > 0 ? s.rxBytes * 8.0 / active / 1e6 : 0.0) << ","
+            << (s.rxPackets > 0 ? s.delaySum.GetSeconds () * 1000.0 / s.rxPackets : 0.0) << ","
+            << (s.rxPackets > 1 ? s.jitterSum.GetSeconds () * 1000.0 / (s.rxPackets - 1) : 0.0) << "\n";
+    }
+
+  std::ofstream timeline ((prefix + "-timeline.csv").c_str ());
+  NS_ABORT_MSG_UNLESS (timeline, "Cannot write " << prefix << "-timeline.csv");
+  timeline << "time_s,flow,rx_mbps,delay_ms,lost_packets\n";
+  for (size_t i = 0; i < m_timeline.size (); ++i)
+    {
+      const Sample &s = m_timeline[i];
+      timeline << s.time << "," << s.flow << "," << s.rxMbps << "," << s.delayMs << "," << s.lost << "\n";
+    }
+
+  for (size_t i = 0; i < m_flows.size (); ++i)
+    {
+      const Flow &f = m_flows[i];
+      double seconds = (std::min (f.stop, Simulator::Now ()) - f.start).GetSeconds ();
+      std::cout<<"INFO: Flow "<<f.name<<" goodput "<<(seconds > 0 ? f.sink->GetTotalRx () * 8.0 / seconds / 1e6 : 0.0)
+               <<" Mbit/s ("<<f.sink->GetTotalRx ()<<" bytes)\n";
+    }
+  std::cout<<"INFO: Flow statistics written to "<<prefix<<"-flows.csv and "<<prefix<<"-timeline.csv\n";
+}
+
+inline double
+BulkTraffic::GetGoodputMbps (void) const
+{
+  double mbps = 0;
+  for (size_t i = 0; i < m_flows.size (); ++i)
+    {
+      const Flow &f = m_flows[i];
+      double seconds = (std::min (f.stop, Simulator::Now ()) - f.start).GetSeconds ();
+      if (seconds > 0)
+        {
+          mbps += f.sink->GetTotalRx () * 8.0 / seconds / 1e6;
+        }
+    }
+  return mbps;
+}
+
+} // namespace ns3
+
+#endif /* BULK_TRAFFIC_H */
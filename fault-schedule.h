@@ -0,0 +1,364 @@
+#ifndef FAULT_SCHEDULE_H
+#define FAULT_SCHEDULE_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Link failures, link restores and node moves, from a file or added
+ * in code, applied at their times during the simulation.
+ *
+ * Text form, one event per line, '#' starts a comment:
+ *
+ *     <seconds> down <nodeA> <nodeB>
+ *     <seconds> up <nodeA> <nodeB>
+ *     <seconds> move <node> <x> <y> [<z>]
+ *
+ * Times are in seconds and may not be negative. A node is a name known to
+ * the node lookup (ns-3 Names by default) or a node id. "down" and "up"
+ * take the interfaces of both ends of the link between the two nodes down
+ * or up; the interfaces are found in an index of every (node, neighbour)
+ * pair built once from the channels, so resolving an event does not
+ * depend on how many links there are. "move" sets the position of the
+ * node's mobility model.
+ *
+ * Start() sorts the events and keeps a single simulator event pending at a
+ * time, which runs every event of one timestamp and schedules the next
+ * batch, so large schedules do not fill the event queue. Link-changed
+ * callbacks run after each "down" and "up", for observers that do not see
+ * interface changes themselves.
+ */
+class FaultSchedule
+{
+public:
+  typedef Callback<Ptr<Node>, const std::string &> NodeLookup;
+  /// Called with the node id of each end of a link that went down or up.
+  typedef Callback<void, uint32_t> LinkChangedCallback;
+
+  FaultSchedule ();
+
+  /// Resolve node names with this instead of ns-3 Names.
+  void SetNodeLookup (NodeLookup lookup);
+  void AddLinkChangedCallback (LinkChangedCallback cb);
+
+  /// Load a schedule file; its times are moved earlier by shift.
+  void Load (const std::string &path, Time shift = Seconds (0));
+  void AddLinkDown (Time at, Ptr<Node> a, Ptr<Node> b);
+  void AddLinkUp (Time at, Ptr<Node> a, Ptr<Node> b);
+  void AddMove (Time at, Ptr<Node> node, Vector position);
+
+  /// Schedule the events; call once, after every Add and Load.
+  void Start (void);
+
+  /// The distinct times at which something happens, sorted.
+  std::vector<Time> GetTimes (void) const;
+  uint64_t GetNEvents (void) const;
+  uint64_t GetNApplied (void) const;
+
+private:
+  enum Type
+  {
+    DOWN,
+    UP,
+    MOVE
+  };
+
+  struct Event
+  {
+    Time at;
+    Type type;
+    uint32_t nodeA;
+    uint32_t nodeB;
+    uint32_t interfaceA;
+    uint32_t interfaceB;
+    Vector position;
+  };
+
+  static bool Earlier (const Event &x, const Event &y);
+  static uint64_t PairKey (uint32_t a, uint32_t b);
+  void BuildIndex (void);
+  void AddLink (Time at, Type type, Ptr<Node> a, Ptr<Node> b);
+  Ptr<Node> Resolve (const std::string &name, uint64_t lineNo) const;
+  void RunBatch (void);
+
+  NodeLookup m_lookup;
+  std::vector<LinkChangedCallback> m_linkChanged;
+  bool m_indexed;
+  // (node, neighbour) -> interface of node, interface of neighbour
+  std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t> > m_links;
+  std::vector<Event> m_events;
+  size_t m_next;
+  uint64_t m_applied;
+};
+
+inline
+FaultSchedule::FaultSchedule ()
+  : m_indexed (false),
+    m_next (0),
+    m_applied (0)
+{
+}
+
+inline void
+FaultSchedule::SetNodeLookup (NodeLookup lookup)
+{
+  m_lookup = lookup;
+}
+
+inline void
+FaultSchedule::AddLinkChangedCallback (LinkChangedCallback cb)
+{
+  m_linkChanged.push_back (cb);
+}
+
+inline uint64_t
+FaultSchedule::PairKey (uint32_t a, uint32_t b)
+{
+  return (uint64_t (a) << 32) | b;
+}
+
+inline void
+FaultSchedule::BuildIndex (void)
+{
+  m_indexed = true;
+  for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+    {
+      Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4> ();
+      if (ipv4 == 0)
+        {
+          continue;
+        }
+      for (uint32_t i = 1; i < ipv4->GetNInterfaces (); ++i)
+        {
+          Ptr<NetDevice> device = ipv4->GetNetDevice (i);
+          Ptr<Channel> channel = device->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          for (uint32_t d = 0; d < channel->GetNDevices (); ++d)
+            {
+              Ptr<NetDevice> peerDevice = channel->GetDevice (d);
+              Ptr<Ipv4> peerIpv4 = peerDevice->GetNode ()->GetObject<Ipv4> ();
+              if (peerDevice == device || peerIpv4 == 0)
+                {
+                  continue;
+                }
+              int32_t peerInterface = peerIpv4->GetInterfaceForDevice (peerDevice);
+              if (peerInterface >= 0)
+                {
+                  // The first link between two nodes wins.
+                  m_links.insert (std::make_pair (PairKey ((*it)->GetId (), peerDevice->GetNode ()->GetId ()),
+                                                  std::make_pair (i, uint32_t (peerInterface))));
+                }
+            }
+        }
+    }
+}
+
+inline void
+FaultSchedule::AddLink (Time at, Type type, Ptr<Node> a, Ptr<Node> b)
+{
+  if (!m_indexed)
+    {
+      BuildIndex ();
+    }
+  std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t> >::const_iterator it = m_links.find (PairKey (a->GetId (), b->GetId ()));
+  NS_ABORT_MSG_IF (it == m_links.end (), "FaultSchedule: no link between nodes " << a->GetId () << " and " << b->GetId ());
+  Event event;
+  event.at = at;
+  event.type = type;
+  event.nodeA = a->GetId ();
+  event.nodeB = b->GetId ();
+  event.interfaceA = it->second.first;
+  event.interfaceB = it->second.second;
+  m_events.push_back (event);
+}
+
+inline void
+FaultSchedule::AddLinkDown (Time at, Ptr<Node> a, Ptr<Node> b)
+{
+  AddLink (at, DOWN, a, b);
+}
+
+inline void
+FaultSchedule::AddLinkUp (Time at, Ptr<Node> a, Ptr<Node> b)
+{
+  AddLink (at, UP, a, b);
+}
+
+inline void
+FaultSchedule::AddMove (Time at, Ptr<Node> node, Vector position)
+{
+  NS_ABORT_MSG_IF (node->GetObject<MobilityModel> () == 0, "FaultSchedule: node " << node->GetId () << " has no mobility model to move");
+  Event event;
+  event.at = at;
+  event.type = MOVE;
+  event.nodeA = node->GetId ();
+  event.nodeB = 0;
+  event.interfaceA = 0;
+  event.interfaceB = 0;
+  event.position = position;
+  m_events.push_back (event);
+}
+
+inline Ptr<Node>
+FaultSchedule::Resolve (const std::string &name, uint64_t lineNo) const
+{
+  Ptr<Node> node = m_lookup.IsNull () ? Names::Find<Node> (name) : m_lookup (name);
+  if (node == 0 && !name.empty () && name.find_first_not_of ("0123456789") == std::string::npos
+      && std::strtoul (name.c_str (), 0, 10) < NodeList::GetNNodes ())
+    {
+      node = NodeList::GetNode (std::strtoul (name.c_str (), 0, 10));
+    }
+  NS_ABORT_MSG_IF (node == 0, "Fault schedule line " << lineNo << ": unknown node \"" << name << "\"");
+  return node;
+}
+
+inline void
+FaultSchedule::Load (const std::string &path, Time shift)
+{
+  std::ifstream is (path.c_str ());
+  NS_ABORT_MSG_UNLESS (is, "Cannot open fault schedule " << path);
+  std::string line;
+  uint64_t lineNo = 0;
+  while (std::getline (is, line))
+    {
+      ++lineNo;
+      line = line.substr (0, line.find ('#'));
+      std::istringstream ls (line);
+      std::vector<std::string> tok;
+      std::string t;
+      while (ls >> t)
+        {
+          tok.push_back (t);
+        }
+      if (tok.empty ())
+        {
+          continue;
+        }
+      NS_ABORT_MSG_IF (tok.size () < 2, "Fault schedule line " << lineNo << ": <seconds> <down|up|move> ...");
+      char *end = 0;
+      double seconds = std::strtod (tok[0].c_str (), &end);
+      NS_ABORT_MSG_IF (*end != '\0' || !(seconds >= 0), "Fault schedule line " << lineNo << ": bad time \"" << tok[0]
+                       << "\" (seconds, not negative)");
+      Time at = Seconds (seconds) - shift;
+      NS_ABORT_MSG_IF (at.IsStrictlyNegative (), "Fault schedule line " << lineNo << ": " << tok[0]
+                       << " s is before 0 s once moved " << shift.GetSeconds () << " s earlier");
+      if (tok[1] == "down" || tok[1] == "up")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 4, "Fault schedule line " << lineNo << ": <seconds> " << tok[1] << " <nodeA> <nodeB>");
+          AddLink (at, tok[1] == "down" ? DOWN : UP, Resolve (tok[2], lineNo), Resolve (tok[3], lineNo));
+        }
+      else if (tok[1] == "move")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 5 || tok.size () == 6, "Fault schedule line " << lineNo << ": <seconds> move <node> <x> <y> [<z>]");
+          Vector position (std::atof (tok[3].c_str ()), std::atof (tok[4].c_str ()),
+                           tok.size () == 6 ? std::atof (tok[5].c_str ()) : 0.0);
+          AddMove (at, Resolve (tok[2], lineNo), position);
+        }
+      else
+        {
+          NS_ABORT_MSG ("Fault schedule line " << lineNo << ": unknown event \"" << tok[1] << "\"");
+        }
+    }
+  std::cout<<"INFO: Loaded "<<m_events.size ()<<" fault events from "<<path<<"\n";
+}
+
+inline bool
+FaultSchedule::Earlier (const Event &x, const Event &y)
+{
+  return x.at < y.at;
+}
+
+inline void
+FaultSchedule::Start (void)
+{
+  // Stable, so events of one timestamp keep the order they were given in.
+  std::stable_sort (m_events.begin (), m_events.end (), &FaultSchedule::Earlier);
+  m_next = 0;
+  if (!m_events.empty ())
+    {
+      Simulator::Schedule (m_events[0].at, &FaultSchedule::RunBatch, this);
+    }
+}
+
+inline void
+FaultSchedule::RunBatch (void)
+{
+  Time now = Simulator::Now ();
+  for (; m_next < m_events.size () && m_events[m_next].at <= now; ++m_next)
+    {
+      const Event &event = m_events[m_next];
+      Ptr<Node> a = NodeList::GetNode (event.nodeA);
+      if (event.type == MOVE)
+        {
+          a->GetObject<MobilityModel> ()->SetPosition (event.position);
+        }
+      else
+        {
+          Ptr<Ipv4> ipv4A = a->GetObject<Ipv4> ();
+          Ptr<Ipv4> ipv4B = NodeList::GetNode (event.nodeB)->GetObject<Ipv4> ();
+          if (event.type == DOWN)
+            {
+              ipv4A->SetDown (event.interfaceA);
+              ipv4B->SetDown (event.interfaceB);
+            }
+          else
+            {
+              ipv4A->SetUp (event.interfaceA);
+              ipv4B->SetUp (event.interfaceB);
+            }
+          for (size_t i = 0; i < m_linkChanged.size (); ++i)
+            {
+              m_linkChanged[i] (event.nodeA);
+              m_linkChanged[i] (event.nodeB);
+            }
+        }
+      ++m_applied;
+    }
+  if (m_next < m_events.size ())
+    {
+      Simulator::Schedule (m_events[m_next].at - now, &FaultSchedule::RunBatch, this);
+    }
+}
+
+inline std::vector<Time>
+FaultSchedule::GetTimes (void) const
+{
+  std::vector<Time> times;
+  for (size_t i = 0; i < m_events.size (); ++i)
+    {
+      times.push_back (m_events[i].at);
+    }
+  std::sort (times.begin (), times.end ());
+  times.erase (std::unique (times.begin (), times.end ()), times.end ());
+  return times;
+}
+
+inline uint64_t
+FaultSchedule::GetNEvents (void) const
+{
+  return m_events.size ();
+}
+
+inline uint64_t
+FaultSchedule::GetNApplied (void) const
+{
+  return m_applied;
+}
+
+} // namespace ns3
+
+#endif /* FAULT_SCHEDULE_H */
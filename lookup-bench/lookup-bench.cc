@@ -0,0 +1,214 @@
+/*
+ * Per-packet cost of a RIP route lookup: ns3::Rip's route list against the
+ * PrefixTrie used by RipTrie (bGoal --ripTable=trie).
+ *
+ *   ./waf --run "lookup-bench --prefixes=1000,10000,50000"
+ *
+ * For each table size the tables get one /24 per link, two thirds from the
+ * chain pool (10.0.0.0/14) and one third from the skip pool
+ * (10.168.0.0/14), like a bGoal table. Two costs are measured:
+ *
+ *  - lookup: the longest-prefix match of a forwarded packet, including the
+ *    Ipv4Route it returns; 5% of the destinations have no route
+ *  - rte: finding the route of one entry of a received RIP response by its
+ *    exact prefix, which ns3::Rip does by scanning the whole list
+ *
+ * The list side repeats the loops of Rip::Lookup and Rip::HandleResponses
+ * over RipRoutingTableEntry objects; both sides must agree on every lookup.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "../prefix-trie.h"
+
+using namespace ns3;
+
+typedef std::list<std::pair<RipRoutingTableEntry *, EventId> > Routes;
+
+static Ptr<Ipv4Route>
+ListLookup (const Routes &routes, Ipv4Address dst)
+{
+  Ptr<Ipv4Route> rtentry = 0;
+  uint16_t longestMask = 0;
+  for (Routes::const_iterator it = routes.begin (); it != routes.end (); it++)
+    {
+      if (it->first->GetRouteStatus () == RipRoutingTableEntry::RIP_VALID)
+        {
+          Ipv4Mask mask = it->first->GetDestNetworkMask ();
+          uint16_t maskLen = mask.GetPrefixLength ();
+          Ipv4Address entry = it->first->GetDestNetwork ();
+          if (mask.IsMatch (dst, entry))
+            {
+              if (maskLen < longestMask)
+                {
+                  continue;
+                }
+              longestMask = maskLen;
+              rtentry = Create<Ipv4Route> ();
+              rtentry->SetDestination (it->first->GetDest ());
+              rtentry->SetGateway (it->first->GetGateway ());
+            }
+        }
+    }
+  return rtentry;
+}
+
+static RipRoutingTableEntry *
+ListFind (const Routes &routes, Ipv4Address network, Ipv4Mask mask)
+{
+  RipRoutingTableEntry *found = 0;
+  for (Routes::const_iterator it = routes.begin (); it != routes.end (); it++)
+    {
+      if (it->first->GetDestNetwork () == network && it->first->GetDestNetworkMask () == mask)
+        {
+          found = it->first;
+        }
+    }
+  return found;
+}
+
+static Ptr<Ipv4Route>
+TrieLookup (const PrefixTrie &trie, const std::vector<RipRoutingTableEntry *> &slots, Ipv4Address dst)
+{
+  uint32_t slot = trie.Lookup (dst.Get ());
+  if (slot == PrefixTrie::NONE)
+    {
+      return 0;
+    }
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (slots[slot]->GetDest ());
+  rtentry->SetGateway (slots[slot]->GetGateway ());
+  return rtentry;
+}
+
+static double
+NsPer (std::chrono::steady_clock::time_point start, uint64_t n)
+{
+  return std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count () / n;
+}
+
+static void
+Measure (uint32_t nPrefixes, uint64_t budget, Ptr<UniformRandomVariable> random)
+{
+  // One /24 per link. A /14 pool holds 1024 of them; bigger tables carry on
+  // in the /14s after it, which stay clear of each other up to 60000.
+  std::vector<uint32_t> networks;
+  uint32_t chain = nPrefixes - nPrefixes / 3;
+  for (uint32_t i = 0; i < nPrefixes; ++i)
+    {
+      uint32_t base = i < chain ? Ipv4Address ("10.0.0.0").Get () : Ipv4Address ("10.168.0.0").Get ();
+      uint32_t index = i < chain ? i : i - chain;
+      networks.push_back (base + (index / 1024) * (4u << 16) + (index % 1024) * 256);
+    }
+  // ns3::Rip puts learned routes in front, so the list is in arrival order.
+  for (uint32_t i = nPrefixes; i > 1; --i)
+    {
+      std::swap (networks[i - 1], networks[random->GetInteger (0, i - 1)]);
+    }
+
+  Routes routes;
+  PrefixTrie trie;
+  std::vector<RipRoutingTableEntry *> slots;
+  Ipv4Mask mask ("255.255.255.0");
+  for (uint32_t i = 0; i < nPrefixes; ++i)
+    {
+      RipRoutingTableEntry *route = new RipRoutingTableEntry (Ipv4Address (networks[i]), mask,
+                                                              Ipv4Address (0x0a060001 + i % 4), 1 + i % 4);
+      route->SetRouteStatus (RipRoutingTableEntry::RIP_VALID);
+      routes.push_front (std::make_pair (route, EventId ()));
+      trie.Insert (networks[i], 24, slots.size ());
+      slots.push_back (route);
+    }
+
+  std::vector<Ipv4Address> destinations;
+  for (uint32_t i = 0; i < 4096; ++i)
+    {
+      destinations.push_back (random->GetValue () < 0.05 ? Ipv4Address (0xc0a80000 + i)
+                              : Ipv4Address (networks[random->GetInteger (0, nPrefixes - 1)] + 1 + i % 254));
+    }
+
+  // The list costs O(prefixes) per call: fewer calls for bigger tables.
+  uint64_t listCalls = std::max<uint64_t> (2000, budget / nPrefixes);
+  uint64_t trieCalls = std::max<uint64_t> (listCalls, 2000000);
+  uint64_t mismatches = 0;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  std::vector<Ipv4Address> listGateways;
+  for (uint64_t i = 0; i < listCalls; ++i)
+    {
+      Ptr<Ipv4Route> route = ListLookup (routes, destinations[i % destinations.size ()]);
+      if (i < destinations.size ())
+        {
+          listGateways.push_back (route ? route->GetGateway () : Ipv4Address::GetAny ());
+        }
+    }
+  double listNs = NsPer (start, listCalls);
+
+  start = std::chrono::steady_clock::now ();
+  for (uint64_t i = 0; i < trieCalls; ++i)
+    {
+      Ptr<Ipv4Route> route = TrieLookup (trie, slots, destinations[i % destinations.size ()]);
+      if (i < listGateways.size () && (route ? route->GetGateway () : Ipv4Address::GetAny ()) != listGateways[i])
+        {
+          ++mismatches;
+        }
+    }
+  double trieNs = NsPer (start, trieCalls);
+
+  uint64_t found = 0;
+  start = std::chrono::steady_clock::now ();
+  for (uint64_t i = 0; i < listCalls; ++i)
+    {
+      found += ListFind (routes, Ipv4Address (networks[i % nPrefixes]), mask) != 0;
+    }
+  double listRteNs = NsPer (start, listCalls);
+
+  start = std::chrono::steady_clock::now ();
+  for (uint64_t i = 0; i < trieCalls; ++i)
+    {
+      found += trie.Find (networks[i % nPrefixes], 24) != PrefixTrie::NONE;
+    }
+  double trieRteNs = NsPer (start, trieCalls);
+
+  NS_ABORT_MSG_IF (mismatches > 0, "lookup-bench: the trie disagrees with the list on " << mismatches << " lookups");
+  NS_ABORT_MSG_IF (found != listCalls + trieCalls, "lookup-bench: an exact-match search missed its prefix");
+  printf ("%-10u %-12.1f %-12.1f %-10.1f %-12.1f %-12.1f\n", nPrefixes, listNs, trieNs, listNs / trieNs,
+          listRteNs, trieRteNs);
+
+  for (Routes::iterator it = routes.begin (); it != routes.end (); it++)
+    {
+      delete it->first;
+    }
+}
+
+int main (int argc, char **argv)
+{
+  std::string prefixes ("1000,10000,50000");
+  uint64_t budget = 200000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("prefixes", "Comma-separated table sizes", prefixes);
+  cmd.AddValue ("budget", "Route entries the list side may visit per measurement", budget);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  printf ("%-10s %-12s %-12s %-10s %-12s %-12s\n", "prefixes", "list_ns", "trie_ns", "speedup", "list_rte_ns", "trie_rte_ns");
+  std::istringstream list (prefixes);
+  std::string item;
+  while (std::getline (list, item, ','))
+    {
+      uint32_t n = std::strtoul (item.c_str (), 0, 10);
+      NS_ABORT_MSG_IF (n == 0 || n > 60000, "lookup-bench: table size " << item << " is not between 1 and 60000");
+      Measure (n, budget, random);
+    }
+  return 0;
+}
@@ -0,0 +1,346 @@
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Decides which CSMA and point-to-point devices are traced and what
+ * is kept.
+ *
+ *  - "all": the usual EnablePcapAll/EnableAsciiAll, done by the caller.
+ *  - "none": no packet traces at all.
+ *  - "selective": one pcap per device of the chosen nodes, only the packets
+ *    that pass the protocol filter.
+ *  - "ring": like selective, but packets go to a bounded in-memory ring and
+ *    only the window around each failure passed to NotifyFailureAt is
+ *    written, to "<prefix>-<failure seconds>s-<node>-<device>.pcap".
+ *
+ * Devices are hooked through the same PromiscSniffer trace CsmaHelper and
+ * PointToPointHelper use for their pcap files, so the output opens in the
+ * same tools (Ethernet or PPP link type).
+ */
+class PacketCapture
+{
+public:
+  enum Mode
+  {
+    ALL,
+    NONE,
+    SELECTIVE,
+    RING
+  };
+  enum Filter
+  {
+    ANY,
+    ICMP,
+    RIP
+  };
+
+  /**
+   * \param mode all, none, selective or ring
+   * \param nodes comma-separated node ids to trace; empty for every node
+   * \param filter any, icmp or rip
+   * \param ringPackets capacity of the ring in packets
+   */
+  PacketCapture (const std::string &mode, const std::string &nodes, const std::string &filter, uint32_t ringPackets);
+
+  Mode GetMode (void) const;
+  /// How much of the traffic before and after a failure a ring dump holds.
+  void SetRingWindow (Time before, Time after);
+
+  /**
+   * \brief Hook the CSMA and point-to-point devices of the selected nodes
+   * among these.
+   * Does nothing in the all and none modes.
+   */
+  void Install (NodeContainer nodes, const std::string &prefix);
+  /// In ring mode, dump the capture window around this time, once per time.
+  void NotifyFailureAt (Time at);
+
+private:
+  struct Entry
+  {
+    Time time;
+    uint32_t device;
+    Ptr<const Packet> packet;
+  };
+
+  static void SniffedOn (PacketCapture *capture, uint32_t device, Ptr<const Packet> packet);
+  bool Matches (uint32_t device, Ptr<const Packet> packet) const;
+  void Sniffed (uint32_t device, Ptr<const Packet> packet);
+  void Dump (Time failure);
+
+  Mode m_mode;
+  Filter m_filter;
+  std::set<uint32_t> m_nodes;
+  std::string m_prefix;
+  std::vector<Ptr<NetDevice> > m_devices;
+  std::vector<uint32_t> m_linkTypes;          // pcap DLT, by device
+  std::vector<Ptr<PcapFileWrapper> > m_files; // selective mode, by device
+  std::vector<Entry> m_ring;
+  size_t m_ringHead;
+  size_t m_ringSize;
+  std::set<Time> m_dumpTimes;
+  Time m_before;
+  Time m_after;
+};
+
+inline
+PacketCapture::PacketCapture (const std::string &mode, const std::string &nodes, const std::string &filter, uint32_t ringPackets)
+  : m_ringHead (0),
+    m_ringSize (0),
+    m_before (Seconds (5)),
+    m_after (Seconds (5))
+{
+  if (mode == "all")
+    {
+      m_mode = ALL;
+    }
+  else if (mode == "none")
+    {
+      m_mode = NONE;
+    }
+  else if (mode == "selective")
+    {
+      m_mode = SELECTIVE;
+    }
+  else if (mode == "ring")
+    {
+      m_mode = RING;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown capture mode \"" << mode << "\" (all, none, selective, ring)");
+    }
+
+  if (filter == "any")
+    {
+      m_filter = ANY;
+    }
+  else if (filter == "icmp")
+    {
+      m_filter = ICMP;
+    }
+  else if (filter == "rip")
+    {
+      m_filter = RIP;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown capture protocol \"" << filter << "\" (any, icmp, rip)");
+    }
+
+  std::istringstream is (nodes);
+  std::string id;
+  while (std::getline (is, id, ','))
+    {
+      if (!id.empty ())
+        {
+          m_nodes.insert (std::stoul (id));
+        }
+    }
+
+  if (m_mode == RING)
+    {
+      NS_ABORT_MSG_IF (ringPackets == 0, "The capture ring needs room for at least one packet");
+      m_ring.resize (ringPackets);
+    }
+}
+
+inline PacketCapture::Mode
+PacketCapture::GetMode (void) const
+{
+  return m_mode;
+}
+
+inline void
+PacketCapture::SetRingWindow (Time before, Time after)
+{
+  m_before = before;
+  m_after = after;
+}
+
+inline void
+PacketCapture::Install (NodeContainer nodes, const std::string &prefix)
+{
+  if (m_mode == ALL || m_mode == NONE)
+    {
+      return;
+    }
+  m_prefix = prefix;
+  PcapHelper pcapHelper;
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      if (!m_nodes.empty () && m_nodes.count ((*it)->GetId ()) == 0)
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < (*it)->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> device = (*it)->GetDevice (i);
+          uint32_t linkType;
+          if (DynamicCast<CsmaNetDevice> (device) != 0)
+            {
+              linkType = PcapHelper::DLT_EN10MB;
+            }
+          else if (DynamicCast<PointToPointNetDevice> (device) != 0)
+            {
+              linkType = PcapHelper::DLT_PPP;
+            }
+          else
+            {
+              continue;
+            }
+          uint32_t index = m_devices.size ();
+          m_devices.push_back (device);
+          m_linkTypes.push_back (linkType);
+          if (m_mode == SELECTIVE)
+            {
+              m_files.push_back (pcapHelper.CreateFile (pcapHelper.GetFilenameFromDevice (prefix, device),
+                                                        std::ios::out, linkType));
+            }
+          device->TraceConnectWithoutContext ("PromiscSniffer", MakeBoundCallback (&PacketCapture::SniffedOn, this, index));
+        }
+    }
+  std::cout<<"INFO: Capturing on "<<m_devices.size ()<<" devices\n";
+}
+
+inline void
+PacketCapture::NotifyFailureAt (Time at)
+{
+  if (m_mode == RING && m_dumpTimes.insert (at).second)
+    {
+      Simulator::Schedule (at + m_after, &PacketCapture::Dump, this, at);
+    }
+}
+
+inline bool
+PacketCapture::Matches (uint32_t device, Ptr<const Packet> packet) const
+{
+  if (m_filter == ANY)
+    {
+      return true;
+    }
+  Ptr<Packet> copy = packet->Copy ();
+  if (m_linkTypes[device] == PcapHelper::DLT_PPP)
+    {
+      PppHeader ppp;
+      copy->RemoveHeader (ppp);
+      if (ppp.GetProtocol () != 0x0021) // IPv4
+        {
+          return false;
+        }
+    }
+  else
+    {
+      EthernetHeader ethernet (false);
+      copy->RemoveHeader (ethernet);
+      uint16_t type = ethernet.GetLengthType ();
+      if (type <= 1500)
+        {
+          LlcSnapHeader llc;
+          copy->RemoveHeader (llc);
+          type = llc.GetType ();
+        }
+      if (type != Ipv4L3Protocol::PROT_NUMBER)
+        {
+          return false;
+        }
+    }
+  Ipv4Header ipHeader;
+  copy->RemoveHeader (ipHeader);
+  if (m_filter == ICMP)
+    {
+      return ipHeader.GetProtocol () == Icmpv4L4Protocol::PROT_NUMBER;
+    }
+  if (ipHeader.GetProtocol () != UdpL4Protocol::PROT_NUMBER)
+    {
+      return false;
+    }
+  UdpHeader udpHeader;
+  copy->PeekHeader (udpHeader);
+  return udpHeader.GetDestinationPort () == 520;
+}
+
+inline void
+PacketCapture::SniffedOn (PacketCapture *capture, uint32_t device, Ptr<const Packet> packet)
+{
+  capture->Sniffed (device, packet);
+}
+
+inline void
+PacketCapture::Sniffed (uint32_t device, Ptr<const Packet> packet)
+{
+  if (!Matches (device, packet))
+    {
+      return;
+    }
+  if (m_mode == SELECTIVE)
+    {
+      m_files[device]->Write (Simulator::Now (), packet);
+      return;
+    }
+  // Packets are copy-on-write, so a ring slot only holds a reference.
+  Entry &entry = m_ring[(m_ringHead + m_ringSize) % m_ring.size ()];
+  entry.time = Simulator::Now ();
+  entry.device = device;
+  entry.packet = packet;
+  if (m_ringSize < m_ring.size ())
+    {
+      ++m_ringSize;
+    }
+  else
+    {
+      m_ringHead = (m_ringHead + 1) % m_ring.size ();
+    }
+}
+
+inline void
+PacketCapture::Dump (Time failure)
+{
+  Time from = failure - m_before;
+  if (m_ringSize == m_ring.size () && m_ring[m_ringHead].time > from)
+    {
+      std::cout<<"WARNING: capture ring only reaches back to "<<m_ring[m_ringHead].time.GetSeconds ()
+               <<"s for the failure at "<<failure.GetSeconds ()<<"s; raise the ring size\n";
+    }
+
+  std::ostringstream prefix;
+  prefix << m_prefix << "-" << failure.GetSeconds () << "s";
+  PcapHelper pcapHelper;
+  std::map<uint32_t, Ptr<PcapFileWrapper> > files;
+  uint64_t written = 0;
+  for (size_t i = 0; i < m_ringSize; ++i)
+    {
+      const Entry &entry = m_ring[(m_ringHead + i) % m_ring.size ()];
+      if (entry.time < from)
+        {
+          continue;
+        }
+      Ptr<PcapFileWrapper> &file = files[entry.device];
+      if (file == 0)
+        {
+          file = pcapHelper.CreateFile (pcapHelper.GetFilenameFromDevice (prefix.str (), m_devices[entry.device]),
+                                        std::ios::out, m_linkTypes[entry.device]);
+        }
+      file->Write (entry.time, entry.packet);
+      ++written;
+    }
+  std::cout<<"INFO: Wrote "<<written<<" captured packets around the failure at "<<failure.GetSeconds ()
+           <<"s to "<<files.size ()<<" files\n";
+}
+
+} // namespace ns3
+
+#endif /* PACKET_CAPTURE_H */
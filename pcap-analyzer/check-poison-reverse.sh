@@ -0,0 +1,63 @@
+#!/bin/sh
+# Poison reverse against real withdrawals in pcap-analyzer, on a made-up
+# point-to-point capture. Run from the ns-3 top-level directory with this
+# repository in scratch/:
+#   scratch/pcap-analyzer/check-poison-reverse.sh
+# or give a built analyzer: PCAP_ANALYZER=./pcap-analyzer check-poison-reverse.sh
+# A (10.0.1.1) and B (10.0.1.2) share 10.0.1.0/24. Every 30 s both send
+# the link subnet at metric 16, and each sends the other's network at
+# metric 16 (poison reverse). A withdraws 10.5.0.0/24 at 70.2 s and has
+# it back at 75 s: that is the only poisoned route.
+
+OUT=$(mktemp -d)
+
+python3 - "$OUT/p2p-1-1.pcap" <<'EOF' || exit 1
+import struct, sys
+def ip(src, dst, payload):
+    return struct.pack('!BBHHHBBH4s4s', 0x45, 0, 20 + len(payload), 0, 0, 1, 17, 0,
+                       bytes(src), bytes(dst)) + payload
+def rip(entries):
+    p = struct.pack('!BBH', 2, 2, 0)
+    for net, metric in entries:
+        p += struct.pack('!HH4s4s4sI', 2, 0, bytes(net), bytes([255, 255, 255, 0]), bytes(4), metric)
+    return struct.pack('!HHHH', 520, 520, 8 + len(p), 0) + p
+A = [10, 0, 1, 1]; B = [10, 0, 1, 2]; M = [224, 0, 0, 9]
+LINK = [10, 0, 1, 0]; NA = [10, 5, 0, 0]; NB = [10, 6, 0, 0]
+packets = []
+for t in range(0, 100, 30):
+    packets.append((t + 0.1, ip(A, M, rip([(LINK, 16), (NA, 2), (NB, 16)]))))
+    packets.append((t + 0.2, ip(B, M, rip([(LINK, 16), (NB, 2), (NA, 16)]))))
+packets.append((70.2, ip(A, M, rip([(NA, 16)]))))
+packets.append((75.0, ip(A, M, rip([(NA, 4)]))))
+packets.sort(key=lambda x: x[0])
+with open(sys.argv[1], 'wb') as f:
+    f.write(struct.pack('<IHHiIII', 0xa1b2c3d4, 2, 4, 0, 0, 65535, 9))
+    for t, p in packets:
+        frame = b'\x00\x21' + p
+        us = int(round(t * 1e6))
+        f.write(struct.pack('<IIII', us // 1000000, us % 1000000, len(frame), len(frame)) + frame)
+EOF
+
+ARGS="--dir=$OUT --teardowns=70 --out=$OUT/r"
+if [ -n "$PCAP_ANALYZER" ]
+then
+  $PCAP_ANALYZER $ARGS > "$OUT/a.log" 2>&1
+else
+  ./waf --run "pcap-analyzer $ARGS" > "$OUT/a.log" 2>&1
+fi || { cat "$OUT/a.log"; exit 1; }
+
+STATUS=0
+check ()
+{
+  if [ "$2" != "$3" ]
+  then
+    echo "FAIL: $1: got \"$2\", expected \"$3\""
+    STATUS=1
+  fi
+}
+check poisoned_entries "$(sed -n 2p "$OUT/r-links.csv" | cut -d, -f8)" 1
+check poison_reverse_entries "$(sed -n 2p "$OUT/r-links.csv" | cut -d, -f9)" 16
+check poisoned_routes "$(tail -n +2 "$OUT/r-poisoned.csv" | cut -d, -f2-5)" "10.0.1.1,10.5.0.0/24,70.200000,75.000000"
+[ $STATUS -eq 0 ] && echo "PASS: poison reverse"
+rm -rf "$OUT"
+exit $STATUS
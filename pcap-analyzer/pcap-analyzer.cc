@@ -0,0 +1,852 @@
+/*
+ * Offline analyzer for the pcap files of both scenarios
+ * (rip-poi-routing-*.pcap, pcap/mycsma-*.pcap, rip-poi-B-project-*.pcap).
+ *
+ *   ./waf --run "pcap-analyzer --dir=. --faultSchedule=scratch/aGoal-faults.txt"
+ *   ./waf --run "pcap-analyzer --files=a.pcap,b.pcap --teardowns=70 --out=run1"
+ *
+ * Every capture file is one device, which is what "link" means below. The
+ * files are memory-mapped and read in a single pass, parsing IPv4 straight
+ * out of the mapping: Ethernet (DIX or LLC/SNAP, as CsmaNetDevice writes
+ * them), PPP and raw IPv4 frames, classic pcap with microsecond or
+ * nanosecond timestamps in either byte order. Files are shared out among
+ * --threads workers, biggest first; a file is read by one thread, so a run
+ * is as parallel as it has files.
+ *
+ * Written with --out=<prefix>:
+ *
+ *     <prefix>-links.csv      link,link_type,bytes,packets,rip_requests,rip_responses,rip_entries,
+ *                             poisoned_entries,poison_reverse_entries,echo_requests,echo_replies,
+ *                             unreachable,time_exceeded,bursts,poisoned_routes,gaps,lost
+ *     <prefix>-bursts.csv     link,start_s,end_s,requests,responses,entries,poisoned,poison_reverse,
+ *                             after_teardown_s
+ *     <prefix>-poisoned.csv   link,sender,route,poisoned_s,reachable_s,after_teardown_s
+ *     <prefix>-gaps.csv       link,source,destination,id,first_seq,last_seq,lost,start_s,end_s,
+ *                             duration_s,after_teardown_s
+ *     <prefix>-teardowns.csv  teardown_s,bursts,poisoned_routes,first_poisoned_s,last_poisoned_s,
+ *                             gaps,lost,longest_gap_s
+ *
+ * A burst is a run of RIP packets on a link less than --burstGap apart. A
+ * poisoned route is a sender advertising a route with metric 16, from the
+ * first such response until the sender advertises it reachable again
+ * (reachable_s is empty if it never does). A metric 16 is poison reverse,
+ * the split-horizon answer for a route learned over the link, and no
+ * poisoned route when the route is the link's own subnet (the one holding
+ * the sender's address), when the sender has not yet advertised it
+ * reachable on the link, or when another sender there still does; it is
+ * counted apart (poison_reverse). So a withdrawal is missed only when it
+ * comes before the sender's first reachable entry in the capture. A loss
+ * gap is a jump in the icmp_seq of the echo replies of one ping (source,
+ * destination, id) seen on the link; a ping whose requests still cross the
+ * link after its last reply there ends with an open gap (end_s empty).
+ * Everything is attributed to the last teardown at or before it, from
+ * --teardowns and the "down" lines of --faultSchedule; a teardown's row
+ * counts what starts before the next one.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+static const uint32_t LINKTYPE_ETHERNET = 1;
+static const uint32_t LINKTYPE_PPP = 9;
+static const uint32_t LINKTYPE_RAW = 101;
+static const uint32_t LINKTYPE_IPV4 = 228;
+static const uint16_t RIP_PORT = 520;
+static const uint32_t RIP_INFINITY = 16;
+static const uint32_t NONE = 0xffffffff;
+
+struct Burst
+{
+  int64_t start;  // nanoseconds
+  int64_t end;
+  uint32_t requests;
+  uint32_t responses;
+  uint64_t entries;
+  uint64_t poisoned;
+  uint64_t poisonReverse;
+};
+
+struct Poisoned
+{
+  uint32_t sender;
+  uint32_t network;
+  uint8_t prefix;
+  int64_t poisoned;
+  int64_t reachable; // -1 while it is not
+};
+
+struct Gap
+{
+  uint32_t source;
+  uint32_t destination;
+  uint16_t id;
+  uint16_t firstSeq;
+  uint16_t lastSeq;
+  uint32_t lost;
+  int64_t start;
+  int64_t end; // -1 for a gap still open at the end of the capture
+};
+
+struct RouteKey
+{
+  uint32_t sender;
+  uint32_t network;
+  uint8_t prefix;
+  bool operator== (const RouteKey &o) const
+  {
+    return sender == o.sender && network == o.network && prefix == o.prefix;
+  }
+};
+
+struct FlowKey
+{
+  uint32_t source;
+  uint32_t destination;
+  uint16_t id;
+  bool operator== (const FlowKey &o) const
+  {
+    return source == o.source && destination == o.destination && id == o.id;
+  }
+};
+
+struct KeyHash
+{
+  size_t operator() (const RouteKey &k) const
+  {
+    return std::hash<uint64_t> () ((uint64_t (k.sender) << 32 | k.network) ^ (uint64_t (k.prefix) * 0x9e3779b97f4a7c15ull));
+  }
+  size_t operator() (const FlowKey &k) const
+  {
+    return std::hash<uint64_t> () ((uint64_t (k.source) << 32 | k.destination) ^ (uint64_t (k.id) * 0x9e3779b97f4a7c15ull));
+  }
+};
+
+/// What one sender last advertised for one route on a link.
+struct Advertised
+{
+  Advertised () : poisoned (NONE), reachable (false), wasReachable (false) {}
+  uint32_t poisoned;  // open entry of Link::poisoned, or NONE
+  bool reachable;     // the last metric was below 16
+  bool wasReachable;  // some metric was below 16
+};
+
+/// The state of one ping on one link.
+struct Flow
+{
+  Flow () : haveReply (false), lastReplySeq (0), lastReplyTime (0), requestsAfter (0), firstRequestAfter (0),
+             lastRequestSeq (0) {}
+  bool haveReply;
+  uint16_t lastReplySeq;
+  int64_t lastReplyTime;
+  uint32_t requestsAfter;    // echo requests seen since the last reply
+  int64_t firstRequestAfter; // and the time of the first of them
+  uint16_t lastRequestSeq;
+};
+
+/// Everything read from one capture file.
+struct Link
+{
+  Link () : size (0), linkType (0), bytes (0), packets (0), ripRequests (0), ripResponses (0),
+            ripEntries (0), poisonedEntries (0), poisonReverseEntries (0), echoRequests (0), echoReplies (0),
+            unreachable (0), timeExceeded (0), truncated (false) {}
+
+  std::string path;
+  std::string name;
+  uint64_t size;
+  uint32_t linkType;
+  uint64_t bytes;
+  uint64_t packets;
+  uint64_t ripRequests;
+  uint64_t ripResponses;
+  uint64_t ripEntries;
+  uint64_t poisonedEntries;
+  uint64_t poisonReverseEntries;
+  uint64_t echoRequests;
+  uint64_t echoReplies;
+  uint64_t unreachable;
+  uint64_t timeExceeded;
+  std::vector<Burst> bursts;
+  std::vector<Poisoned> poisoned;
+  std::vector<Gap> gaps;
+  bool truncated;
+  std::string error;
+};
+
+static inline uint16_t
+Be16 (const uint8_t *p)
+{
+  return uint16_t (p[0] << 8 | p[1]);
+}
+
+static inline uint32_t
+Be32 (const uint8_t *p)
+{
+  return uint32_t (p[0]) << 24 | uint32_t (p[1]) << 16 | uint32_t (p[2]) << 8 | p[3];
+}
+
+static inline uint32_t
+Word (const uint8_t *p, bool swapped)
+{
+  uint32_t v;
+  std::memcpy (&v, p, sizeof (v));
+  return swapped ? __builtin_bswap32 (v) : v;
+}
+
+static std::string
+FormatAddress (uint32_t a)
+{
+  std::ostringstream oss;
+  oss << (a >> 24) << "." << ((a >> 16) & 0xff) << "." << ((a >> 8) & 0xff) << "." << (a & 0xff);
+  return oss.str ();
+}
+
+/**
+ * \brief Parses the frames of one link and keeps its timelines.
+ */
+class LinkParser
+{
+public:
+  LinkParser (Link &link, int64_t burstGap) : m_link (link), m_burstGap (burstGap) {}
+
+  void Frame (int64_t t, const uint8_t *p, uint32_t len);
+  /// Close the gaps of pings whose requests outlived their replies.
+  void Finish (void);
+
+private:
+  void ParseIpv4 (int64_t t, const uint8_t *ip, uint32_t len);
+  void ParseRip (int64_t t, uint32_t sender, const uint8_t *rip, uint32_t len);
+  void ParseEcho (int64_t t, bool reply, const FlowKey &key, uint16_t seq);
+  /// The first unanswered request seen on the link, or else the last reply.
+  static int64_t GapStart (const Flow &flow);
+
+  Link &m_link;
+  int64_t m_burstGap;
+  std::unordered_map<RouteKey, Advertised, KeyHash> m_routes;
+  std::unordered_map<uint64_t, uint32_t> m_reachableBy; // network/prefix -> senders advertising it reachable
+  std::unordered_map<FlowKey, Flow, KeyHash> m_flows;
+};
+
+void
+LinkParser::Frame (int64_t t, const uint8_t *p, uint32_t len)
+{
+  switch (m_link.linkType)
+    {
+    case LINKTYPE_ETHERNET:
+      {
+        if (len < 14)
+          {
+            return;
+          }
+        uint16_t type = Be16 (p + 12);
+        uint32_t offset = 14;
+        if (type <= 1500)
+          {
+            // 802.3 length, then LLC/SNAP
+            if (len < 22 || p[14] != 0xaa || p[15] != 0xaa || p[16] != 0x03)
+              {
+                return;
+              }
+            type = Be16 (p + 20);
+            offset = 22;
+          }
+        if (type == 0x0800)
+          {
+            ParseIpv4 (t, p + offset, len - offset);
+          }
+        return;
+      }
+    case LINKTYPE_PPP:
+      {
+        // ns-3 writes the protocol field only; accept address and control too.
+        uint32_t offset = len >= 4 && p[0] == 0xff && p[1] == 0x03 ? 2 : 0;
+        if (len >= offset + 2 && Be16 (p + offset) == 0x0021)
+          {
+            ParseIpv4 (t, p + offset + 2, len - offset - 2);
+          }
+        return;
+      }
+    default:
+      ParseIpv4 (t, p, len);
+    }
+}
+
+void
+LinkParser::ParseIpv4 (int64_t t, const uint8_t *ip, uint32_t len)
+{
+  if (len < 20 || ip[0] >> 4 != 4)
+    {
+      return;
+    }
+  uint32_t headerLength = (ip[0] & 0x0f) * 4;
+  uint32_t total = std::min<uint32_t> (Be16 (ip + 2), len);
+  if (headerLength < 20 || total < headerLength || (Be16 (ip + 6) & 0x1fff) != 0)
+    {
+      return; // bad header or a fragment past the first
+    }
+  const uint8_t *l4 = ip + headerLength;
+  uint32_t l4Length = total - headerLength;
+  uint32_t source = Be32 (ip + 12);
+  uint32_t destination = Be32 (ip + 16);
+
+  if (ip[9] == 17 && l4Length >= 8 && (Be16 (l4) == RIP_PORT || Be16 (l4 + 2) == RIP_PORT))
+    {
+      ParseRip (t, source, l4 + 8, l4Length - 8);
+    }
+  else if (ip[9] == 1 && l4Length >= 8)
+    {
+      switch (l4[0])
+        {
+        case 0:
+          ++m_link.echoReplies;
+          ParseEcho (t, true, FlowKey { destination, source, Be16 (l4 + 4) }, Be16 (l4 + 6));
+          break;
+        case 8:
+          ++m_link.echoRequests;
+          ParseEcho (t, false, FlowKey { source, destination, Be16 (l4 + 4) }, Be16 (l4 + 6));
+          break;
+        case 3:
+          ++m_link.unreachable;
+          break;
+        case 11:
+          ++m_link.timeExceeded;
+          break;
+        }
+    }
+}
+
+void
+LinkParser::ParseRip (int64_t t, uint32_t sender, const uint8_t *rip, uint32_t len)
+{
+  if (len < 4 || (rip[0] != 1 && rip[0] != 2))
+    {
+      return;
+    }
+  bool response = rip[0] == 2;
+  if (m_link.bursts.empty () || t - m_link.bursts.back ().end > m_burstGap)
+    {
+      Burst burst = { t, t, 0, 0, 0, 0, 0 };
+      m_link.bursts.push_back (burst);
+    }
+  Burst &burst = m_link.bursts.back ();
+  burst.end = t;
+  if (!response)
+    {
+      ++burst.requests;
+      ++m_link.ripRequests;
+      return;
+    }
+  ++burst.responses;
+  ++m_link.ripResponses;
+
+  for (const uint8_t *rte = rip + 4; rte + 20 <= rip + len; rte += 20)
+    {
+      uint32_t network = Be32 (rte + 4);
+      uint32_t mask = Be32 (rte + 8);
+      uint8_t prefix = __builtin_popcount (mask);
+      uint32_t metric = Be32 (rte + 16);
+      ++burst.entries;
+      ++m_link.ripEntries;
+      RouteKey key = { sender, network, prefix };
+      Advertised &advertised = m_routes[key];
+      uint32_t &reachableBy = m_reachableBy[uint64_t (network) << 8 | prefix];
+      if (metric >= RIP_INFINITY)
+        {
+          if (advertised.reachable)
+            {
+              advertised.reachable = false;
+              --reachableBy;
+            }
+          // The link's own subnet, a route the sender never offered here, or
+          // one another sender offers here: split horizon, not a withdrawal.
+          if ((sender & mask) == network || !advertised.wasReachable || reachableBy > 0)
+            {
+              ++burst.poisonReverse;
+              ++m_link.poisonReverseEntries;
+            }
+          else
+            {
+              ++burst.poisoned;
+              ++m_link.poisonedEntries;
+              if (advertised.poisoned == NONE)
+                {
+                  advertised.poisoned = m_link.poisoned.size ();
+                  Poisoned p = { sender, network, prefix, t, -1 };
+                  m_link.poisoned.push_back (p);
+                }
+            }
+        }
+      else
+        {
+          if (!advertised.reachable)
+            {
+              advertised.reachable = true;
+              advertised.wasReachable = true;
+              ++reachableBy;
+            }
+          if (advertised.poisoned != NONE)
+            {
+              m_link.poisoned[advertised.poisoned].reachable = t;
+              advertised.poisoned = NONE;
+            }
+        }
+    }
+}
+
+void
+LinkParser::ParseEcho (int64_t t, bool reply, const FlowKey &key, uint16_t seq)
+{
+  Flow &flow = m_flows[key];
+  if (!reply)
+    {
+      if (flow.requestsAfter++ == 0)
+        {
+          flow.firstRequestAfter = t;
+        }
+      flow.lastRequestSeq = seq;
+      return;
+    }
+  uint16_t step = seq - flow.lastReplySeq;
+  if (flow.haveReply && (step == 0 || step >= 0x8000))
+    {
+      return; // duplicate or late
+    }
+  if (flow.haveReply && step > 1)
+    {
+      Gap gap = { key.source, key.destination, key.id, uint16_t (flow.lastReplySeq + 1), uint16_t (seq - 1),
+                  uint32_t (step - 1), GapStart (flow), t };
+      m_link.gaps.push_back (gap);
+    }
+  flow.haveReply = true;
+  flow.lastReplySeq = seq;
+  flow.lastReplyTime = t;
+  flow.requestsAfter = 0;
+}
+
+int64_t
+LinkParser::GapStart (const Flow &flow)
+{
+  return flow.requestsAfter > 0 ? flow.firstRequestAfter : flow.lastReplyTime;
+}
+
+void
+LinkParser::Finish (void)
+{
+  for (std::unordered_map<FlowKey, Flow, KeyHash>::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      const Flow &flow = it->second;
+      // The request of the last reply may come after it only in a capture of both ways.
+      uint16_t step = flow.lastRequestSeq - flow.lastReplySeq;
+      if (flow.haveReply && flow.requestsAfter > 0 && step > 0 && step < 0x8000)
+        {
+          Gap gap = { it->first.source, it->first.destination, it->first.id, uint16_t (flow.lastReplySeq + 1),
+                      flow.lastRequestSeq, step, GapStart (flow), -1 };
+          m_link.gaps.push_back (gap);
+        }
+    }
+  std::sort (m_link.gaps.begin (), m_link.gaps.end (),
+             [] (const Gap &a, const Gap &b) { return a.start < b.start; });
+  m_flows.clear ();
+  m_routes.clear ();
+  m_reachableBy.clear ();
+}
+
+static void
+ReadFile (Link &link, int64_t burstGap)
+{
+  int fd = open (link.path.c_str (), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat (fd, &st) != 0)
+    {
+      link.error = "cannot open " + link.path;
+      if (fd >= 0)
+        {
+          close (fd);
+        }
+      return;
+    }
+  size_t size = st.st_size;
+  if (size < 24)
+    {
+      link.error = link.path + " is not a pcap file";
+      close (fd);
+      return;
+    }
+  void *map = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      link.error = "cannot map " + link.path;
+      return;
+    }
+  madvise (map, size, MADV_SEQUENTIAL);
+  const uint8_t *data = static_cast<const uint8_t *> (map);
+
+  uint32_t magic;
+  std::memcpy (&magic, data, sizeof (magic));
+  bool swapped = magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1;
+  bool nanoseconds = magic == 0xa1b23c4d || magic == 0x4d3cb2a1;
+  link.linkType = Word (data + 20, swapped);
+  if (!swapped && !nanoseconds && magic != 0xa1b2c3d4)
+    {
+      link.error = link.path + " is not a pcap file";
+    }
+  else if (link.linkType != LINKTYPE_ETHERNET && link.linkType != LINKTYPE_PPP
+           && link.linkType != LINKTYPE_RAW && link.linkType != LINKTYPE_IPV4)
+    {
+      std::ostringstream oss;
+      oss << link.path << " has link type " << link.linkType << ", which is not read";
+      link.error = oss.str ();
+    }
+  else
+    {
+      LinkParser parser (link, burstGap);
+      int64_t unit = nanoseconds ? 1 : 1000;
+      size_t offset = 24;
+      while (offset + 16 <= size)
+        {
+          const uint8_t *record = data + offset;
+          uint32_t captured = Word (record + 8, swapped);
+          if (captured > size - offset - 16)
+            {
+              link.truncated = true; // still being written, or cut short
+              break;
+            }
+          int64_t t = int64_t (Word (record, swapped)) * 1000000000 + int64_t (Word (record + 4, swapped)) * unit;
+          parser.Frame (t, record + 16, captured);
+          ++link.packets;
+          offset += 16 + captured;
+        }
+      link.bytes = offset;
+      parser.Finish ();
+    }
+  munmap (map, size);
+}
+
+static bool
+EndsWith (const std::string &s, const std::string &suffix)
+{
+  return s.size () >= suffix.size () && s.compare (s.size () - suffix.size (), suffix.size (), suffix) == 0;
+}
+
+static std::vector<std::string>
+Split (const std::string &list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+static std::string
+FormatSeconds (int64_t ns)
+{
+  if (ns < 0)
+    {
+      return "";
+    }
+  char buffer[32];
+  std::snprintf (buffer, sizeof (buffer), "%.6f", ns / 1e9);
+  return buffer;
+}
+
+/// Time since the last teardown at or before t, or empty.
+static std::string
+AfterTeardown (const std::vector<int64_t> &teardowns, int64_t t)
+{
+  std::vector<int64_t>::const_iterator it = std::upper_bound (teardowns.begin (), teardowns.end (), t);
+  return it == teardowns.begin () ? "" : FormatSeconds (t - *(it - 1));
+}
+
+/// Index of the last teardown at or before t, or -1.
+static int
+TeardownOf (const std::vector<int64_t> &teardowns, int64_t t)
+{
+  return int (std::upper_bound (teardowns.begin (), teardowns.end (), t) - teardowns.begin ()) - 1;
+}
+
+static FILE *
+OpenCsv (const std::string &path, const char *header)
+{
+  FILE *f = std::fopen (path.c_str (), "w");
+  NS_ABORT_MSG_UNLESS (f != 0, "Cannot write " << path);
+  std::fprintf (f, "%s\n", header);
+  return f;
+}
+
+int
+main (int argc, char **argv)
+{
+  std::string files;
+  std::string dir;
+  std::string teardownList;
+  std::string faultSchedule;
+  std::string out ("pcap-analysis");
+  double burstGap = 0.5;
+  uint32_t threads = std::max (1u, std::thread::hardware_concurrency ());
+
+  CommandLine cmd;
+  cmd.AddValue ("files", "Comma-separated pcap files", files);
+  cmd.AddValue ("dir", "Read every .pcap file of this directory", dir);
+  cmd.AddValue ("teardowns", "Comma-separated teardown times in seconds", teardownList);
+  cmd.AddValue ("faultSchedule", "Take the teardown times from the \"down\" lines of this fault schedule", faultSchedule);
+  cmd.AddValue ("burstGap", "Seconds of RIP silence on a link that end a burst", burstGap);
+  cmd.AddValue ("threads", "Files read at the same time", threads);
+  cmd.AddValue ("out", "Prefix of the CSV files written", out);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::string> paths = Split (files);
+  if (!dir.empty ())
+    {
+      DIR *d = opendir (dir.c_str ());
+      if (d == 0)
+        {
+          std::cerr << "pcap-analyzer: cannot read directory " << dir << std::endl;
+          return 1;
+        }
+      std::vector<std::string> found;
+      for (struct dirent *e = readdir (d); e != 0; e = readdir (d))
+        {
+          if (EndsWith (e->d_name, ".pcap"))
+            {
+              found.push_back (dir + "/" + e->d_name);
+            }
+        }
+      closedir (d);
+      std::sort (found.begin (), found.end ());
+      paths.insert (paths.end (), found.begin (), found.end ());
+    }
+  if (paths.empty ())
+    {
+      std::cerr << "pcap-analyzer: no capture files (--files or --dir)" << std::endl;
+      return 1;
+    }
+  NS_ABORT_MSG_UNLESS (burstGap > 0, "pcap-analyzer: --burstGap must be positive");
+  NS_ABORT_MSG_UNLESS (threads > 0, "pcap-analyzer: --threads must be positive");
+
+  std::vector<int64_t> teardowns;
+  std::vector<std::string> times = Split (teardownList);
+  for (size_t i = 0; i < times.size (); ++i)
+    {
+      teardowns.push_back (int64_t (std::strtod (times[i].c_str (), 0) * 1e9));
+    }
+  if (!faultSchedule.empty ())
+    {
+      std::ifstream in (faultSchedule.c_str ());
+      NS_ABORT_MSG_UNLESS (in, "Cannot open " << faultSchedule);
+      std::string line;
+      while (std::getline (in, line))
+        {
+          std::istringstream iss (line.substr (0, line.find ('#')));
+          double seconds;
+          std::string kind;
+          if (iss >> seconds >> kind && kind == "down")
+            {
+              teardowns.push_back (int64_t (seconds * 1e9));
+            }
+        }
+    }
+  std::sort (teardowns.begin (), teardowns.end ());
+  teardowns.erase (std::unique (teardowns.begin (), teardowns.end ()), teardowns.end ());
+
+  std::vector<Link> links (paths.size ());
+  std::vector<size_t> order (paths.size ());
+  for (size_t i = 0; i < paths.size (); ++i)
+    {
+      links[i].path = paths[i];
+      size_t slash = paths[i].rfind ('/');
+      links[i].name = paths[i].substr (slash == std::string::npos ? 0 : slash + 1);
+      if (EndsWith (links[i].name, ".pcap"))
+        {
+          links[i].name.resize (links[i].name.size () - 5);
+        }
+      struct stat st;
+      links[i].size = stat (paths[i].c_str (), &st) == 0 ? st.st_size : 0;
+      order[i] = i;
+    }
+  // Biggest first, so that one large file does not start last.
+  std::sort (order.begin (), order.end (),
+             [&links] (size_t a, size_t b) { return links[a].size > links[b].size; });
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  std::atomic<size_t> next (0);
+  int64_t gapNs = int64_t (burstGap * 1e9);
+  std::vector<std::thread> workers;
+  for (uint32_t i = 0; i < std::min<size_t> (threads, paths.size ()); ++i)
+    {
+      workers.push_back (std::thread ([&] ()
+        {
+          for (size_t k = next++; k < order.size (); k = next++)
+            {
+              ReadFile (links[order[k]], gapNs);
+            }
+        }));
+    }
+  for (size_t i = 0; i < workers.size (); ++i)
+    {
+      workers[i].join ();
+    }
+  double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+  uint64_t bytes = 0;
+  uint64_t packets = 0;
+  uint32_t read = 0;
+  for (size_t i = 0; i < links.size (); ++i)
+    {
+      if (!links[i].error.empty ())
+        {
+          std::cerr << "pcap-analyzer: " << links[i].error << std::endl;
+          continue;
+        }
+      if (links[i].truncated)
+        {
+          std::cerr << "pcap-analyzer: " << links[i].path << " ends in a partial record, read up to it" << std::endl;
+        }
+      bytes += links[i].bytes;
+      packets += links[i].packets;
+      ++read;
+    }
+  if (read == 0)
+    {
+      return 1;
+    }
+  std::cout << "INFO: Read " << read << " files, " << bytes / 1e9 << " GB, " << packets << " packets in "
+            << wall << " s (" << bytes / 1e9 / wall << " GB/s, " << workers.size () << " threads)" << std::endl;
+
+  struct Summary
+  {
+    uint64_t bursts;
+    uint64_t poisoned;
+    int64_t firstPoisoned;
+    int64_t lastPoisoned;
+    uint64_t gaps;
+    uint64_t lost;
+    int64_t longestGap;
+  };
+  Summary empty = { 0, 0, -1, -1, 0, 0, -1 };
+  std::vector<Summary> summaries (teardowns.size (), empty);
+
+  FILE *linksCsv = OpenCsv (out + "-links.csv", "link,link_type,bytes,packets,rip_requests,rip_responses,rip_entries,"
+                            "poisoned_entries,poison_reverse_entries,echo_requests,echo_replies,unreachable,time_exceeded,"
+                            "bursts,poisoned_routes,gaps,lost");
+  FILE *burstsCsv = OpenCsv (out + "-bursts.csv", "link,start_s,end_s,requests,responses,entries,poisoned,poison_reverse,"
+                             "after_teardown_s");
+  FILE *poisonedCsv = OpenCsv (out + "-poisoned.csv", "link,sender,route,poisoned_s,reachable_s,after_teardown_s");
+  FILE *gapsCsv = OpenCsv (out + "-gaps.csv", "link,source,destination,id,first_seq,last_seq,lost,start_s,end_s,"
+                           "duration_s,after_teardown_s");
+  for (size_t i = 0; i < links.size (); ++i)
+    {
+      const Link &link = links[i];
+      if (!link.error.empty ())
+        {
+          continue;
+        }
+      const char *name = link.name.c_str ();
+      uint64_t lost = 0;
+      for (std::vector<Burst>::const_iterator b = link.bursts.begin (); b != link.bursts.end (); ++b)
+        {
+          std::fprintf (burstsCsv, "%s,%s,%s,%u,%u,%llu,%llu,%llu,%s\n", name, FormatSeconds (b->start).c_str (),
+                        FormatSeconds (b->end).c_str (), b->requests, b->responses, (unsigned long long) b->entries,
+                        (unsigned long long) b->poisoned, (unsigned long long) b->poisonReverse,
+                        AfterTeardown (teardowns, b->start).c_str ());
+          int k = TeardownOf (teardowns, b->start);
+          if (k >= 0)
+            {
+              ++summaries[k].bursts;
+            }
+        }
+      for (std::vector<Poisoned>::const_iterator p = link.poisoned.begin (); p != link.poisoned.end (); ++p)
+        {
+          std::fprintf (poisonedCsv, "%s,%s,%s/%u,%s,%s,%s\n", name, FormatAddress (p->sender).c_str (),
+                        FormatAddress (p->network).c_str (), p->prefix, FormatSeconds (p->poisoned).c_str (),
+                        FormatSeconds (p->reachable).c_str (), AfterTeardown (teardowns, p->poisoned).c_str ());
+          int k = TeardownOf (teardowns, p->poisoned);
+          if (k >= 0)
+            {
+              Summary &s = summaries[k];
+              ++s.poisoned;
+              s.firstPoisoned = s.firstPoisoned < 0 ? p->poisoned : std::min (s.firstPoisoned, p->poisoned);
+              s.lastPoisoned = std::max (s.lastPoisoned, p->poisoned);
+            }
+        }
+      for (std::vector<Gap>::const_iterator g = link.gaps.begin (); g != link.gaps.end (); ++g)
+        {
+          std::fprintf (gapsCsv, "%s,%s,%s,%u,%u,%u,%u,%s,%s,%s,%s\n", name, FormatAddress (g->source).c_str (),
+                        FormatAddress (g->destination).c_str (), g->id, g->firstSeq, g->lastSeq, g->lost,
+                        FormatSeconds (g->start).c_str (), FormatSeconds (g->end).c_str (),
+                        g->end < 0 ? "" : FormatSeconds (g->end - g->start).c_str (),
+                        AfterTeardown (teardowns, g->start).c_str ());
+          lost += g->lost;
+          int k = TeardownOf (teardowns, g->start);
+          if (k >= 0)
+            {
+              Summary &s = summaries[k];
+              ++s.gaps;
+              s.lost += g->lost;
+              if (g->end >= 0)
+                {
+                  s.longestGap = std::max (s.longestGap, g->end - g->start);
+                }
+            }
+        }
+      std::fprintf (linksCsv, "%s,%u,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%zu,%zu,%zu,%llu\n", name,
+                    link.linkType, (unsigned long long) link.bytes, (unsigned long long) link.packets,
+                    (unsigned long long) link.ripRequests, (unsigned long long) link.ripResponses,
+                    (unsigned long long) link.ripEntries, (unsigned long long) link.poisonedEntries,
+                    (unsigned long long) link.poisonReverseEntries,
+                    (unsigned long long) link.echoRequests, (unsigned long long) link.echoReplies,
+                    (unsigned long long) link.unreachable, (unsigned long long) link.timeExceeded,
+                    link.bursts.size (), link.poisoned.size (), link.gaps.size (), (unsigned long long) lost);
+    }
+  std::fclose (linksCsv);
+  std::fclose (burstsCsv);
+  std::fclose (poisonedCsv);
+  std::fclose (gapsCsv);
+
+  FILE *teardownsCsv = OpenCsv (out + "-teardowns.csv", "teardown_s,bursts,poisoned_routes,first_poisoned_s,"
+                                "last_poisoned_s,gaps,lost,longest_gap_s");
+  if (!teardowns.empty ())
+    {
+      printf ("%-12s %-8s %-10s %-16s %-16s %-8s %-8s %-14s\n", "teardown_s", "bursts", "poisoned",
+              "first_poisoned_s", "last_poisoned_s", "gaps", "lost", "longest_gap_s");
+    }
+  for (size_t k = 0; k < teardowns.size (); ++k)
+    {
+      const Summary &s = summaries[k];
+      std::string first = s.firstPoisoned < 0 ? "" : FormatSeconds (s.firstPoisoned - teardowns[k]);
+      std::string last = s.lastPoisoned < 0 ? "" : FormatSeconds (s.lastPoisoned - teardowns[k]);
+      std::fprintf (teardownsCsv, "%s,%llu,%llu,%s,%s,%llu,%llu,%s\n", FormatSeconds (teardowns[k]).c_str (),
+                    (unsigned long long) s.bursts, (unsigned long long) s.poisoned, first.c_str (), last.c_str (),
+                    (unsigned long long) s.gaps, (unsigned long long) s.lost, FormatSeconds (s.longestGap).c_str ());
+      printf ("%-12s %-8llu %-10llu %-16s %-16s %-8llu %-8llu %-14s\n", FormatSeconds (teardowns[k]).c_str (),
+              (unsigned long long) s.bursts, (unsigned long long) s.poisoned, first.c_str (), last.c_str (),
+              (unsigned long long) s.gaps, (unsigned long long) s.lost, FormatSeconds (s.longestGap).c_str ());
+    }
+  std::fclose (teardownsCsv);
+  return 0;
+}
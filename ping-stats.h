@@ -0,0 +1,350 @@
+#ifndef PING_STATS_H
+#define PING_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/internet-apps-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Ping RTT and loss of one source, kept in memory and written once.
+ *
+ * Echo requests and replies are followed on the source's Ipv4L3Protocol
+ * Tx/Rx traces (for the icmp_seq) and RTTs are taken from the V4Ping Rtt
+ * trace. Per time window the number of pings sent and answered and the RTT
+ * sum/min/max are counted; RTTs also go into a histogram with four buckets
+ * per power of two microseconds. Nothing is written while the simulation
+ * runs.
+ *
+ * Write(prefix) produces:
+ *
+ *     <prefix>-windows.csv    start_s,sent,received,rtt_mean_ms,rtt_min_ms,rtt_max_ms
+ *     <prefix>-histogram.csv  rtt_low_ms,rtt_high_ms,count
+ *     <prefix>-outages.csv    first_seq,last_seq,lost,start_s,end_s,duration_s,after_failure_s
+ *
+ * An outage is a run of consecutive echo requests without a reply; it is
+ * attributed to the last failure passed to NotifyFailureAt before it began.
+ * A single unanswered request at the very end is the ping still in flight
+ * when the application stopped, not an outage.
+ */
+class PingStats
+{
+public:
+  PingStats (Time window = Seconds (1));
+
+  /// Hook the traces of src and of its V4Ping applications.
+  void Connect (Ptr<Node> src);
+  void NotifyFailureAt (Time at);
+
+  void Write (const std::string &prefix) const;
+
+  uint64_t GetNSent (void) const;
+  uint64_t GetNReceived (void) const;
+  /// RTT below which this fraction of the replies fall (bucket upper bound).
+  Time GetRttQuantile (double q) const;
+  uint32_t GetNOutages (void) const;
+  Time GetLongestOutage (void) const;
+
+private:
+  struct Window
+  {
+    Window () : sent (0), received (0), rttSum (0), rttMin (0), rttMax (0) {}
+    uint32_t sent;
+    uint32_t received;
+    int64_t rttSum; // all in nanoseconds
+    int64_t rttMin;
+    int64_t rttMax;
+  };
+
+  struct Outage
+  {
+    uint64_t first;
+    uint64_t last;
+    Time start;
+    Time end;
+    Time failure;
+  };
+
+  static const uint32_t BUCKETS = 160; // 2^(160/4) us is far beyond any RTT
+
+  static bool ParseEcho (Ptr<const Packet> packet, uint8_t type, uint16_t &seq);
+  static void TxSeen (PingStats *stats, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  static void RxSeen (PingStats *stats, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  static void RttSeen (PingStats *stats, Time rtt);
+  static double BucketLow (uint32_t bucket);
+  Window &CurrentWindow (void);
+  std::vector<Outage> FindOutages (void) const;
+
+  Time m_window;
+  std::vector<Window> m_windows;
+  std::vector<uint64_t> m_histogram;
+  std::vector<Time> m_sentAt;      // by request number
+  std::vector<bool> m_answered;    // by request number
+  std::vector<uint64_t> m_bySeq;   // icmp_seq -> latest request number
+  std::vector<Time> m_failures;
+  uint64_t m_received;
+};
+
+inline
+PingStats::PingStats (Time window)
+  : m_window (window),
+    m_histogram (BUCKETS, 0),
+    m_bySeq (65536, 0),
+    m_received (0)
+{
+}
+
+inline void
+PingStats::Connect (Ptr<Node> src)
+{
+  Ptr<Ipv4L3Protocol> l3 = src->GetObject<Ipv4L3Protocol> ();
+  l3->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&PingStats::TxSeen, this));
+  l3->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&PingStats::RxSeen, this));
+  for (uint32_t i = 0; i < src->GetNApplications (); ++i)
+    {
+      Ptr<V4Ping> ping = DynamicCast<V4Ping> (src->GetApplication (i));
+      if (ping != 0)
+        {
+          ping->TraceConnectWithoutContext ("Rtt", MakeBoundCallback (&PingStats::RttSeen, this));
+        }
+    }
+}
+
+inline void
+PingStats::NotifyFailureAt (Time at)
+{
+  m_failures.insert (std::upper_bound (m_failures.begin (), m_failures.end (), at), at);
+}
+
+inline bool
+PingStats::ParseEcho (Ptr<const Packet> packet, uint8_t type, uint16_t &seq)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  Ipv4Header ipHeader;
+  copy->RemoveHeader (ipHeader);
+  if (ipHeader.GetProtocol () != Icmpv4L4Protocol::PROT_NUMBER)
+    {
+      return false;
+    }
+  Icmpv4Header icmp;
+  copy->RemoveHeader (icmp);
+  if (icmp.GetType () != type)
+    {
+      return false;
+    }
+  Icmpv4Echo echo;
+  copy->PeekHeader (echo);
+  seq = echo.GetSequenceNumber ();
+  return true;
+}
+
+inline PingStats::Window &
+PingStats::CurrentWindow (void)
+{
+  size_t index = Simulator::Now ().GetInteger () / m_window.GetInteger ();
+  if (index >= m_windows.size ())
+    {
+      m_windows.resize (index + 1);
+    }
+  return m_windows[index];
+}
+
+inline void
+PingStats::TxSeen (PingStats *stats, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  uint16_t seq;
+  if (ParseEcho (packet, Icmpv4Header::ICMPV4_ECHO, seq))
+    {
+      stats->m_bySeq[seq] = stats->m_sentAt.size ();
+      stats->m_sentAt.push_back (Simulator::Now ());
+      stats->m_answered.push_back (false);
+      stats->CurrentWindow ().sent++;
+    }
+}
+
+inline void
+PingStats::RxSeen (PingStats *stats, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  uint16_t seq;
+  if (ParseEcho (packet, Icmpv4Header::ICMPV4_ECHO_REPLY, seq) && !stats->m_sentAt.empty ())
+    {
+      uint64_t request = stats->m_bySeq[seq];
+      if (!stats->m_answered[request])
+        {
+          stats->m_answered[request] = true;
+          stats->m_received++;
+        }
+    }
+}
+
+inline void
+PingStats::RttSeen (PingStats *stats, Time rtt)
+{
+  Window &window = stats->CurrentWindow ();
+  int64_t ns = rtt.GetNanoSeconds ();
+  window.rttMin = window.received == 0 ? ns : std::min (window.rttMin, ns);
+  window.rttMax = window.received == 0 ? ns : std::max (window.rttMax, ns);
+  window.rttSum += ns;
+  window.received++;
+
+  double us = std::max (1.0, rtt.GetMicroSeconds () + 0.0);
+  uint32_t bucket = std::min<uint32_t> (BUCKETS - 1, uint32_t (std::log2 (us) * 4));
+  stats->m_histogram[bucket]++;
+}
+
+inline double
+PingStats::BucketLow (uint32_t bucket)
+{
+  return bucket == 0 ? 0.0 : std::pow (2.0, bucket / 4.0) / 1000.0;
+}
+
+inline std::vector<PingStats::Outage>
+PingStats::FindOutages (void) const
+{
+  std::vector<Outage> outages;
+  for (uint64_t i = 0; i < m_sentAt.size (); )
+    {
+      if (m_answered[i])
+        {
+          ++i;
+          continue;
+        }
+      Outage outage;
+      outage.first = i;
+      while (i < m_sentAt.size () && !m_answered[i])
+        {
+          ++i;
+        }
+      outage.last = i - 1;
+      if (i == m_sentAt.size () && outage.first == outage.last)
+        {
+          break;
+        }
+      outage.start = m_sentAt[outage.first];
+      // Ends with the next answered request, or at the end of the run.
+      outage.end = i < m_sentAt.size () ? m_sentAt[i] : Simulator::Now ();
+      std::vector<Time>::const_iterator f = std::upper_bound (m_failures.begin (), m_failures.end (), outage.start);
+      outage.failure = f == m_failures.begin () ? Time (-1) : *(f - 1);
+      outages.push_back (outage);
+    }
+  return outages;
+}
+
+inline void
+PingStats::Write (const std::string &prefix) const
+{
+  std::ofstream windows ((prefix + "-windows.csv").c_str ());
+  NS_ABORT_MSG_UNLESS (windows, "Cannot write " << prefix << "-windows.csv");
+  windows << "start_s,sent,received,rtt_mean_ms,rtt_min_ms,rtt_max_ms\n";
+  for (size_t i = 0; i < m_windows.size (); ++i)
+    {
+      const Window &w = m_windows[i];
+      if (w.sent == 0 && w.received == 0)
+        {
+          continue;
+        }
+      windows << m_window.GetSeconds () * i << "," << w.sent << "," << w.received << ",";
+      if (w.received > 0)
+        {
+          windows << w.rttSum / 1e6 / w.received << "," << w.rttMin / 1e6 << "," << w.rttMax / 1e6;
+        }
+      else
+        {
+          windows << ",,";
+        }
+      windows << "\n";
+    }
+
+  std::ofstream histogram ((prefix + "-histogram.csv").c_str ());
+  NS_ABORT_MSG_UNLESS (histogram, "Cannot write " << prefix << "-histogram.csv");
+  histogram << "rtt_low_ms,rtt_high_ms,count\n";
+  for (uint32_t b = 0; b < BUCKETS; ++b)
+    {
+      if (m_histogram[b] > 0)
+        {
+          histogram << BucketLow (b) << "," << BucketLow (b + 1) << "," << m_histogram[b] << "\n";
+        }
+    }
+
+  std::ofstream outages ((prefix + "-outages.csv").c_str ());
+  NS_ABORT_MSG_UNLESS (outages, "Cannot write " << prefix << "-outages.csv");
+  outages << "first_seq,last_seq,lost,start_s,end_s,duration_s,after_failure_s\n";
+  std::vector<Outage> list = FindOutages ();
+  for (size_t i = 0; i < list.size (); ++i)
+    {
+      const Outage &o = list[i];
+      outages << o.first << "," << o.last << "," << o.last - o.first + 1 << ","
+              << o.start.GetSeconds () << "," << o.end.GetSeconds () << "," << (o.end - o.start).GetSeconds () << ",";
+      if (!o.failure.IsNegative ())
+        {
+          outages << o.failure.GetSeconds ();
+        }
+      outages << "\n";
+    }
+
+  std::cout<<"INFO: Pings "<<m_received<<"/"<<m_sentAt.size ()<<" answered, median RTT "
+           <<GetRttQuantile (0.5).GetMilliSeconds ()<<" ms, p99 "<<GetRttQuantile (0.99).GetMilliSeconds ()
+           <<" ms, "<<list.size ()<<" outages; written to "<<prefix<<"-*.csv\n";
+}
+
+inline uint64_t
+PingStats::GetNSent (void) const
+{
+  return m_sentAt.size ();
+}
+
+inline uint64_t
+PingStats::GetNReceived (void) const
+{
+  return m_received;
+}
+
+inline Time
+PingStats::GetRttQuantile (double q) const
+{
+  uint64_t total = 0;
+  for (uint32_t b = 0; b < BUCKETS; ++b)
+    {
+      total += m_histogram[b];
+    }
+  uint64_t seen = 0;
+  for (uint32_t b = 0; b < BUCKETS && total > 0; ++b)
+    {
+      seen += m_histogram[b];
+      if (seen >= q * total)
+        {
+          return MicroSeconds (int64_t (BucketLow (b + 1) * 1000.0));
+        }
+    }
+  return Time (0);
+}
+
+inline uint32_t
+PingStats::GetNOutages (void) const
+{
+  return FindOutages ().size ();
+}
+
+inline Time
+PingStats::GetLongestOutage (void) const
+{
+  std::vector<Outage> list = FindOutages ();
+  Time longest;
+  for (size_t i = 0; i < list.size (); ++i)
+    {
+      longest = std::max (longest, list[i].end - list[i].start);
+    }
+  return longest;
+}
+
+} // namespace ns3
+
+#endif /* PING_STATS_H */
@@ -0,0 +1,304 @@
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief IPv4 prefixes mapped to a 32-bit value, in a path-compressed
+ * binary trie.
+ *
+ * Every node holds a prefix and, if that prefix was inserted, its value;
+ * a node without a value only exists where two branches part. Single-child
+ * chains are skipped, so a trie of n prefixes has fewer than 2n nodes and
+ * a lookup visits at most 33 of them whatever n is.
+ *
+ * Nodes live in one vector and refer to each other by index; removed
+ * nodes are recycled. Addresses and prefixes are host-order integers
+ * (Ipv4Address::Get ()).
+ */
+class PrefixTrie
+{
+public:
+  enum
+  {
+    NONE = 0xffffffff
+  };
+
+  PrefixTrie ();
+
+  /// Set the value of prefix/length, returning the one it replaces or NONE.
+  uint32_t Insert (uint32_t prefix, uint8_t length, uint32_t value);
+  /// Remove prefix/length, returning its value or NONE.
+  uint32_t Remove (uint32_t prefix, uint8_t length);
+  /// Value of exactly prefix/length, or NONE.
+  uint32_t Find (uint32_t prefix, uint8_t length) const;
+  /// Value of the longest prefix covering address, or NONE.
+  uint32_t Lookup (uint32_t address) const;
+  /**
+   * \brief Value of the longest prefix covering address for which
+   * accept (value) is true, or NONE.
+   */
+  template <typename Accept>
+  uint32_t Lookup (uint32_t address, Accept accept) const;
+
+  size_t GetSize (void) const;
+  void Clear (void);
+
+  static uint32_t Mask (uint8_t length);
+
+private:
+  struct Node
+  {
+    uint32_t prefix;
+    uint8_t length;
+    uint32_t value;
+    uint32_t child[2]; // 0: none (the root is never a child)
+  };
+
+  static uint32_t Bit (uint32_t address, uint8_t position);
+  static uint8_t CommonLength (uint32_t a, uint32_t b, uint8_t max);
+  uint32_t NewNode (uint32_t prefix, uint8_t length, uint32_t value);
+  void FreeNode (uint32_t node);
+
+  std::vector<Node> m_nodes; // m_nodes[0] is the root, 0.0.0.0/0
+  std::vector<uint32_t> m_free;
+  size_t m_size;
+};
+
+inline
+PrefixTrie::PrefixTrie ()
+  : m_size (0)
+{
+  Clear ();
+}
+
+inline uint32_t
+PrefixTrie::Mask (uint8_t length)
+{
+  return length == 0 ? 0 : 0xffffffffu << (32 - length);
+}
+
+inline uint32_t
+PrefixTrie::Bit (uint32_t address, uint8_t position)
+{
+  return (address >> (31 - position)) & 1;
+}
+
+inline uint8_t
+PrefixTrie::CommonLength (uint32_t a, uint32_t b, uint8_t max)
+{
+  uint32_t x = a ^ b;
+  return x == 0 ? max : std::min<uint8_t> (__builtin_clz (x), max);
+}
+
+inline uint32_t
+PrefixTrie::NewNode (uint32_t prefix, uint8_t length, uint32_t value)
+{
+  Node node;
+  node.prefix = prefix;
+  node.length = length;
+  node.value = value;
+  node.child[0] = node.child[1] = 0;
+  if (!m_free.empty ())
+    {
+      uint32_t index = m_free.back ();
+      m_free.pop_back ();
+      m_nodes[index] = node;
+      return index;
+    }
+  m_nodes.push_back (node);
+  return m_nodes.size () - 1;
+}
+
+inline void
+PrefixTrie::FreeNode (uint32_t node)
+{
+  m_free.push_back (node);
+}
+
+inline uint32_t
+PrefixTrie::Insert (uint32_t prefix, uint8_t length, uint32_t value)
+{
+  prefix &= Mask (length);
+  uint32_t n = 0;
+  while (true)
+    {
+      if (m_nodes[n].length == length)
+        {
+          uint32_t old = m_nodes[n].value;
+          m_nodes[n].value = value;
+          m_size += old == NONE;
+          return old;
+        }
+      uint32_t b = Bit (prefix, m_nodes[n].length);
+      uint32_t c = m_nodes[n].child[b];
+      if (c == 0)
+        {
+          uint32_t leaf = NewNode (prefix, length, value);
+          m_nodes[n].child[b] = leaf;
+          ++m_size;
+          return NONE;
+        }
+      uint8_t common = CommonLength (m_nodes[c].prefix, prefix, std::min (m_nodes[c].length, length));
+      if (common == m_nodes[c].length)
+        {
+          n = c;
+          continue;
+        }
+      // The new prefix parts from the child's branch at "common": either it
+      // is the parting point itself, or a valueless node goes there.
+      uint32_t childBit = Bit (m_nodes[c].prefix, common);
+      if (common == length)
+        {
+          uint32_t middle = NewNode (prefix, length, value);
+          m_nodes[middle].child[childBit] = c;
+          m_nodes[n].child[b] = middle;
+        }
+      else
+        {
+          uint32_t middle = NewNode (prefix & Mask (common), common, NONE);
+          uint32_t leaf = NewNode (prefix, length, value);
+          m_nodes[middle].child[childBit] = c;
+          m_nodes[middle].child[1 - childBit] = leaf;
+          m_nodes[n].child[b] = middle;
+        }
+      ++m_size;
+      return NONE;
+    }
+}
+
+inline uint32_t
+PrefixTrie::Remove (uint32_t prefix, uint8_t length)
+{
+  prefix &= Mask (length);
+  uint32_t parent = 0;
+  uint32_t n = 0;
+  while (m_nodes[n].length < length)
+    {
+      uint32_t c = m_nodes[n].child[Bit (prefix, m_nodes[n].length)];
+      if (c == 0 || m_nodes[c].length > length
+          || CommonLength (m_nodes[c].prefix, prefix, m_nodes[c].length) < m_nodes[c].length)
+        {
+          return NONE;
+        }
+      parent = n;
+      n = c;
+    }
+  uint32_t old = m_nodes[n].value;
+  if (old == NONE)
+    {
+      return NONE;
+    }
+  m_nodes[n].value = NONE;
+  --m_size;
+  if (n == 0)
+    {
+      return old;
+    }
+
+  // Unlink the node if it has become a leaf or a pass-through, then the
+  // parent if that leaves it a valueless pass-through.
+  Node &node = m_nodes[n];
+  if (node.child[0] != 0 && node.child[1] != 0)
+    {
+      return old;
+    }
+  uint32_t only = node.child[0] != 0 ? node.child[0] : node.child[1];
+  Node &up = m_nodes[parent];
+  uint32_t side = up.child[0] == n ? 0 : 1;
+  up.child[side] = only;
+  FreeNode (n);
+  if (only == 0 && parent != 0 && up.value == NONE)
+    {
+      uint32_t grandparent = 0;
+      uint32_t g = 0;
+      while (g != parent)
+        {
+          grandparent = g;
+          g = m_nodes[g].child[Bit (prefix, m_nodes[g].length)];
+        }
+      Node &top = m_nodes[grandparent];
+      top.child[top.child[0] == parent ? 0 : 1] = up.child[1 - side];
+      FreeNode (parent);
+    }
+  return old;
+}
+
+inline uint32_t
+PrefixTrie::Find (uint32_t prefix, uint8_t length) const
+{
+  prefix &= Mask (length);
+  uint32_t n = 0;
+  while (m_nodes[n].length < length)
+    {
+      n = m_nodes[n].child[Bit (prefix, m_nodes[n].length)];
+      if (n == 0 || m_nodes[n].length > length
+          || CommonLength (m_nodes[n].prefix, prefix, m_nodes[n].length) < m_nodes[n].length)
+        {
+          return NONE;
+        }
+    }
+  return m_nodes[n].value;
+}
+
+inline uint32_t
+PrefixTrie::Lookup (uint32_t address) const
+{
+  struct Any
+  {
+    bool operator () (uint32_t) const { return true; }
+  };
+  return Lookup (address, Any ());
+}
+
+template <typename Accept>
+inline uint32_t
+PrefixTrie::Lookup (uint32_t address, Accept accept) const
+{
+  uint32_t best = NONE;
+  uint32_t n = 0;
+  while (true)
+    {
+      const Node &node = m_nodes[n];
+      if (((address ^ node.prefix) & Mask (node.length)) != 0)
+        {
+          return best;
+        }
+      if (node.value != NONE && accept (node.value))
+        {
+          best = node.value;
+        }
+      if (node.length == 32)
+        {
+          return best;
+        }
+      n = node.child[Bit (address, node.length)];
+      if (n == 0)
+        {
+          return best;
+        }
+    }
+}
+
+inline size_t
+PrefixTrie::GetSize (void) const
+{
+  return m_size;
+}
+
+inline void
+PrefixTrie::Clear (void)
+{
+  m_nodes.clear ();
+  m_free.clear ();
+  m_size = 0;
+  NewNode (0, 0, NONE);
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
@@ -0,0 +1,120 @@
+#ifndef RIP_CONVERGENCE_H
+#define RIP_CONVERGENCE_H
+
+#include <algorithm>
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief Declares RIP converged once no watched table has changed for a
+ * quiet period after the last scheduled failure, and optionally stops the
+ * simulation there.
+ *
+ * The convergence time is measured from the last failure to the last table
+ * change it caused (or from t=0 when no failure is scheduled).
+ */
+class RipConvergenceDetector
+{
+public:
+  RipConvergenceDetector (RipTableWatcher &watcher, Time quietPeriod, bool stopOnConvergence);
+
+  /**
+   * \brief Tell the detector about a failure scheduled at this time.
+   * Call for every TearDownLink, removeConnRandomly or MoveOutNode event.
+   */
+  void NotifyFailureAt (Time at);
+
+  bool HasConverged (void) const;
+  Time GetLastChange (void) const;
+  Time GetConvergenceTime (void) const;
+
+private:
+  void TableChanged (uint32_t nodeId);
+  void Arm (void);
+  void Expire (void);
+
+  Time m_quietPeriod;
+  bool m_stop;
+  Time m_lastFailure;
+  Time m_lastChange;
+  bool m_converged;
+  EventId m_timer;
+};
+
+inline
+RipConvergenceDetector::RipConvergenceDetector (RipTableWatcher &watcher, Time quietPeriod, bool stopOnConvergence)
+  : m_quietPeriod (quietPeriod),
+    m_stop (stopOnConvergence),
+    m_converged (false)
+{
+  watcher.AddTableChangedCallback (MakeCallback (&RipConvergenceDetector::TableChanged, this));
+  Arm ();
+}
+
+inline void
+RipConvergenceDetector::NotifyFailureAt (Time at)
+{
+  m_lastFailure = std::max (m_lastFailure, at);
+  Arm ();
+}
+
+inline bool
+RipConvergenceDetector::HasConverged (void) const
+{
+  return m_converged;
+}
+
+inline Time
+RipConvergenceDetector::GetLastChange (void) const
+{
+  return m_lastChange;
+}
+
+inline Time
+RipConvergenceDetector::GetConvergenceTime (void) const
+{
+  return m_lastChange > m_lastFailure ? m_lastChange - m_lastFailure : Time (0);
+}
+
+inline void
+RipConvergenceDetector::TableChanged (uint32_t nodeId)
+{
+  m_lastChange = Simulator::Now ();
+  m_converged = false;
+  Arm ();
+}
+
+inline void
+RipConvergenceDetector::Arm (void)
+{
+  // One pending timer at most; Expire() moves it forward when tables
+  // changed in the meantime instead of rescheduling on every change.
+  if (!m_timer.IsRunning () && !m_converged)
+    {
+      Time deadline = std::max (m_lastChange, m_lastFailure) + m_quietPeriod;
+      m_timer = Simulator::Schedule (std::max (deadline - Simulator::Now (), Time (0)), &RipConvergenceDetector::Expire, this);
+    }
+}
+
+inline void
+RipConvergenceDetector::Expire (void)
+{
+  Time deadline = std::max (m_lastChange, m_lastFailure) + m_quietPeriod;
+  if (Simulator::Now () < deadline)
+    {
+      m_timer = Simulator::Schedule (deadline - Simulator::Now (), &RipConvergenceDetector::Expire, this);
+      return;
+    }
+  m_converged = true;
+  std::cout<<"INFO: RIP converged at "<<m_lastChange.GetSeconds ()<<" s, "
+           <<GetConvergenceTime ().GetSeconds ()<<" s after the last failure\n";
+  if (m_stop)
+    {
+      Simulator::Stop ();
+    }
+}
+
+} // namespace ns3
+
+#endif /* RIP_CONVERGENCE_H */
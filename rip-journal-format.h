@@ -0,0 +1,45 @@
+#ifndef RIP_JOURNAL_FORMAT_H
+#define RIP_JOURNAL_FORMAT_H
+
+#include <cstdint>
+
+namespace ns3 {
+
+/**
+ * \brief Layout of a RIP route-change journal.
+ *
+ * A 16-byte header (u32 magic "RIPJ", u32 version, u32 record size, u32
+ * reserved) followed by fixed-size records in time order. Replaying the
+ * records of a node up to a time rebuilds its table at that time. Integers
+ * are in host byte order.
+ *
+ * This header does not depend on ns-3 so offline tools can include it.
+ */
+struct RipJournalRecord
+{
+  enum Type
+  {
+    ADDED = 1,
+    CHANGED = 2,
+    WITHDRAWN = 3
+  };
+
+  static const uint32_t MAGIC = 0x4a504952; // "RIPJ"
+  static const uint32_t VERSION = 1;
+
+  uint64_t timeNs;
+  uint32_t node;
+  uint32_t destination;
+  uint32_t gateway;     ///< new gateway, or the last one for WITHDRAWN
+  uint32_t interface;   ///< new interface, or the last one for WITHDRAWN
+  uint8_t prefix;
+  uint8_t type;
+  uint8_t metric;       ///< new metric, or the last one for WITHDRAWN
+  uint8_t reserved[5];
+};
+
+static_assert (sizeof (RipJournalRecord) == 32, "journal records must stay 32 bytes");
+
+} // namespace ns3
+
+#endif /* RIP_JOURNAL_FORMAT_H */
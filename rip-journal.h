@@ -0,0 +1,114 @@
+#ifndef RIP_JOURNAL_H
+#define RIP_JOURNAL_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "rip-journal-format.h"
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief Append-only journal of every RIP route addition, change and
+ * withdrawal, fed by a RipTableWatcher.
+ *
+ * Records are fixed-size and collected in a preallocated buffer that is
+ * written out with a single fwrite whenever it fills up, so journaling costs
+ * one struct copy per route change.
+ */
+class RipJournal
+{
+public:
+  RipJournal (RipTableWatcher &watcher, const std::string &path, size_t bufferRecords = 65536);
+  ~RipJournal ();
+
+  void Close (void);
+  uint64_t GetNRecords (void) const;
+
+private:
+  void RouteChanged (uint32_t nodeId, const RipRoute *oldRoute, const RipRoute *newRoute);
+  void Flush (void);
+
+  FILE *m_file;
+  std::string m_path;
+  std::vector<RipJournalRecord> m_buffer;
+  size_t m_used;
+  uint64_t m_nRecords;
+};
+
+inline
+RipJournal::RipJournal (RipTableWatcher &watcher, const std::string &path, size_t bufferRecords)
+  : m_path (path),
+    m_buffer (bufferRecords),
+    m_used (0),
+    m_nRecords (0)
+{
+  m_file = std::fopen (path.c_str (), "wb");
+  NS_ABORT_MSG_IF (m_file == 0, "Cannot write RIP journal " << path);
+  uint32_t header[4] = { RipJournalRecord::MAGIC, RipJournalRecord::VERSION, sizeof (RipJournalRecord), 0 };
+  std::fwrite (header, sizeof (header), 1, m_file);
+  watcher.AddRouteChangedCallback (MakeCallback (&RipJournal::RouteChanged, this));
+}
+
+inline
+RipJournal::~RipJournal ()
+{
+  Close ();
+}
+
+inline void
+RipJournal::RouteChanged (uint32_t nodeId, const RipRoute *oldRoute, const RipRoute *newRoute)
+{
+  if (m_file == 0)
+    {
+      return;
+    }
+  const RipRoute *route = newRoute != 0 ? newRoute : oldRoute;
+  RipJournalRecord &rec = m_buffer[m_used++];
+  rec.timeNs = Simulator::Now ().GetNanoSeconds ();
+  rec.node = nodeId;
+  rec.destination = route->destination;
+  rec.gateway = route->gateway;
+  rec.interface = route->interface;
+  rec.prefix = Ipv4Mask (route->mask).GetPrefixLength ();
+  rec.type = oldRoute == 0 ? RipJournalRecord::ADDED : (newRoute == 0 ? RipJournalRecord::WITHDRAWN : RipJournalRecord::CHANGED);
+  rec.metric = route->metric;
+  std::memset (rec.reserved, 0, sizeof (rec.reserved));
+  ++m_nRecords;
+  if (m_used == m_buffer.size ())
+    {
+      Flush ();
+    }
+}
+
+inline void
+RipJournal::Flush (void)
+{
+  NS_ABORT_MSG_IF (std::fwrite (m_buffer.data (), sizeof (RipJournalRecord), m_used, m_file) != m_used,
+                   "Write to RIP journal " << m_path << " failed");
+  m_used = 0;
+}
+
+inline void
+RipJournal::Close (void)
+{
+  if (m_file != 0)
+    {
+      Flush ();
+      std::fclose (m_file);
+      m_file = 0;
+      std::cout<<"INFO: RIP journal "<<m_path<<" holds "<<m_nRecords<<" route changes\n";
+    }
+}
+
+inline uint64_t
+RipJournal::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+} // namespace ns3
+
+#endif /* RIP_JOURNAL_H */
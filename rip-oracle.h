@@ -0,0 +1,492 @@
+#ifndef RIP_ORACLE_H
+#define RIP_ORACLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "rip-snapshot.h"
+
+namespace ns3 {
+
+/**
+ * \brief Checks RIP tables against the hop-count shortest paths of the
+ * live topology.
+ *
+ * Capture() reads the topology as RIP sees it at that instant: the routers
+ * that run RIP, the networks on their interfaces that are up, and which
+ * routers are neighbours, i.e. share a network on up interfaces RIP is not
+ * excluded from. A link taken down by the fault schedule has both ends down
+ * and is gone. Failures below IP (a node moved out of radio range) are not
+ * seen.
+ *
+ * Check() runs one multi-source breadth-first search per network, from the
+ * routers attached to it, over a CSR adjacency of the routers, with the
+ * networks spread over a pool of threads. With interface metrics of 1 a
+ * router h hops from the nearest attached router should reach the network
+ * with metric h + 1 through a neighbour h - 1 hops away. Every route with a
+ * metric below 16 is
+ *
+ *  - ok
+ *  - wrong metric
+ *  - wrong next hop: the right metric, but the gateway is not on a
+ *    shortest path
+ *  - stale: the network no longer exists, or is unreachable or 15 or more
+ *    hops away from the router, a count-to-infinity leftover
+ *
+ * and every router that can reach a network it has no route to is missing
+ * one. Routes with metric 16 are only counted, as poisoned.
+ *
+ * A search stops at the RIP horizon of 15 hops, so it covers the routers
+ * that should have a route to the network: the work is the size of a
+ * converged snapshot times the average degree, split over the threads.
+ */
+class RipOracle
+{
+public:
+  struct Report
+  {
+    Report ();
+    void Add (const Report &other);
+    uint64_t GetNErrors (void) const;
+
+    uint32_t routers;
+    uint32_t networks;
+    uint64_t routes;
+    uint64_t ok;
+    uint64_t wrongMetric;
+    uint64_t wrongNextHop;
+    uint64_t stale;
+    uint64_t missing;
+    uint64_t poisoned;
+    std::vector<std::string> examples; // at most MAX_EXAMPLES
+  };
+
+  static const uint32_t MAX_EXAMPLES = 50;
+
+  /// \param threads search threads, 0 for one per core
+  RipOracle (uint32_t threads = 0);
+
+  void Capture (NodeContainer routers);
+  Report Check (const RipSnapshot &snapshot) const;
+
+  /// Capture and check at a time; the report goes to "<prefix>-<seconds>s.txt".
+  void Schedule (Time at, NodeContainer routers, const std::string &prefix);
+  /// The report of the latest scheduled check.
+  const Report &GetLastReport (void) const;
+
+private:
+  enum
+  {
+    NONE = 0xffffffff,
+    INFINITY_METRIC = 16
+  };
+
+  struct Network
+  {
+    uint32_t address;
+    uint8_t prefix;
+  };
+
+  void Validate (NodeContainer routers, std::string path);
+  void Search (const RipSnapshot &snapshot, const std::vector<uint32_t> &rowOffset, const std::vector<uint32_t> &rows,
+               std::atomic<uint32_t> *next, Report *report) const;
+  std::string Describe (const char *kind, const RipSnapshot &snapshot, uint32_t row, uint32_t expected) const;
+  static uint64_t Key (uint32_t address, uint8_t prefix);
+
+  uint32_t m_threads;
+  std::vector<uint32_t> m_nodeIds;  // by router index
+  std::vector<uint32_t> m_routerOf; // by node id, or NONE
+  std::unordered_map<uint32_t, uint32_t> m_addressOwner;
+  std::vector<Network> m_networks;
+  std::unordered_map<uint64_t, uint32_t> m_networkOf;
+  std::vector<uint32_t> m_attachedOffset; // CSR: routers on network k at m_attachedOffset[k] .. [k + 1]
+  std::vector<uint32_t> m_attached;
+  std::vector<uint32_t> m_offset;         // CSR: neighbours of router v at m_offset[v] .. [v + 1]
+  std::vector<uint32_t> m_neighbor;
+  Report m_last;
+};
+
+inline
+RipOracle::Report::Report ()
+  : routers (0),
+    networks (0),
+    routes (0),
+    ok (0),
+    wrongMetric (0),
+    wrongNextHop (0),
+    stale (0),
+    missing (0),
+    poisoned (0)
+{
+}
+
+inline void
+RipOracle::Report::Add (const Report &other)
+{
+  ok += other.ok;
+  wrongMetric += other.wrongMetric;
+  wrongNextHop += other.wrongNextHop;
+  stale += other.stale;
+  missing += other.missing;
+  poisoned += other.poisoned;
+  for (size_t i = 0; i < other.examples.size () && examples.size () < MAX_EXAMPLES; ++i)
+    {
+      examples.push_back (other.examples[i]);
+    }
+}
+
+inline uint64_t
+RipOracle::Report::GetNErrors (void) const
+{
+  return wrongMetric + wrongNextHop + stale + missing;
+}
+
+inline
+RipOracle::RipOracle (uint32_t threads)
+  : m_threads (threads != 0 ? threads : std::max (1u, std::thread::hardware_concurrency ()))
+{
+}
+
+inline uint64_t
+RipOracle::Key (uint32_t address, uint8_t prefix)
+{
+  return (uint64_t (address) << 8) | prefix;
+}
+
+inline void
+RipOracle::Capture (NodeContainer routers)
+{
+  m_nodeIds.clear ();
+  m_routerOf.assign (NodeList::GetNNodes (), NONE);
+  m_addressOwner.clear ();
+  m_networks.clear ();
+  m_networkOf.clear ();
+
+  // (network, router, RIP runs on the interface)
+  std::vector<std::pair<uint32_t, std::pair<uint32_t, bool> > > attachments;
+  for (NodeContainer::Iterator it = routers.Begin (); it != routers.End (); ++it)
+    {
+      Ptr<Rip> rip = RipTableWatcher::GetRip (*it);
+      if (rip == 0 || m_routerOf[(*it)->GetId ()] != NONE)
+        {
+          continue;
+        }
+      uint32_t router = m_nodeIds.size ();
+      m_nodeIds.push_back ((*it)->GetId ());
+      m_routerOf[(*it)->GetId ()] = router;
+      std::set<uint32_t> excluded = rip->GetInterfaceExclusions ();
+      Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4> ();
+      for (uint32_t i = 1; i < ipv4->GetNInterfaces (); ++i)
+        {
+          if (!ipv4->IsUp (i))
+            {
+              continue;
+            }
+          for (uint32_t a = 0; a < ipv4->GetNAddresses (i); ++a)
+            {
+              Ipv4InterfaceAddress address = ipv4->GetAddress (i, a);
+              Network network;
+              network.address = address.GetLocal ().CombineMask (address.GetMask ()).Get ();
+              network.prefix = address.GetMask ().GetPrefixLength ();
+              std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> known =
+                m_networkOf.insert (std::make_pair (Key (network.address, network.prefix), m_networks.size ()));
+              if (known.second)
+                {
+                  m_networks.push_back (network);
+                }
+              m_addressOwner[address.GetLocal ().Get ()] = router;
+              attachments.push_back (std::make_pair (known.first->second, std::make_pair (router, excluded.count (i) == 0)));
+            }
+        }
+    }
+
+  std::sort (attachments.begin (), attachments.end ());
+  m_attachedOffset.assign (m_networks.size () + 1, 0);
+  m_attached.resize (attachments.size ());
+  for (size_t k = 0; k < attachments.size (); ++k)
+    {
+      m_attachedOffset[attachments[k].first + 1]++;
+      m_attached[k] = attachments[k].second.first;
+    }
+  for (size_t n = 0; n < m_networks.size (); ++n)
+    {
+      m_attachedOffset[n + 1] += m_attachedOffset[n];
+    }
+
+  // Routers speaking RIP on the same network are neighbours.
+  std::vector<std::pair<uint32_t, uint32_t> > edges;
+  for (size_t begin = 0; begin < attachments.size (); )
+    {
+      size_t end = begin;
+      while (end < attachments.size () && attachments[end].first == attachments[begin].first)
+        {
+          ++end;
+        }
+      for (size_t a = begin; a < end; ++a)
+        {
+          for (size_t b = begin; b < end; ++b)
+            {
+              if (a != b && attachments[a].second.second && attachments[b].second.second)
+                {
+                  edges.push_back (std::make_pair (attachments[a].second.first, attachments[b].second.first));
+                }
+            }
+        }
+      begin = end;
+    }
+  std::sort (edges.begin (), edges.end ());
+  m_offset.assign (m_nodeIds.size () + 1, 0);
+  m_neighbor.resize (edges.size ());
+  for (size_t k = 0; k < edges.size (); ++k)
+    {
+      m_offset[edges[k].first + 1]++;
+      m_neighbor[k] = edges[k].second;
+    }
+  for (size_t v = 0; v < m_nodeIds.size (); ++v)
+    {
+      m_offset[v + 1] += m_offset[v];
+    }
+}
+
+inline RipOracle::Report
+RipOracle::Check (const RipSnapshot &snapshot) const
+{
+  Report report;
+  report.routers = m_nodeIds.size ();
+  report.networks = m_networks.size ();
+  report.routes = snapshot.GetNRoutes ();
+
+  // Group the rows by network; rows for networks that are gone are stale
+  // unless poisoned.
+  std::vector<uint32_t> network (snapshot.GetNRoutes (), NONE);
+  std::vector<uint32_t> rowOffset (m_networks.size () + 1, 0);
+  for (size_t row = 0; row < snapshot.GetNRoutes (); ++row)
+    {
+      if (snapshot.node[row] >= m_routerOf.size () || m_routerOf[snapshot.node[row]] == NONE)
+        {
+          continue;
+        }
+      std::unordered_map<uint64_t, uint32_t>::const_iterator it =
+        m_networkOf.find (Key (snapshot.destination[row], snapshot.prefix[row]));
+      if (it != m_networkOf.end ())
+        {
+          network[row] = it->second;
+          rowOffset[it->second + 1]++;
+        }
+      else if (snapshot.metric[row] >= INFINITY_METRIC)
+        {
+          ++report.poisoned;
+        }
+      else
+        {
+          ++report.stale;
+          if (report.examples.size () < MAX_EXAMPLES)
+            {
+              report.examples.push_back (Describe ("stale", snapshot, row, INFINITY_METRIC));
+            }
+        }
+    }
+  for (size_t n = 0; n < m_networks.size (); ++n)
+    {
+      rowOffset[n + 1] += rowOffset[n];
+    }
+  std::vector<uint32_t> rows (rowOffset.back ());
+  std::vector<uint32_t> fill (rowOffset.begin (), rowOffset.end () - 1);
+  for (size_t row = 0; row < snapshot.GetNRoutes (); ++row)
+    {
+      if (network[row] != NONE)
+        {
+          rows[fill[network[row]]++] = row;
+        }
+    }
+
+  std::atomic<uint32_t> next (0);
+  uint32_t nThreads = std::min<uint32_t> (m_threads, std::max<size_t> (1, m_networks.size ()));
+  std::vector<Report> partial (nThreads);
+  std::vector<std::thread> threads;
+  for (uint32_t t = 1; t < nThreads; ++t)
+    {
+      threads.push_back (std::thread (&RipOracle::Search, this, std::cref (snapshot), std::cref (rowOffset),
+                                      std::cref (rows), &next, &partial[t]));
+    }
+  Search (snapshot, rowOffset, rows, &next, &partial[0]);
+  for (size_t t = 0; t < threads.size (); ++t)
+    {
+      threads[t].join ();
+    }
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      report.Add (partial[t]);
+    }
+  return report;
+}
+
+inline void
+RipOracle::Search (const RipSnapshot &snapshot, const std::vector<uint32_t> &rowOffset, const std::vector<uint32_t> &rows,
+                   std::atomic<uint32_t> *next, Report *report) const
+{
+  std::vector<uint32_t> distance (m_nodeIds.size (), NONE);
+  std::vector<uint32_t> routed (m_nodeIds.size (), NONE); // network a router was last seen with a route to
+  std::vector<uint32_t> queue;
+  queue.reserve (m_nodeIds.size ());
+  for (uint32_t n = (*next)++; n < m_networks.size (); n = (*next)++)
+    {
+      for (size_t q = 0; q < queue.size (); ++q)
+        {
+          distance[queue[q]] = NONE;
+        }
+      queue.clear ();
+      for (uint32_t k = m_attachedOffset[n]; k < m_attachedOffset[n + 1]; ++k)
+        {
+          if (distance[m_attached[k]] == NONE)
+            {
+              distance[m_attached[k]] = 0;
+              queue.push_back (m_attached[k]);
+            }
+        }
+      // Stop where the metric would reach infinity; RIP cannot route further.
+      for (size_t head = 0; head < queue.size () && distance[queue[head]] + 2 < INFINITY_METRIC; ++head)
+        {
+          uint32_t v = queue[head];
+          for (uint32_t k = m_offset[v]; k < m_offset[v + 1]; ++k)
+            {
+              if (distance[m_neighbor[k]] == NONE)
+                {
+                  distance[m_neighbor[k]] = distance[v] + 1;
+                  queue.push_back (m_neighbor[k]);
+                }
+            }
+        }
+
+      for (uint32_t k = rowOffset[n]; k < rowOffset[n + 1]; ++k)
+        {
+          uint32_t row = rows[k];
+          uint32_t router = m_routerOf[snapshot.node[row]];
+          uint32_t hops = distance[router];
+          const char *kind = 0;
+          if (snapshot.metric[row] >= INFINITY_METRIC)
+            {
+              ++report->poisoned;
+              continue;
+            }
+          if (hops == NONE)
+            {
+              ++report->stale;
+              kind = "stale";
+            }
+          else if (snapshot.metric[row] != hops + 1)
+            {
+              ++report->wrongMetric;
+              kind = "wrong-metric";
+            }
+          else if (hops > 0)
+            {
+              std::unordered_map<uint32_t, uint32_t>::const_iterator gateway = m_addressOwner.find (snapshot.gateway[row]);
+              if (gateway == m_addressOwner.end () || distance[gateway->second] + 1 != hops)
+                {
+                  ++report->wrongNextHop;
+                  kind = "wrong-next-hop";
+                }
+            }
+          if (hops != NONE)
+            {
+              routed[router] = n;
+            }
+          if (kind == 0)
+            {
+              ++report->ok;
+            }
+          else if (report->examples.size () < MAX_EXAMPLES)
+            {
+              report->examples.push_back (Describe (kind, snapshot, row, hops == NONE ? INFINITY_METRIC : hops + 1));
+            }
+        }
+
+      for (size_t q = 0; q < queue.size (); ++q)
+        {
+          if (routed[queue[q]] != n)
+            {
+              ++report->missing;
+              if (report->examples.size () < MAX_EXAMPLES)
+                {
+                  std::ostringstream os;
+                  os << "missing node " << m_nodeIds[queue[q]] << " " << Ipv4Address (m_networks[n].address) << "/"
+                     << uint32_t (m_networks[n].prefix) << " expected metric " << distance[queue[q]] + 1;
+                  report->examples.push_back (os.str ());
+                }
+            }
+        }
+    }
+}
+
+inline std::string
+RipOracle::Describe (const char *kind, const RipSnapshot &snapshot, uint32_t row, uint32_t expected) const
+{
+  std::ostringstream os;
+  os << kind << " node " << snapshot.node[row] << " " << Ipv4Address (snapshot.destination[row]) << "/"
+     << uint32_t (snapshot.prefix[row]) << " via " << Ipv4Address (snapshot.gateway[row]) << " metric "
+     << uint32_t (snapshot.metric[row]) << " expected metric " << expected;
+  return os.str ();
+}
+
+inline void
+RipOracle::Schedule (Time at, NodeContainer routers, const std::string &prefix)
+{
+  std::ostringstream path;
+  path << prefix << "-" << at.GetSeconds () << "s.txt";
+  Simulator::Schedule (at, &RipOracle::Validate, this, routers, path.str ());
+}
+
+inline const RipOracle::Report &
+RipOracle::GetLastReport (void) const
+{
+  return m_last;
+}
+
+inline void
+RipOracle::Validate (NodeContainer routers, std::string path)
+{
+  uint32_t nRouters;
+  RipSnapshot snapshot = TakeRipSnapshot (routers, nRouters);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Capture (routers);
+  m_last = Check (snapshot);
+  double checkMs = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+
+  std::ofstream os (path.c_str ());
+  NS_ABORT_MSG_UNLESS (os, "Cannot write RIP oracle report " << path);
+  os << "time_s=" << Simulator::Now ().GetSeconds () << "\n"
+     << "routers=" << m_last.routers << "\n"
+     << "networks=" << m_last.networks << "\n"
+     << "routes=" << m_last.routes << "\n"
+     << "ok=" << m_last.ok << "\n"
+     << "wrongMetric=" << m_last.wrongMetric << "\n"
+     << "wrongNextHop=" << m_last.wrongNextHop << "\n"
+     << "stale=" << m_last.stale << "\n"
+     << "missing=" << m_last.missing << "\n"
+     << "poisoned=" << m_last.poisoned << "\n"
+     << "checkMs=" << checkMs << "\n";
+  for (size_t i = 0; i < m_last.examples.size (); ++i)
+    {
+      os << "# " << m_last.examples[i] << "\n";
+    }
+  std::cout<<"INFO: RIP oracle at "<<Simulator::Now ().GetSeconds ()<<"s: "<<m_last.ok<<" of "<<m_last.routes
+           <<" routes ok, "<<m_last.wrongMetric<<" wrong metric, "<<m_last.wrongNextHop<<" wrong next hop, "
+           <<m_last.stale<<" stale, "<<m_last.missing<<" missing ("<<checkMs<<" ms on "<<m_threads
+           <<" threads), see "<<path<<"\n";
+}
+
+} // namespace ns3
+
+#endif /* RIP_ORACLE_H */
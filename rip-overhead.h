@@ -0,0 +1,347 @@
+#ifndef RIP_OVERHEAD_H
+#define RIP_OVERHEAD_H
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief RIP messages and bytes per router interface and time bucket.
+ *
+ * Hooks the Ipv4L3Protocol Tx and Rx traces of the routers. A RIP packet
+ * is recognised and classified from its raw bytes, copied into a stack
+ * buffer, so counting does not allocate per packet. Each message counts
+ * as one of four kinds:
+ *
+ *  - request
+ *  - reply: a response unicast to a requester
+ *  - periodic: a multicast response sent at least UnsolicitedRoutingUpdate
+ *    after the router's previous periodic one
+ *  - triggered: any other multicast response
+ *
+ * ns3::Rip does not mark its periodic updates, and the packets cannot tell
+ * them apart either: a triggered update carries the changed routes, which
+ * after a failure may be the whole table. ns3::Rip sends its periodic
+ * update UnsolicitedRoutingUpdate plus up to half that again after the
+ * previous one. A triggered update that falls in this jitter window, before
+ * the periodic one, is counted as periodic, and the periodic update that
+ * follows as triggered. The two kinds swap at most once per router and
+ * cycle, and only then. Totals over both kinds, bytes and route entries
+ * are exact.
+ *
+ * Received messages inherit the kind their sender gave them (triggered if
+ * the sender is not counted, e.g. on another MPI rank). The route
+ * entries of responses are counted, as are poisoned ones (metric 16).
+ *
+ * Counters are kept only for the buckets in which an interface had RIP
+ * traffic, so memory follows the traffic rather than run length times
+ * interfaces. Write(path) produces one CSV row per interface, bucket and
+ * direction with traffic:
+ *
+ *     time_s,node,interface,direction,requests,replies,periodic,triggered,bytes,rtes,poisoned
+ */
+class RipOverhead
+{
+public:
+  enum Direction
+  {
+    TX = 0,
+    RX = 1
+  };
+
+  enum Kind
+  {
+    REQUEST = 0,
+    REPLY = 1,
+    PERIODIC = 2,
+    TRIGGERED = 3
+  };
+
+  struct Counters
+  {
+    Counters ();
+    void Add (const Counters &other);
+
+    uint64_t messages[4]; // by Kind
+    uint64_t bytes;       // IP packets, headers included
+    uint64_t rtes;
+    uint64_t poisoned;
+  };
+
+  RipOverhead (Time bucket = Seconds (10));
+
+  /// Count the RIP traffic of these routers; routers already counted are skipped.
+  void Connect (NodeContainer routers);
+  /// Totals from this time on are also kept apart; see GetTotal.
+  void NotifyFailureAt (Time at);
+
+  void Write (const std::string &path) const;
+  /// Sum over all interfaces, optionally only from the first failure on.
+  Counters GetTotal (Direction direction, bool afterFailure = false) const;
+
+private:
+  struct Router
+  {
+    Router () : firstSlot (0), nSlots (0), lastPeriodic (-1), interval (0) {}
+    uint32_t firstSlot;
+    uint32_t nSlots;
+    int64_t lastPeriodic; // time step, -1 before the first
+    int64_t interval;
+  };
+
+  /// The counters of one interface in one bucket.
+  struct Cell
+  {
+    Cell () : bucket (0) {}
+    uint32_t bucket;
+    Counters counts[2]; // by Direction
+  };
+
+  static const uint32_t BUFFER = 1600;    // an Ethernet MTU
+  static const uint32_t KIND_CACHE = 4096; // sent packets remembered for their receivers
+
+  static void TxSeen (RipOverhead *overhead, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  static void RxSeen (RipOverhead *overhead, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void Count (Direction direction, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  Time m_bucket;
+  std::vector<Router> m_routers;  // by node id
+  uint32_t m_nSlots;              // interfaces of all routers
+  std::vector<uint32_t> m_slotNode;       // node id of each slot
+  std::vector<std::vector<Cell> > m_cells; // by slot, buckets ascending
+  uint64_t m_nCells;
+  std::vector<uint64_t> m_kindUid;
+  std::vector<uint8_t> m_kind;
+  Time m_firstFailure;
+  bool m_hasFailure;
+  Counters m_total[2][2]; // [after failure][direction]
+};
+
+inline
+RipOverhead::Counters::Counters ()
+  : bytes (0),
+    rtes (0),
+    poisoned (0)
+{
+  for (int k = 0; k < 4; ++k)
+    {
+      messages[k] = 0;
+    }
+}
+
+inline void
+RipOverhead::Counters::Add (const Counters &other)
+{
+  for (int k = 0; k < 4; ++k)
+    {
+      messages[k] += other.messages[k];
+    }
+  bytes += other.bytes;
+  rtes += other.rtes;
+  poisoned += other.poisoned;
+}
+
+inline
+RipOverhead::RipOverhead (Time bucket)
+  : m_bucket (bucket),
+    m_nSlots (0),
+    m_nCells (0),
+    m_kindUid (KIND_CACHE, ~uint64_t (0)),
+    m_kind (KIND_CACHE, 0),
+    m_hasFailure (false)
+{
+}
+
+inline void
+RipOverhead::Connect (NodeContainer routers)
+{
+  NS_ABORT_MSG_UNLESS (m_nCells == 0, "RipOverhead: connect all routers before the simulation starts");
+  for (NodeContainer::Iterator it = routers.Begin (); it != routers.End (); ++it)
+    {
+      Ptr<Rip> rip = RipTableWatcher::GetRip (*it);
+      uint32_t id = (*it)->GetId ();
+      if (rip == 0 || (id < m_routers.size () && m_routers[id].nSlots != 0))
+        {
+          continue;
+        }
+      if (id >= m_routers.size ())
+        {
+          m_routers.resize (NodeList::GetNNodes ());
+        }
+      TimeValue interval;
+      rip->GetAttribute ("UnsolicitedRoutingUpdate", interval);
+      Ptr<Ipv4L3Protocol> l3 = (*it)->GetObject<Ipv4L3Protocol> ();
+      Router &router = m_routers[id];
+      router.firstSlot = m_nSlots;
+      router.nSlots = l3->GetNInterfaces ();
+      router.interval = interval.Get ().GetTimeStep ();
+      m_nSlots += router.nSlots;
+      m_slotNode.resize (m_nSlots, id);
+      m_cells.resize (m_nSlots);
+      l3->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&RipOverhead::TxSeen, this));
+      l3->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&RipOverhead::RxSeen, this));
+    }
+}
+
+inline void
+RipOverhead::NotifyFailureAt (Time at)
+{
+  if (!m_hasFailure || at < m_firstFailure)
+    {
+      m_firstFailure = at;
+      m_hasFailure = true;
+    }
+}
+
+inline void
+RipOverhead::TxSeen (RipOverhead *overhead, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  overhead->Count (TX, packet, ipv4, interface);
+}
+
+inline void
+RipOverhead::RxSeen (RipOverhead *overhead, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  overhead->Count (RX, packet, ipv4, interface);
+}
+
+inline void
+RipOverhead::Count (Direction direction, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  uint8_t buf[BUFFER];
+  uint32_t size = packet->CopyData (buf, BUFFER);
+  if (size < 20)
+    {
+      return;
+    }
+  uint32_t ihl = (buf[0] & 0x0f) * 4;
+  if (buf[9] != UdpL4Protocol::PROT_NUMBER || size < ihl + 12 || ((buf[ihl + 2] << 8) | buf[ihl + 3]) != 520)
+    {
+      return;
+    }
+
+  Router &router = m_routers[ipv4->GetObject<Node> ()->GetId ()];
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  uint8_t command = buf[ihl + 8];
+  uint32_t nRtes = (size - ihl - 12) / 20;
+  Kind kind;
+  if (command == 1)
+    {
+      kind = REQUEST;
+    }
+  else if (buf[16] < 224 || buf[16] > 239)
+    {
+      kind = REPLY;
+    }
+  else if (direction == TX)
+    {
+      bool periodic = router.lastPeriodic < 0 || now == router.lastPeriodic || now - router.lastPeriodic >= router.interval;
+      if (periodic)
+        {
+          router.lastPeriodic = now;
+        }
+      kind = periodic ? PERIODIC : TRIGGERED;
+    }
+  else
+    {
+      uint32_t entry = packet->GetUid () % KIND_CACHE;
+      kind = m_kindUid[entry] == packet->GetUid () ? Kind (m_kind[entry]) : TRIGGERED;
+    }
+  if (direction == TX)
+    {
+      uint32_t entry = packet->GetUid () % KIND_CACHE;
+      m_kindUid[entry] = packet->GetUid ();
+      m_kind[entry] = kind;
+    }
+
+  Counters add;
+  add.messages[kind] = 1;
+  add.bytes = packet->GetSize ();
+  if (command == 2)
+    {
+      add.rtes = nRtes;
+      for (uint32_t r = 0; r < nRtes; ++r)
+        {
+          const uint8_t *metric = buf + ihl + 12 + r * 20 + 16;
+          add.poisoned += (uint32_t (metric[0]) << 24 | metric[1] << 16 | metric[2] << 8 | metric[3]) >= 16;
+        }
+    }
+
+  // Time only moves forward, so a new bucket is always the last one.
+  uint32_t bucket = now / m_bucket.GetTimeStep ();
+  std::vector<Cell> &cells = m_cells[router.firstSlot + std::min (interface, router.nSlots - 1)];
+  if (cells.empty () || cells.back ().bucket != bucket)
+    {
+      cells.push_back (Cell ());
+      cells.back ().bucket = bucket;
+      ++m_nCells;
+    }
+  cells.back ().counts[direction].Add (add);
+  m_total[m_hasFailure && now >= m_firstFailure.GetTimeStep ()][direction].Add (add);
+}
+
+inline RipOverhead::Counters
+RipOverhead::GetTotal (Direction direction, bool afterFailure) const
+{
+  Counters total = m_total[1][direction];
+  if (!afterFailure)
+    {
+      total.Add (m_total[0][direction]);
+    }
+  return total;
+}
+
+inline void
+RipOverhead::Write (const std::string &path) const
+{
+  std::ofstream os (path.c_str ());
+  NS_ABORT_MSG_UNLESS (os, "Cannot write RIP overhead file " << path);
+  os << "time_s,node,interface,direction,requests,replies,periodic,triggered,bytes,rtes,poisoned\n";
+  // Rows go by bucket, then node and interface: sort (bucket, node, slot,
+  // cell) keys of the cells that have traffic.
+  std::vector<std::pair<std::pair<uint32_t, uint32_t>, std::pair<uint32_t, uint32_t> > > order;
+  order.reserve (m_nCells);
+  uint32_t nBuckets = 0;
+  for (uint32_t slot = 0; slot < m_nSlots; ++slot)
+    {
+      for (uint32_t k = 0; k < m_cells[slot].size (); ++k)
+        {
+          uint32_t bucket = m_cells[slot][k].bucket;
+          order.push_back (std::make_pair (std::make_pair (bucket, m_slotNode[slot]), std::make_pair (slot, k)));
+          nBuckets = std::max (nBuckets, bucket + 1);
+        }
+    }
+  std::sort (order.begin (), order.end ());
+  for (size_t n = 0; n < order.size (); ++n)
+    {
+      uint32_t node = order[n].first.second;
+      uint32_t slot = order[n].second.first;
+      const Cell &cell = m_cells[slot][order[n].second.second];
+      for (int d = 0; d < 2; ++d)
+        {
+          const Counters &c = cell.counts[d];
+          if (c.bytes == 0)
+            {
+              continue;
+            }
+          os << m_bucket.GetSeconds () * cell.bucket << "," << node << "," << slot - m_routers[node].firstSlot << ","
+             << (d == TX ? "tx" : "rx") << "," << c.messages[REQUEST] << "," << c.messages[REPLY] << ","
+             << c.messages[PERIODIC] << "," << c.messages[TRIGGERED] << "," << c.bytes << "," << c.rtes << ","
+             << c.poisoned << "\n";
+        }
+    }
+  std::cout<<"INFO: RIP overhead of "<<m_nSlots<<" interfaces in "<<nBuckets<<" buckets ("<<m_nCells
+           <<" with traffic) written to "<<path<<"\n";
+}
+
+} // namespace ns3
+
+#endif /* RIP_OVERHEAD_H */
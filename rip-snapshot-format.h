@@ -0,0 +1,241 @@
+#ifndef RIP_SNAPSHOT_FORMAT_H
+#define RIP_SNAPSHOT_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Every RIP route of a network at one instant, stored by column.
+ *
+ * Rows are sorted by node, then destination. On disk:
+ *
+ *     u32 magic "RIPS", u32 version, u32 flags, u64 time (ns), u64 rows
+ *     6 x { u64 byte length, column bytes }
+ *
+ * in the column order node, destination, prefix length, gateway, interface,
+ * metric. Uncompressed columns are fixed-width arrays (u32, or u8 for prefix
+ * and metric). With FLAG_COMPRESSED the node, destination, gateway and
+ * interface columns are zigzag varints of the difference to the previous
+ * row (destination restarts at each node), which shrinks a sorted table to
+ * a few bytes per route. Integers are in host byte order.
+ *
+ * This header does not depend on ns-3 so offline tools can include it.
+ */
+struct RipSnapshot
+{
+  static const uint32_t MAGIC = 0x53504952; // "RIPS"
+  static const uint32_t VERSION = 1;
+  static const uint32_t FLAG_COMPRESSED = 1;
+
+  uint64_t timeNs = 0;
+  std::vector<uint32_t> node;
+  std::vector<uint32_t> destination;
+  std::vector<uint8_t> prefix;
+  std::vector<uint32_t> gateway;
+  std::vector<uint32_t> interface;
+  std::vector<uint8_t> metric;
+
+  size_t GetNRoutes (void) const
+  {
+    return node.size ();
+  }
+
+  void Add (uint32_t n, uint32_t dest, uint8_t len, uint32_t gw, uint32_t iface, uint8_t m)
+  {
+    node.push_back (n);
+    destination.push_back (dest);
+    prefix.push_back (len);
+    gateway.push_back (gw);
+    interface.push_back (iface);
+    metric.push_back (m);
+  }
+
+  /// First row of a node, or GetNRoutes() if it has none.
+  size_t FindNode (uint32_t n) const
+  {
+    size_t lo = 0;
+    size_t hi = node.size ();
+    while (lo < hi)
+      {
+        size_t mid = lo + (hi - lo) / 2;
+        if (node[mid] < n)
+          {
+            lo = mid + 1;
+          }
+        else
+          {
+            hi = mid;
+          }
+      }
+    return lo < node.size () && node[lo] == n ? lo : node.size ();
+  }
+
+  bool Write (const std::string &path, bool compress) const;
+  bool Read (const std::string &path, std::string &error);
+
+private:
+  static void PutVarint (std::string &out, int64_t delta)
+  {
+    uint64_t v = (uint64_t (delta) << 1) ^ uint64_t (delta >> 63);
+    while (v >= 0x80)
+      {
+        out.push_back (char (v | 0x80));
+        v >>= 7;
+      }
+    out.push_back (char (v));
+  }
+
+  static bool GetVarint (const std::string &in, size_t &pos, int64_t &delta)
+  {
+    uint64_t v = 0;
+    for (int shift = 0; pos < in.size () && shift < 64; shift += 7)
+      {
+        uint8_t b = in[pos++];
+        v |= uint64_t (b & 0x7f) << shift;
+        if (!(b & 0x80))
+          {
+            delta = int64_t (v >> 1) ^ -int64_t (v & 1);
+            return true;
+          }
+      }
+    return false;
+  }
+
+  std::string EncodeColumn (const std::vector<uint32_t> &col, bool compress, bool resetPerNode) const
+  {
+    std::string out;
+    if (!compress)
+      {
+        out.assign (reinterpret_cast<const char *> (col.data ()), col.size () * sizeof (uint32_t));
+        return out;
+      }
+    int64_t prev = 0;
+    for (size_t i = 0; i < col.size (); ++i)
+      {
+        if (resetPerNode && i > 0 && node[i] != node[i - 1])
+          {
+            prev = 0;
+          }
+        PutVarint (out, int64_t (col[i]) - prev);
+        prev = col[i];
+      }
+    return out;
+  }
+
+  bool DecodeColumn (const std::string &in, std::vector<uint32_t> &col, size_t rows, bool compress, bool resetPerNode) const
+  {
+    if (!compress)
+      {
+        if (in.size () != rows * sizeof (uint32_t))
+          {
+            return false;
+          }
+        col.resize (rows);
+        std::memcpy (col.data (), in.data (), in.size ());
+        return true;
+      }
+    col.resize (rows);
+    size_t pos = 0;
+    int64_t prev = 0;
+    for (size_t i = 0; i < rows; ++i)
+      {
+        if (resetPerNode && i > 0 && node[i] != node[i - 1])
+          {
+            prev = 0;
+          }
+        int64_t delta;
+        if (!GetVarint (in, pos, delta))
+          {
+            return false;
+          }
+        prev += delta;
+        col[i] = uint32_t (prev);
+      }
+    return pos == in.size ();
+  }
+};
+
+inline bool
+RipSnapshot::Write (const std::string &path, bool compress) const
+{
+  std::ofstream os (path.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os)
+    {
+      return false;
+    }
+  uint32_t header[3] = { MAGIC, VERSION, compress ? FLAG_COMPRESSED : 0 };
+  uint64_t rows = GetNRoutes ();
+  os.write (reinterpret_cast<const char *> (header), sizeof (header));
+  os.write (reinterpret_cast<const char *> (&timeNs), sizeof (timeNs));
+  os.write (reinterpret_cast<const char *> (&rows), sizeof (rows));
+
+  std::string columns[6];
+  columns[0] = EncodeColumn (node, compress, false);
+  columns[1] = EncodeColumn (destination, compress, true);
+  columns[2].assign (reinterpret_cast<const char *> (prefix.data ()), prefix.size ());
+  columns[3] = EncodeColumn (gateway, compress, false);
+  columns[4] = EncodeColumn (interface, compress, false);
+  columns[5].assign (reinterpret_cast<const char *> (metric.data ()), metric.size ());
+  for (int c = 0; c < 6; ++c)
+    {
+      uint64_t len = columns[c].size ();
+      os.write (reinterpret_cast<const char *> (&len), sizeof (len));
+      os.write (columns[c].data (), len);
+    }
+  return bool (os);
+}
+
+inline bool
+RipSnapshot::Read (const std::string &path, std::string &error)
+{
+  std::ifstream is (path.c_str (), std::ios::in | std::ios::binary);
+  uint32_t header[3];
+  uint64_t rows;
+  if (!is.read (reinterpret_cast<char *> (header), sizeof (header)) || header[0] != MAGIC)
+    {
+      error = path + " is not a RIP snapshot";
+      return false;
+    }
+  if (header[1] != VERSION)
+    {
+      error = path + " has an unsupported snapshot version";
+      return false;
+    }
+  bool compress = header[2] & FLAG_COMPRESSED;
+  is.read (reinterpret_cast<char *> (&timeNs), sizeof (timeNs));
+  is.read (reinterpret_cast<char *> (&rows), sizeof (rows));
+
+  std::string columns[6];
+  for (int c = 0; c < 6 && is; ++c)
+    {
+      uint64_t len = 0;
+      if (is.read (reinterpret_cast<char *> (&len), sizeof (len)))
+        {
+          columns[c].resize (len);
+          is.read (&columns[c][0], len);
+        }
+    }
+  bool ok = bool (is)
+    && DecodeColumn (columns[0], node, rows, compress, false)
+    && DecodeColumn (columns[1], destination, rows, compress, true)
+    && columns[2].size () == rows && columns[5].size () == rows
+    && DecodeColumn (columns[3], gateway, rows, compress, false)
+    && DecodeColumn (columns[4], interface, rows, compress, false);
+  if (!ok)
+    {
+      error = path + " is truncated or corrupt";
+      return false;
+    }
+  prefix.assign (columns[2].begin (), columns[2].end ());
+  metric.assign (columns[5].begin (), columns[5].end ());
+  return true;
+}
+
+} // namespace ns3
+
+#endif /* RIP_SNAPSHOT_FORMAT_H */
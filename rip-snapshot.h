@@ -0,0 +1,81 @@
+#ifndef RIP_SNAPSHOT_H
+#define RIP_SNAPSHOT_H
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rip-snapshot-format.h"
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief The RIP tables of all routers, now.
+ * \param nRouters set to the number of routers that run RIP
+ *
+ * A RipRouteSource such as RipTrie hands its routes over directly; only
+ * ns3::Rip, which has no accessor, is read back from its printed table.
+ */
+inline RipSnapshot
+TakeRipSnapshot (NodeContainer routers, uint32_t &nRouters)
+{
+  std::vector<std::pair<uint32_t, Ptr<Rip> > > instances;
+  for (NodeContainer::Iterator it = routers.Begin (); it != routers.End (); ++it)
+    {
+      Ptr<Rip> rip = RipTableWatcher::GetRip (*it);
+      if (rip != 0)
+        {
+          instances.push_back (std::make_pair ((*it)->GetId (), rip));
+        }
+    }
+  std::sort (instances.begin (), instances.end ());
+
+  RipSnapshot snapshot;
+  snapshot.timeNs = Simulator::Now ().GetNanoSeconds ();
+  std::vector<RipRoute> table;
+  for (size_t i = 0; i < instances.size (); ++i)
+    {
+      RipTableWatcher::ReadTable (instances[i].second, table);
+      for (size_t r = 0; r < table.size (); ++r)
+        {
+          snapshot.Add (instances[i].first, table[r].destination, Ipv4Mask (table[r].mask).GetPrefixLength (),
+                        table[r].gateway, table[r].interface, table[r].metric);
+        }
+    }
+  nRouters = instances.size ();
+  return snapshot;
+}
+
+/**
+ * \brief Write the RIP tables of all routers to one snapshot file.
+ *
+ * Replaces one RipHelper::PrintRoutingTableAt event per router with a single
+ * event that walks every RIP instance. Read the file back with the
+ * snapshot-reader program.
+ */
+inline void
+WriteRipSnapshot (NodeContainer routers, std::string path, bool compress)
+{
+  uint32_t nRouters;
+  RipSnapshot snapshot = TakeRipSnapshot (routers, nRouters);
+  NS_ABORT_MSG_UNLESS (snapshot.Write (path, compress), "Cannot write RIP snapshot " << path);
+  std::cout<<"INFO: RIP snapshot of "<<nRouters<<" routers, "<<snapshot.GetNRoutes ()
+           <<" routes written to "<<path<<"\n";
+}
+
+/**
+ * \brief Schedule WriteRipSnapshot at a time, into "<prefix>-<seconds>s.snap".
+ */
+inline void
+ScheduleRipSnapshot (Time at, NodeContainer routers, const std::string &prefix, bool compress)
+{
+  std::ostringstream path;
+  path << prefix << "-" << at.GetSeconds () << "s.snap";
+  Simulator::Schedule (at, &WriteRipSnapshot, routers, path.str (), compress);
+}
+
+} // namespace ns3
+
+#endif /* RIP_SNAPSHOT_H */
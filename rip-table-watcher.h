@@ -0,0 +1,407 @@
+#ifndef RIP_TABLE_WATCHER_H
+#define RIP_TABLE_WATCHER_H
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief One valid entry of a RIP routing table.
+ */
+struct RipRoute
+{
+  uint32_t destination;
+  uint32_t mask;
+  uint32_t gateway;
+  uint32_t interface;
+  uint32_t metric;
+};
+
+inline bool
+operator< (const RipRoute &a, const RipRoute &b)
+{
+  return a.destination < b.destination || (a.destination == b.destination && a.mask < b.mask);
+}
+
+/**
+ * \brief A RIP that hands out its valid routes without printing its table.
+ *
+ * ns3::Rip only has PrintRoutingTable, whose text RipTableWatcher::ReadTable
+ * parses back; a RIP implementing this (RipTrie) is read directly instead.
+ */
+class RipRouteSource
+{
+public:
+  virtual ~RipRouteSource () {}
+  /// Replace routes with the valid routes, in any order.
+  virtual void GetRoutes (std::vector<RipRoute> &routes) const = 0;
+};
+
+/**
+ * \brief Follows the RIP tables of a set of routers as they change.
+ *
+ * A router whose RIP has a "TableChanged" trace source (RipTrie) reports
+ * its own changes. ns3::Rip has no accessor or trace for its table, so for
+ * it the watcher hooks the Rx trace of the router's Ipv4L3Protocol and
+ * peeks at the IP and UDP headers of each packet in a stack buffer; a
+ * received RIP message is when such a table changes. Either way the table
+ * is re-read at the end of the time step, through RipRouteSource or
+ * Rip::PrintRoutingTable, and compared with the previous one.
+ *
+ * An ns3::Rip table also changes when an interface goes down or up, which
+ * the fault engine reports through MarkDirty, and when a route times out,
+ * which nothing announces: those tables are also re-read every
+ * pollInterval, so a timeout is seen at most that late.
+ *
+ * Without change callbacks only an order-independent hash of every table is
+ * kept; with them each table is also kept sorted so the individual route
+ * additions, changes and withdrawals can be reported.
+ */
+class RipTableWatcher
+{
+public:
+  /// Called with the node id after its table changed.
+  typedef Callback<void, uint32_t> TableChangedCallback;
+  /// Called with the node id, the old route (0 if added) and the new route (0 if withdrawn).
+  typedef Callback<void, uint32_t, const RipRoute *, const RipRoute *> RouteChangedCallback;
+
+  RipTableWatcher (Time pollInterval = Seconds (5));
+
+  /**
+   * \brief Start following these routers; routers already watched are
+   * skipped. Register the callbacks before the simulation starts.
+   */
+  void Watch (NodeContainer routers);
+  void AddTableChangedCallback (TableChangedCallback cb);
+  void AddRouteChangedCallback (RouteChangedCallback cb);
+
+  /**
+   * \brief Re-read a router's table at the end of the current time step.
+   * Use for changes that RIP does not announce right away, such as an
+   * interface going down or up.
+   */
+  void MarkDirty (uint32_t nodeId);
+
+  uint64_t GetNChanges (void) const;
+
+  static Ptr<Rip> GetRip (Ptr<Node> router);
+  /// The RipRouteSource side of a RIP, or 0 if it only prints its table.
+  static const RipRouteSource *GetRouteSource (Ptr<Rip> rip);
+  /**
+   * \brief Read the valid routes of a router's RIP table, sorted by destination.
+   */
+  static void ReadTable (Ptr<Rip> rip, std::vector<RipRoute> &routes);
+
+private:
+  struct State
+  {
+    State () : source (0), hash (0), pending (false) {}
+    Ptr<Rip> rip;
+    const RipRouteSource *source;
+    uint64_t hash;
+    bool pending;
+    std::vector<RipRoute> table;
+  };
+
+  static bool IsRip (Ptr<const Packet> packet);
+  static uint64_t Mix (uint64_t h);
+  static uint64_t HashLine (const std::string &line);
+  void RipPacketSeen (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void Poll (void);
+  void Check (uint32_t nodeId);
+  void Diff (uint32_t nodeId, const std::vector<RipRoute> &before, const std::vector<RipRoute> &after);
+
+  std::vector<State> m_state; // indexed by node id
+  std::vector<uint32_t> m_polled; // routers without a TableChanged trace
+  std::vector<TableChangedCallback> m_tableChanged;
+  std::vector<RouteChangedCallback> m_routeChanged;
+  uint64_t m_nChanges;
+  Time m_pollInterval;
+  EventId m_poll;
+};
+
+inline
+RipTableWatcher::RipTableWatcher (Time pollInterval)
+  : m_nChanges (0),
+    m_pollInterval (pollInterval)
+{
+}
+
+inline Ptr<Rip>
+RipTableWatcher::GetRip (Ptr<Node> router)
+{
+  Ptr<Ipv4> ipv4 = router->GetObject<Ipv4> ();
+  return ipv4 == 0 ? Ptr<Rip> () : Ipv4RoutingHelper::GetRouting<Rip> (ipv4->GetRoutingProtocol ());
+}
+
+inline const RipRouteSource *
+RipTableWatcher::GetRouteSource (Ptr<Rip> rip)
+{
+  return dynamic_cast<const RipRouteSource *> (PeekPointer (rip));
+}
+
+inline void
+RipTableWatcher::Watch (NodeContainer routers)
+{
+  for (NodeContainer::Iterator it = routers.Begin (); it != routers.End (); ++it)
+    {
+      Ptr<Rip> rip = GetRip (*it);
+      NS_ABORT_MSG_IF (rip == 0, "RipTableWatcher: node " << (*it)->GetId () << " does not run RIP");
+      uint32_t id = (*it)->GetId ();
+      if (id >= m_state.size ())
+        {
+          m_state.resize (NodeList::GetNNodes ());
+        }
+      if (m_state[id].rip != 0)
+        {
+          continue;
+        }
+      m_state[id].rip = rip;
+      m_state[id].source = GetRouteSource (rip);
+      if (!rip->TraceConnectWithoutContext ("TableChanged", MakeCallback (&RipTableWatcher::MarkDirty, this)))
+        {
+          Ptr<Ipv4L3Protocol> l3 = (*it)->GetObject<Ipv4L3Protocol> ();
+          l3->TraceConnectWithoutContext ("Rx", MakeCallback (&RipTableWatcher::RipPacketSeen, this));
+          m_polled.push_back (id);
+        }
+    }
+  if (!m_polled.empty () && !m_poll.IsRunning () && m_pollInterval.IsStrictlyPositive ())
+    {
+      m_poll = Simulator::Schedule (m_pollInterval, &RipTableWatcher::Poll, this);
+    }
+}
+
+inline void
+RipTableWatcher::AddTableChangedCallback (TableChangedCallback cb)
+{
+  m_tableChanged.push_back (cb);
+}
+
+inline void
+RipTableWatcher::AddRouteChangedCallback (RouteChangedCallback cb)
+{
+  m_routeChanged.push_back (cb);
+}
+
+inline uint64_t
+RipTableWatcher::GetNChanges (void) const
+{
+  return m_nChanges;
+}
+
+inline bool
+RipTableWatcher::IsRip (Ptr<const Packet> packet)
+{
+  uint8_t buf[64]; // the longest IP header and the UDP ports
+  uint32_t size = packet->CopyData (buf, sizeof (buf));
+  if (size < 20)
+    {
+      return false;
+    }
+  uint32_t ihl = (buf[0] & 0x0f) * 4;
+  return buf[9] == UdpL4Protocol::PROT_NUMBER && size >= ihl + 4 && ((buf[ihl + 2] << 8) | buf[ihl + 3]) == 520;
+}
+
+inline void
+RipTableWatcher::RipPacketSeen (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (IsRip (packet))
+    {
+      MarkDirty (ipv4->GetObject<Node> ()->GetId ());
+    }
+}
+
+inline void
+RipTableWatcher::MarkDirty (uint32_t nodeId)
+{
+  // The Rx trace fires before RIP has handled the packet; look at the
+  // table once the current event is over.
+  if (nodeId < m_state.size () && m_state[nodeId].rip != 0 && !m_state[nodeId].pending)
+    {
+      m_state[nodeId].pending = true;
+      Simulator::ScheduleNow (&RipTableWatcher::Check, this, nodeId);
+    }
+}
+
+inline void
+RipTableWatcher::Poll (void)
+{
+  for (size_t i = 0; i < m_polled.size (); ++i)
+    {
+      if (!m_state[m_polled[i]].pending)
+        {
+          Check (m_polled[i]);
+        }
+    }
+  m_poll = Simulator::Schedule (m_pollInterval, &RipTableWatcher::Poll, this);
+}
+
+inline uint64_t
+RipTableWatcher::Mix (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+inline uint64_t
+RipTableWatcher::HashLine (const std::string &line)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < line.size (); ++i)
+    {
+      h = (h ^ uint8_t (line[i])) * 0x100000001b3ULL;
+    }
+  return Mix (h);
+}
+
+inline void
+RipTableWatcher::ReadTable (Ptr<Rip> rip, std::vector<RipRoute> &routes)
+{
+  const RipRouteSource *source = GetRouteSource (rip);
+  if (source != 0)
+    {
+      source->GetRoutes (routes);
+      std::sort (routes.begin (), routes.end ());
+      return;
+    }
+  std::ostringstream oss;
+  rip->PrintRoutingTable (Create<OutputStreamWrapper> (&oss));
+  std::istringstream is (oss.str ());
+  std::string line;
+  routes.clear ();
+  bool inTable = false;
+  while (std::getline (is, line))
+    {
+      if (!inTable)
+        {
+          inTable = line.compare (0, 11, "Destination") == 0;
+          continue;
+        }
+      std::istringstream ls (line);
+      std::string dest, gw, mask, flags, ref, use;
+      RipRoute route;
+      if (!(ls >> dest >> gw >> mask >> flags >> route.metric >> ref >> use))
+        {
+          continue;
+        }
+      if (!(ls >> route.interface))
+        {
+          route.interface = 0xffffffff; // interface printed by name
+        }
+      route.destination = Ipv4Address (dest.c_str ()).Get ();
+      route.gateway = Ipv4Address (gw.c_str ()).Get ();
+      route.mask = Ipv4Mask (mask.c_str ()).Get ();
+      routes.push_back (route);
+    }
+  std::sort (routes.begin (), routes.end ());
+}
+
+inline void
+RipTableWatcher::Check (uint32_t nodeId)
+{
+  State &state = m_state[nodeId];
+  state.pending = false;
+
+  uint64_t hash = 0;
+  std::vector<RipRoute> table;
+  if (m_routeChanged.empty () && state.source == 0)
+    {
+      // Sum of per-line hashes: independent of the order RIP keeps its routes in.
+      std::ostringstream oss;
+      state.rip->PrintRoutingTable (Create<OutputStreamWrapper> (&oss));
+      std::istringstream is (oss.str ());
+      std::string line;
+      bool inTable = false;
+      while (std::getline (is, line))
+        {
+          if (inTable)
+            {
+              hash += HashLine (line);
+            }
+          else
+            {
+              inTable = line.compare (0, 11, "Destination") == 0;
+            }
+        }
+    }
+  else
+    {
+      if (m_routeChanged.empty ())
+        {
+          state.source->GetRoutes (table); // the sum below needs no order
+        }
+      else
+        {
+          ReadTable (state.rip, table);
+        }
+      for (size_t i = 0; i < table.size (); ++i)
+        {
+          const RipRoute &r = table[i];
+          hash += Mix ((uint64_t (r.destination) << 32 | r.mask) ^ Mix ((uint64_t (r.gateway) << 32 | r.interface) ^ r.metric));
+        }
+    }
+
+  if (hash == state.hash)
+    {
+      return;
+    }
+  state.hash = hash;
+  ++m_nChanges;
+  if (!m_routeChanged.empty ())
+    {
+      Diff (nodeId, state.table, table);
+      state.table.swap (table);
+    }
+  for (size_t i = 0; i < m_tableChanged.size (); ++i)
+    {
+      m_tableChanged[i] (nodeId);
+    }
+}
+
+inline void
+RipTableWatcher::Diff (uint32_t nodeId, const std::vector<RipRoute> &before, const std::vector<RipRoute> &after)
+{
+  size_t i = 0;
+  size_t j = 0;
+  while (i < before.size () || j < after.size ())
+    {
+      const RipRoute *oldRoute = 0;
+      const RipRoute *newRoute = 0;
+      if (j == after.size () || (i < before.size () && before[i] < after[j]))
+        {
+          oldRoute = &before[i++];
+        }
+      else if (i == before.size () || after[j] < before[i])
+        {
+          newRoute = &after[j++];
+        }
+      else
+        {
+          oldRoute = &before[i++];
+          newRoute = &after[j++];
+          if (oldRoute->gateway == newRoute->gateway && oldRoute->interface == newRoute->interface
+              && oldRoute->metric == newRoute->metric)
+            {
+              continue;
+            }
+        }
+      for (size_t k = 0; k < m_routeChanged.size (); ++k)
+        {
+          m_routeChanged[k] (nodeId, oldRoute, newRoute);
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* RIP_TABLE_WATCHER_H */
@@ -0,0 +1,196 @@
+#ifndef RIP_WARM_START_H
+#define RIP_WARM_START_H
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "rip-snapshot-format.h"
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief Preload converged RIP tables from a snapshot at t=0.
+ *
+ * The checkpoint is an ordinary RIP snapshot (see WriteRipSnapshot) taken
+ * once the tables have converged. ns3::Rip has no call to add a learned
+ * route, so every route is replayed as what RIP would have received: for
+ * each router, interface and gateway one RIP response carrying those routes
+ * is handed to the router's Ipv4L3Protocol as if it had arrived from the
+ * gateway. RIP then installs the routes through its normal path, with the
+ * metric it had at checkpoint time and a fresh timeout. Directly connected
+ * routes are created by RIP itself and are not replayed.
+ *
+ * Timer phases (the periodic update of each router, route timeouts) are
+ * not part of the snapshot; they restart as if every route had just been
+ * refreshed, which is what a converged network looks like anyway.
+ *
+ * Routers without RIP (e.g. owned by another MPI rank) are skipped. A
+ * checkpoint that does not fit the topology (unknown interface, gateway
+ * not on the interface's subnet) aborts the run.
+ */
+class RipWarmStart
+{
+public:
+  RipWarmStart ();
+
+  void Load (const std::string &path);
+  /// Replay the loaded tables once RIP has started, at t=0.
+  void Start (void);
+
+  uint64_t GetNRoutes (void) const;
+  /// Simulated time at which the checkpoint was taken.
+  Time GetCheckpointTime (void) const;
+
+private:
+  void Inject (void);
+  void SendResponse (Ptr<Node> node, uint32_t interface, uint32_t gateway, const RipHeader &response);
+
+  RipSnapshot m_snapshot;
+  std::string m_path;
+  uint64_t m_nInjected;
+};
+
+inline
+RipWarmStart::RipWarmStart ()
+  : m_nInjected (0)
+{
+}
+
+inline void
+RipWarmStart::Load (const std::string &path)
+{
+  std::string error;
+  NS_ABORT_MSG_UNLESS (m_snapshot.Read (path, error), "Cannot read RIP checkpoint: " << error);
+  m_path = path;
+}
+
+inline void
+RipWarmStart::Start (void)
+{
+  if (m_snapshot.GetNRoutes () > 0)
+    {
+      // Nodes initialise RIP from events queued when they were created;
+      // this one comes after them.
+      Simulator::Schedule (Seconds (0), &RipWarmStart::Inject, this);
+    }
+}
+
+inline uint64_t
+RipWarmStart::GetNRoutes (void) const
+{
+  return m_nInjected;
+}
+
+inline Time
+RipWarmStart::GetCheckpointTime (void) const
+{
+  return NanoSeconds (m_snapshot.timeNs);
+}
+
+inline void
+RipWarmStart::Inject (void)
+{
+  uint32_t routers = 0;
+  size_t row = 0;
+  while (row < m_snapshot.GetNRoutes ())
+    {
+      uint32_t nodeId = m_snapshot.node[row];
+      size_t end = row;
+      while (end < m_snapshot.GetNRoutes () && m_snapshot.node[end] == nodeId)
+        {
+          ++end;
+        }
+      NS_ABORT_MSG_IF (nodeId >= NodeList::GetNNodes (), "RIP checkpoint " << m_path << " has node " << nodeId
+                       << " which this topology does not have");
+      Ptr<Node> node = NodeList::GetNode (nodeId);
+      Ptr<Rip> rip = RipTableWatcher::GetRip (node);
+      if (rip == 0)
+        {
+          row = end;
+          continue;
+        }
+
+      // One response per (interface, gateway): the message that gateway
+      // would have sent us.
+      std::map<std::pair<uint32_t, uint32_t>, RipHeader> responses;
+      for (; row < end; ++row)
+        {
+          uint32_t gateway = m_snapshot.gateway[row];
+          uint8_t metric = m_snapshot.metric[row];
+          if (gateway == 0 || metric >= 16)
+            {
+              continue;
+            }
+          uint32_t interface = m_snapshot.interface[row];
+          RipHeader &response = responses[std::make_pair (interface, gateway)];
+          response.SetCommand (RipHeader::RESPONSE);
+          RipRte rte;
+          rte.SetPrefix (Ipv4Address (m_snapshot.destination[row]));
+          rte.SetSubnetMask (Ipv4Mask (m_snapshot.prefix[row] == 0 ? 0 : ~0u << (32 - m_snapshot.prefix[row])));
+          rte.SetRouteTag (0);
+          rte.SetNextHop (Ipv4Address::GetAny ());
+          rte.SetRouteMetric (metric - std::min<uint32_t> (metric, rip->GetInterfaceMetric (interface)));
+          response.AddRte (rte);
+        }
+      for (std::map<std::pair<uint32_t, uint32_t>, RipHeader>::const_iterator it = responses.begin ();
+           it != responses.end (); ++it)
+        {
+          SendResponse (node, it->first.first, it->first.second, it->second);
+          m_nInjected += it->second.GetRteNumber ();
+        }
+      ++routers;
+    }
+  std::cout<<"INFO: Warm start preloaded "<<m_nInjected<<" RIP routes into "<<routers<<" routers from "
+           <<m_path<<" (taken at "<<GetCheckpointTime ().GetSeconds ()<<" s)\n";
+}
+
+inline void
+RipWarmStart::SendResponse (Ptr<Node> node, uint32_t interface, uint32_t gateway, const RipHeader &response)
+{
+  Ptr<Ipv4L3Protocol> l3 = node->GetObject<Ipv4L3Protocol> ();
+  NS_ABORT_MSG_IF (interface == 0 || interface >= l3->GetNInterfaces (), "RIP checkpoint " << m_path << ": node "
+                   << node->GetId () << " has no interface " << interface);
+  Ipv4InterfaceAddress local = l3->GetAddress (interface, 0);
+  Ipv4Address from (gateway);
+  NS_ABORT_MSG_UNLESS (local.GetLocal ().CombineMask (local.GetMask ()) == from.CombineMask (local.GetMask ()),
+                       "RIP checkpoint " << m_path << ": gateway " << from << " of node " << node->GetId ()
+                       << " is not on interface " << interface << "; was it taken from another topology?");
+  Ipv4Address to ("224.0.0.9");
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (response);
+  UdpHeader udp;
+  udp.SetSourcePort (520);
+  udp.SetDestinationPort (520);
+  if (Node::ChecksumEnabled ())
+    {
+      udp.EnableChecksums ();
+      udp.InitializeChecksum (from, to, UdpL4Protocol::PROT_NUMBER);
+    }
+  packet->AddHeader (udp);
+  Ipv4Header ip;
+  ip.SetSource (from);
+  ip.SetDestination (to);
+  ip.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ip.SetPayloadSize (packet->GetSize ());
+  ip.SetTtl (1);
+  if (Node::ChecksumEnabled ())
+    {
+      ip.EnableChecksum ();
+    }
+  packet->AddHeader (ip);
+
+  Ptr<NetDevice> device = l3->GetNetDevice (interface);
+  l3->Receive (device, packet, Ipv4L3Protocol::PROT_NUMBER, device->GetBroadcast (), device->GetMulticast (to),
+               NetDevice::PACKET_MULTICAST);
+}
+
+} // namespace ns3
+
+#endif /* RIP_WARM_START_H */
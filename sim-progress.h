@@ -0,0 +1,211 @@
+#ifndef SIM_PROGRESS_H
+#define SIM_PROGRESS_H
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include "ns3/core-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief A Scheduler that forwards to another one and counts the events
+ * it holds.
+ *
+ * ns-3 does not tell how many events are pending; SimProgress installs
+ * this around the chosen scheduler to report it. The simulator creates its
+ * scheduler itself, so the latest CountingScheduler is found through
+ * GetCurrent. Cancelled events stay in the queue until their time comes,
+ * as in every ns-3 scheduler, and are counted until then.
+ */
+class CountingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::CountingScheduler")
+      .SetParent<Scheduler> ()
+      .SetGroupName ("Core")
+      .AddConstructor<CountingScheduler> ()
+      .AddAttribute ("Scheduler", "TypeId of the scheduler that holds the events",
+                     TypeIdValue (MapScheduler::GetTypeId ()),
+                     MakeTypeIdAccessor (&CountingScheduler::m_innerType),
+                     MakeTypeIdChecker ())
+    ;
+    return tid;
+  }
+
+  CountingScheduler () : m_size (0) { Current () = this; }
+  virtual ~CountingScheduler () { if (Current () == this) Current () = 0; }
+
+  virtual void Insert (const Event &ev) { m_inner->Insert (ev); ++m_size; }
+  virtual bool IsEmpty (void) const { return m_inner->IsEmpty (); }
+  virtual Event PeekNext (void) const { return m_inner->PeekNext (); }
+  virtual Event RemoveNext (void) { --m_size; return m_inner->RemoveNext (); }
+  virtual void Remove (const Event &ev) { m_inner->Remove (ev); --m_size; }
+
+  uint64_t GetSize (void) const { return m_size; }
+  /// The CountingScheduler created last, or 0.
+  static CountingScheduler *GetCurrent (void) { return Current (); }
+
+protected:
+  virtual void NotifyConstructionCompleted (void)
+  {
+    Scheduler::NotifyConstructionCompleted ();
+    ObjectFactory factory;
+    factory.SetTypeId (m_innerType);
+    m_inner = factory.Create<Scheduler> ();
+  }
+
+private:
+  static CountingScheduler *&Current (void)
+  {
+    static CountingScheduler *current = 0;
+    return current;
+  }
+
+  TypeId m_innerType;
+  Ptr<Scheduler> m_inner;
+  uint64_t m_size;
+};
+
+/**
+ * \brief Chooses the event scheduler and reports the progress of a run.
+ *
+ * Scheduler kinds: map (ns-3's default), heap, list, calendar and
+ * priority-queue. With a progress file the scheduler is wrapped in a
+ * CountingScheduler and a row is appended every interval of simulated
+ * time, flushed so the file can be followed while the run goes on:
+ *
+ *     sim_s,wall_s,events,events_per_s,pending,eta_s
+ *
+ * wall_s counts from the first event; events_per_s is the rate since the
+ * previous row and eta_s the wall time left at the average rate so far.
+ * The last row is written when the simulator is destroyed.
+ */
+class SimProgress
+{
+public:
+  static bool IsKnown (const std::string &kind);
+
+  /**
+   * Install the scheduler; do this before any event is scheduled, and
+   * after choosing the simulator implementation.
+   * \param kind map, heap, list, calendar or priority-queue
+   * \param path progress file, or empty for no reports
+   */
+  SimProgress (const std::string &kind, const std::string &path, Time interval = Seconds (10));
+
+  /// Start reporting; stop is the time the run ends, for the estimate.
+  void Start (Time stop);
+
+private:
+  void Begin (void);
+  void Report (void);
+  void Finish (void);
+  void WriteRow (void);
+
+  std::string m_path;
+  Time m_interval;
+  Time m_stop;
+  std::ofstream m_out;
+  std::chrono::steady_clock::time_point m_wallStart;
+  double m_lastWall;
+  uint64_t m_firstEvents;
+  uint64_t m_lastEvents;
+};
+
+inline bool
+SimProgress::IsKnown (const std::string &kind)
+{
+  return kind == "map" || kind == "heap" || kind == "list" || kind == "calendar" || kind == "priority-queue";
+}
+
+inline
+SimProgress::SimProgress (const std::string &kind, const std::string &path, Time interval)
+  : m_path (path),
+    m_interval (interval),
+    m_lastWall (0),
+    m_firstEvents (0),
+    m_lastEvents (0)
+{
+  NS_ABORT_MSG_UNLESS (IsKnown (kind), "Unknown scheduler \"" << kind << "\" (map, heap, list, calendar, priority-queue)");
+  NS_ABORT_MSG_UNLESS (interval.IsStrictlyPositive (), "SimProgress: the report interval must be positive");
+  TypeId tid = kind == "heap" ? HeapScheduler::GetTypeId ()
+    : kind == "list" ? ListScheduler::GetTypeId ()
+    : kind == "calendar" ? CalendarScheduler::GetTypeId ()
+    : kind == "priority-queue" ? PriorityQueueScheduler::GetTypeId ()
+    : MapScheduler::GetTypeId ();
+
+  ObjectFactory factory;
+  if (path.empty ())
+    {
+      factory.SetTypeId (tid);
+    }
+  else
+    {
+      factory.SetTypeId (CountingScheduler::GetTypeId ());
+      factory.Set ("Scheduler", TypeIdValue (tid));
+    }
+  Simulator::SetScheduler (factory);
+}
+
+inline void
+SimProgress::Start (Time stop)
+{
+  if (m_path.empty ())
+    {
+      return;
+    }
+  m_stop = stop;
+  m_out.open (m_path.c_str ());
+  NS_ABORT_MSG_UNLESS (m_out, "Cannot write " << m_path);
+  m_out << "sim_s,wall_s,events,events_per_s,pending,eta_s\n";
+  m_out.flush ();
+  Simulator::ScheduleNow (&SimProgress::Begin, this);
+  Simulator::ScheduleDestroy (&SimProgress::Finish, this);
+}
+
+inline void
+SimProgress::Begin (void)
+{
+  m_wallStart = std::chrono::steady_clock::now ();
+  m_firstEvents = m_lastEvents = Simulator::GetEventCount ();
+  Simulator::Schedule (m_interval, &SimProgress::Report, this);
+}
+
+inline void
+SimProgress::Report (void)
+{
+  WriteRow ();
+  Simulator::Schedule (m_interval, &SimProgress::Report, this);
+}
+
+inline void
+SimProgress::Finish (void)
+{
+  if (m_out.is_open ())
+    {
+      WriteRow ();
+      m_out.close ();
+    }
+}
+
+inline void
+SimProgress::WriteRow (void)
+{
+  double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - m_wallStart).count ();
+  uint64_t events = Simulator::GetEventCount ();
+  double sim = Simulator::Now ().GetSeconds ();
+  double rate = wall > m_lastWall ? (events - m_lastEvents) / (wall - m_lastWall) : 0.0;
+  double eta = sim > 0 && m_stop.GetSeconds () > sim ? wall / sim * (m_stop.GetSeconds () - sim) : 0.0;
+  m_out << sim << "," << wall << "," << events - m_firstEvents << "," << rate << ","
+        << (CountingScheduler::GetCurrent () != 0 ? CountingScheduler::GetCurrent ()->GetSize () : 0) << "," << eta << "\n";
+  m_out.flush ();
+  m_lastWall = wall;
+  m_lastEvents = events;
+}
+
+} // namespace ns3
+
+#endif /* SIM_PROGRESS_H */
@@ -0,0 +1,272 @@
+/*
+ * Offline reader for the binary RIP snapshots written with --snapshotPrefix.
+ *
+ *   ./waf --run "snapshot-reader --file=tables-40s.snap --node=5"
+ *       prints node 5's table in the layout of Rip::PrintRoutingTable
+ *   ./waf --run "snapshot-reader --file=tables-40s.snap --diff=tables-90s.snap"
+ *       lists the routes added (+), withdrawn (-) and changed (~) between two
+ *       snapshots, for every node or only for --node
+ *   ./waf --run "snapshot-reader --journal=changes.rj --time=75 --node=5"
+ *       replays a --journalFile route-change journal and prints the tables as
+ *       they were at --time (default: end of the run)
+ */
+
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <tuple>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "ns3/core-module.h"
+#include "../rip-snapshot-format.h"
+#include "../rip-journal-format.h"
+
+using namespace ns3;
+
+static std::string
+FormatAddress (uint32_t a)
+{
+  std::ostringstream oss;
+  oss << (a >> 24) << "." << ((a >> 16) & 0xff) << "." << ((a >> 8) & 0xff) << "." << (a & 0xff);
+  return oss.str ();
+}
+
+static uint32_t
+PrefixToMask (uint8_t prefix)
+{
+  return prefix == 0 ? 0 : 0xffffffffu << (32 - prefix);
+}
+
+static void
+PrintRoute (const RipSnapshot &s, size_t row)
+{
+  std::cout << std::setiosflags (std::ios::left)
+            << std::setw (16) << FormatAddress (s.destination[row])
+            << std::setw (16) << FormatAddress (s.gateway[row])
+            << std::setw (16) << FormatAddress (PrefixToMask (s.prefix[row]))
+            << std::setw (6) << (s.gateway[row] == 0 ? "U" : "UGS")
+            << std::setw (7) << int (s.metric[row])
+            << "-      -   " << s.interface[row] << std::endl;
+}
+
+static void
+PrintTable (const RipSnapshot &s, uint32_t node)
+{
+  std::cout << "Node: " << node << ", Time: +" << s.timeNs / 1e9 << "s, IPv4 RIP table" << std::endl;
+  size_t row = s.FindNode (node);
+  if (row == s.GetNRoutes ())
+    {
+      std::cout << "(no routes)" << std::endl << std::endl;
+      return;
+    }
+  std::cout << "Destination     Gateway         Genmask         Flags Metric Ref    Use Iface" << std::endl;
+  for (; row < s.GetNRoutes () && s.node[row] == node; ++row)
+    {
+      PrintRoute (s, row);
+    }
+  std::cout << std::endl;
+}
+
+static void
+PrintChange (char tag, const RipSnapshot &s, size_t row)
+{
+  std::cout << tag << " node " << s.node[row] << " " << FormatAddress (s.destination[row]) << "/" << int (s.prefix[row])
+            << " via " << FormatAddress (s.gateway[row]) << " if " << s.interface[row]
+            << " metric " << int (s.metric[row]) << std::endl;
+}
+
+static int
+Compare (const RipSnapshot &s, size_t i, const RipSnapshot &t, size_t j)
+{
+  if (s.node[i] != t.node[j])
+    {
+      return s.node[i] < t.node[j] ? -1 : 1;
+    }
+  if (s.destination[i] != t.destination[j])
+    {
+      return s.destination[i] < t.destination[j] ? -1 : 1;
+    }
+  if (s.prefix[i] != t.prefix[j])
+    {
+      return s.prefix[i] < t.prefix[j] ? -1 : 1;
+    }
+  return 0;
+}
+
+static void
+Diff (const RipSnapshot &a, const RipSnapshot &b, int64_t node)
+{
+  size_t i = 0;
+  size_t j = 0;
+  size_t iEnd = a.GetNRoutes ();
+  size_t jEnd = b.GetNRoutes ();
+  if (node >= 0)
+    {
+      i = a.FindNode (node);
+      j = b.FindNode (node);
+      for (iEnd = i; iEnd < a.GetNRoutes () && a.node[iEnd] == node; ++iEnd)
+        {
+        }
+      for (jEnd = j; jEnd < b.GetNRoutes () && b.node[jEnd] == node; ++jEnd)
+        {
+        }
+    }
+
+  uint64_t added = 0, withdrawn = 0, changed = 0;
+  while (i < iEnd || j < jEnd)
+    {
+      int c = i == iEnd ? 1 : (j == jEnd ? -1 : Compare (a, i, b, j));
+      if (c < 0)
+        {
+          PrintChange ('-', a, i++);
+          ++withdrawn;
+        }
+      else if (c > 0)
+        {
+          PrintChange ('+', b, j++);
+          ++added;
+        }
+      else
+        {
+          if (a.gateway[i] != b.gateway[j] || a.interface[i] != b.interface[j] || a.metric[i] != b.metric[j])
+            {
+              PrintChange ('~', b, j);
+              ++changed;
+            }
+          ++i;
+          ++j;
+        }
+    }
+  std::cout << added << " added, " << withdrawn << " withdrawn, " << changed << " changed between +"
+            << a.timeNs / 1e9 << "s and +" << b.timeNs / 1e9 << "s" << std::endl;
+}
+
+static bool
+ReplayJournal (const std::string &path, double seconds, int64_t node, RipSnapshot &out, std::string &error)
+{
+  FILE *f = std::fopen (path.c_str (), "rb");
+  uint32_t header[4];
+  if (f == 0 || std::fread (header, sizeof (header), 1, f) != 1 || header[0] != RipJournalRecord::MAGIC)
+    {
+      error = path + " is not a RIP journal";
+      if (f != 0)
+        {
+          std::fclose (f);
+        }
+      return false;
+    }
+  if (header[1] != RipJournalRecord::VERSION || header[2] != sizeof (RipJournalRecord))
+    {
+      error = path + " has an unsupported journal version";
+      std::fclose (f);
+      return false;
+    }
+
+  typedef std::tuple<uint32_t, uint32_t, uint8_t> Key;
+  typedef std::tuple<uint32_t, uint32_t, uint8_t> Value; // gateway, interface, metric
+  std::map<Key, Value> routes;
+  uint64_t limit = seconds < 0 ? UINT64_MAX : uint64_t (seconds * 1e9);
+  std::vector<RipJournalRecord> chunk (65536);
+  uint64_t last = 0;
+  size_t n;
+  bool done = false;
+  while (!done && (n = std::fread (chunk.data (), sizeof (RipJournalRecord), chunk.size (), f)) > 0)
+    {
+      for (size_t i = 0; i < n; ++i)
+        {
+          const RipJournalRecord &r = chunk[i];
+          if (r.timeNs > limit)
+            {
+              done = true;
+              break;
+            }
+          last = r.timeNs;
+          if (node >= 0 && r.node != node)
+            {
+              continue;
+            }
+          Key key (r.node, r.destination, r.prefix);
+          if (r.type == RipJournalRecord::WITHDRAWN)
+            {
+              routes.erase (key);
+            }
+          else
+            {
+              routes[key] = Value (r.gateway, r.interface, r.metric);
+            }
+        }
+    }
+  std::fclose (f);
+
+  out = RipSnapshot ();
+  out.timeNs = seconds < 0 ? last : limit;
+  for (std::map<Key, Value>::const_iterator it = routes.begin (); it != routes.end (); ++it)
+    {
+      out.Add (std::get<0> (it->first), std::get<1> (it->first), std::get<2> (it->first),
+               std::get<0> (it->second), std::get<1> (it->second), std::get<2> (it->second));
+    }
+  return true;
+}
+
+int
+main (int argc, char **argv)
+{
+  std::string file;
+  std::string diffFile;
+  std::string journal;
+  double time = -1;
+  int64_t node = -1;
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "Snapshot to read", file);
+  cmd.AddValue ("diff", "Second snapshot to compare the first one with", diffFile);
+  cmd.AddValue ("journal", "Route-change journal to replay instead of reading a snapshot", journal);
+  cmd.AddValue ("time", "With --journal, rebuild the tables as of this simulated second", time);
+  cmd.AddValue ("node", "Only this node (default: all nodes)", node);
+  cmd.Parse (argc, argv);
+
+  RipSnapshot snapshot;
+  std::string error;
+  if (!journal.empty ())
+    {
+      if (!ReplayJournal (journal, time, node, snapshot, error))
+        {
+          std::cerr << error << std::endl;
+          return 1;
+        }
+    }
+  else if (file.empty () || !snapshot.Read (file, error))
+    {
+      std::cerr << (file.empty () ? "snapshot-reader: --file or --journal is required" : error) << std::endl;
+      return 1;
+    }
+
+  if (!diffFile.empty ())
+    {
+      RipSnapshot other;
+      if (!other.Read (diffFile, error))
+        {
+          std::cerr << error << std::endl;
+          return 1;
+        }
+      Diff (snapshot, other, node);
+      return 0;
+    }
+
+  if (node >= 0)
+    {
+      PrintTable (snapshot, node);
+      return 0;
+    }
+  for (size_t row = 0; row < snapshot.GetNRoutes (); )
+    {
+      uint32_t n = snapshot.node[row];
+      PrintTable (snapshot, n);
+      while (row < snapshot.GetNRoutes () && snapshot.node[row] == n)
+        {
+          ++row;
+        }
+    }
+  return 0;
+}
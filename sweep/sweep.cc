@@ -0,0 +1,373 @@
+/*
+ * Parameter sweep runner for bGoal.
+ *
+ * Expands a grid such as
+ *   --grid="amount=100,1000;splitHorizonStrategy=SplitHorizon,PoisonReverse;RngRun=1,2,3"
+ * into one bGoal run per combination and keeps --jobs of them running at a
+ * time. Every run gets its own directory under --outDir so that the trace,
+ * pcap and NetAnim files of concurrent runs do not collide; its console
+ * output goes to run.log and its summary to result.txt. When all runs are
+ * done the summaries are merged into <outDir>/results.tsv.
+ *
+ * A run whose result.txt exists is skipped, so an interrupted sweep is
+ * resumed by starting it again with the same arguments.
+ *
+ * Build the scenario first and point --binary at it, e.g.
+ *   ./waf build
+ *   ./waf --run "sweep --binary=build/scratch/bGoal/ns3.29-bGoal-debug --grid=..."
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <limits.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+struct SweepRun
+{
+  std::vector<std::string> values;
+  std::string id;
+  std::string dir;
+  double weight;
+  std::chrono::steady_clock::time_point started;
+};
+
+static volatile sig_atomic_t g_interrupted = 0;
+
+static void
+OnInterrupt (int signo)
+{
+  g_interrupted = 1;
+}
+
+static std::vector<std::string>
+Split (const std::string &s, char sep)
+{
+  std::vector<std::string> parts;
+  std::string part;
+  std::istringstream is (s);
+  while (std::getline (is, part, sep))
+    {
+      if (!part.empty ())
+        {
+          parts.push_back (part);
+        }
+    }
+  return parts;
+}
+
+static bool
+FileExists (const std::string &path)
+{
+  struct stat st;
+  return stat (path.c_str (), &st) == 0;
+}
+
+static void
+MakeDir (const std::string &path)
+{
+  if (mkdir (path.c_str (), 0755) != 0 && errno != EEXIST)
+    {
+      std::cerr << "sweep: cannot create " << path << ": " << std::strerror (errno) << std::endl;
+      std::exit (1);
+    }
+}
+
+static std::string
+RunId (const std::vector<std::string> &keys, const std::vector<std::string> &values)
+{
+  std::string id;
+  for (size_t i = 0; i < keys.size (); ++i)
+    {
+      id += (i == 0 ? "" : "_") + keys[i] + "=" + values[i];
+    }
+  for (size_t i = 0; i < id.size (); ++i)
+    {
+      if (id[i] == '/' || id[i] == ' ')
+        {
+          id[i] = '-';
+        }
+    }
+  return id;
+}
+
+static pid_t
+Launch (const std::string &binary, const std::vector<std::string> &keys, const SweepRun &run,
+        const std::vector<std::string> &extraArgs)
+{
+  std::vector<std::string> args;
+  args.push_back (binary);
+  for (size_t i = 0; i < keys.size (); ++i)
+    {
+      args.push_back ("--" + keys[i] + "=" + run.values[i]);
+    }
+  args.insert (args.end (), extraArgs.begin (), extraArgs.end ());
+  args.push_back ("--resultFile=result.txt");
+
+  pid_t pid = fork ();
+  if (pid != 0)
+    {
+      return pid;
+    }
+
+  // child
+  std::vector<char *> argv;
+  for (size_t i = 0; i < args.size (); ++i)
+    {
+      argv.push_back (const_cast<char *> (args[i].c_str ()));
+    }
+  argv.push_back (0);
+  int log = -1;
+  if (chdir (run.dir.c_str ()) == 0)
+    {
+      log = open ("run.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+  if (log < 0)
+    {
+      _exit (126);
+    }
+  dup2 (log, STDOUT_FILENO);
+  dup2 (log, STDERR_FILENO);
+  close (log);
+  execv (argv[0], &argv[0]);
+  std::perror ("execv");
+  _exit (127);
+}
+
+static std::map<std::string, std::string>
+ReadResult (const std::string &path, std::vector<std::string> &columns)
+{
+  std::map<std::string, std::string> values;
+  std::ifstream is (path.c_str ());
+  std::string line;
+  while (std::getline (is, line))
+    {
+      std::string::size_type eq = line.find ('=');
+      if (eq == std::string::npos)
+        {
+          continue;
+        }
+      std::string key = line.substr (0, eq);
+      if (values.find (key) == values.end ()
+          && std::find (columns.begin (), columns.end (), key) == columns.end ())
+        {
+          columns.push_back (key);
+        }
+      values[key] = line.substr (eq + 1);
+    }
+  return values;
+}
+
+static void
+WriteTable (const std::string &outDir, const std::vector<std::string> &keys, const std::vector<SweepRun> &runs)
+{
+  std::vector<std::string> columns (keys);
+  std::vector<std::map<std::string, std::string> > rows;
+  for (size_t r = 0; r < runs.size (); ++r)
+    {
+      std::map<std::string, std::string> row;
+      std::string path = runs[r].dir + "/result.txt";
+      if (FileExists (path))
+        {
+          row = ReadResult (path, columns);
+        }
+      for (size_t k = 0; k < keys.size (); ++k)
+        {
+          row[keys[k]] = runs[r].values[k];
+        }
+      rows.push_back (row);
+    }
+
+  std::string table = outDir + "/results.tsv";
+  std::string tmp = table + ".tmp";
+  {
+    std::ofstream os (tmp.c_str (), std::ios::out | std::ios::trunc);
+    for (size_t c = 0; c < columns.size (); ++c)
+      {
+        os << (c == 0 ? "" : "\t") << columns[c];
+      }
+    os << "\n";
+    for (size_t r = 0; r < rows.size (); ++r)
+      {
+        for (size_t c = 0; c < columns.size (); ++c)
+          {
+            std::map<std::string, std::string>::const_iterator it = rows[r].find (columns[c]);
+            os << (c == 0 ? "" : "\t") << (it == rows[r].end () ? "-" : it->second);
+          }
+        os << "\n";
+      }
+  }
+  std::rename (tmp.c_str (), table.c_str ());
+  std::cout << "sweep: " << rows.size () << " rows written to " << table << std::endl;
+}
+
+int
+main (int argc, char **argv)
+{
+  std::string binary;
+  std::string grid ("amount=10,100;splitHorizonStrategy=NoSplitHorizon,SplitHorizon,PoisonReverse;RngRun=1");
+  std::string extra ("--printRoutingTables=false --showPings=false --stopOnConvergence=true");
+  std::string outDir ("sweep-out");
+  uint32_t jobs = std::thread::hardware_concurrency ();
+
+  CommandLine cmd;
+  cmd.AddValue ("binary", "Path of the built bGoal program", binary);
+  cmd.AddValue ("grid", "Parameter grid: key=v1,v2;key=v1,...", grid);
+  cmd.AddValue ("args", "Arguments passed unchanged to every run", extra);
+  cmd.AddValue ("outDir", "Directory for per-run output and results.tsv", outDir);
+  cmd.AddValue ("jobs", "Number of runs executed in parallel", jobs);
+  cmd.Parse (argc, argv);
+
+  char resolved[PATH_MAX];
+  if (binary.empty () || realpath (binary.c_str (), resolved) == 0 || access (resolved, X_OK) != 0)
+    {
+      std::cerr << "sweep: --binary must name the built bGoal executable" << std::endl;
+      return 1;
+    }
+  binary = resolved;
+  jobs = std::max (jobs, 1u);
+
+  std::vector<std::string> keys;
+  std::vector<std::vector<std::string> > axes;
+  std::vector<std::string> dims = Split (grid, ';');
+  for (size_t i = 0; i < dims.size (); ++i)
+    {
+      std::string::size_type eq = dims[i].find ('=');
+      if (eq == std::string::npos || eq + 1 == dims[i].size ())
+        {
+          std::cerr << "sweep: bad grid dimension \"" << dims[i] << "\"" << std::endl;
+          return 1;
+        }
+      keys.push_back (dims[i].substr (0, eq));
+      axes.push_back (Split (dims[i].substr (eq + 1), ','));
+      if (axes.back ().empty ())
+        {
+          std::cerr << "sweep: grid dimension \"" << dims[i] << "\" has no values" << std::endl;
+          return 1;
+        }
+    }
+  std::vector<std::string> extraArgs = Split (extra, ' ');
+
+  // Cartesian product, last dimension varying fastest.
+  std::vector<SweepRun> runs;
+  std::vector<size_t> index (keys.size (), 0);
+  MakeDir (outDir);
+  while (true)
+    {
+      SweepRun run;
+      run.weight = 0;
+      for (size_t k = 0; k < keys.size (); ++k)
+        {
+          run.values.push_back (axes[k][index[k]]);
+          if (keys[k] == "amount")
+            {
+              run.weight = std::atof (run.values.back ().c_str ());
+            }
+        }
+      run.id = RunId (keys, run.values);
+      run.dir = outDir + "/" + run.id;
+      runs.push_back (run);
+
+      size_t k = keys.size ();
+      while (k > 0 && ++index[k - 1] == axes[k - 1].size ())
+        {
+          index[--k] = 0;
+        }
+      if (k == 0)
+        {
+          break;
+        }
+    }
+
+  // Largest networks first so the longest runs do not end up in the tail.
+  std::vector<size_t> pending;
+  for (size_t r = 0; r < runs.size (); ++r)
+    {
+      if (!FileExists (runs[r].dir + "/result.txt"))
+        {
+          pending.push_back (r);
+        }
+    }
+  std::stable_sort (pending.begin (), pending.end (),
+                    [&runs] (size_t a, size_t b) { return runs[a].weight < runs[b].weight; });
+  std::cout << "sweep: " << runs.size () << " runs, " << runs.size () - pending.size ()
+            << " already done, " << jobs << " jobs" << std::endl;
+
+  struct sigaction sa;
+  std::memset (&sa, 0, sizeof (sa));
+  sa.sa_handler = &OnInterrupt;
+  sigaction (SIGINT, &sa, 0);
+  sigaction (SIGTERM, &sa, 0);
+
+  std::map<pid_t, size_t> running;
+  size_t finished = runs.size () - pending.size ();
+  uint32_t failures = 0;
+  while (!g_interrupted && (!pending.empty () || !running.empty ()))
+    {
+      while (!g_interrupted && running.size () < jobs && !pending.empty ())
+        {
+          SweepRun &run = runs[pending.back ()];
+          MakeDir (run.dir);
+          MakeDir (run.dir + "/xmls");
+          MakeDir (run.dir + "/pcap");
+          run.started = std::chrono::steady_clock::now ();
+          pid_t pid = Launch (binary, keys, run, extraArgs);
+          if (pid < 0)
+            {
+              std::cerr << "sweep: fork failed: " << std::strerror (errno) << std::endl;
+              g_interrupted = 1;
+              break;
+            }
+          running[pid] = pending.back ();
+          pending.pop_back ();
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          continue; // EINTR: re-check g_interrupted
+        }
+      const SweepRun &run = runs[running[pid]];
+      running.erase (pid);
+      ++finished;
+      double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - run.started).count ();
+      bool ok = WIFEXITED (status) && WEXITSTATUS (status) == 0 && FileExists (run.dir + "/result.txt");
+      failures += ok ? 0 : 1;
+      std::cout << "[" << finished << "/" << runs.size () << "] " << run.id << " "
+                << (ok ? "done" : "FAILED, see " + run.dir + "/run.log") << " in " << seconds << " s" << std::endl;
+    }
+
+  if (g_interrupted)
+    {
+      for (std::map<pid_t, size_t>::const_iterator it = running.begin (); it != running.end (); ++it)
+        {
+          kill (it->first, SIGTERM);
+        }
+      while (waitpid (-1, 0, 0) > 0 || errno == EINTR)
+        {
+        }
+      std::cerr << "sweep: interrupted, " << running.size () << " runs stopped; start again to resume" << std::endl;
+    }
+
+  WriteTable (outDir, keys, runs);
+  return g_interrupted ? 130 : (failures > 0 ? 2 : 0);
+}
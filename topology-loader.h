@@ -0,0 +1,649 @@
+#ifndef TOPOLOGY_LOADER_H
+#define TOPOLOGY_LOADER_H
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/traffic-control-module.h"
+
+namespace ns3 {
+
+/**
+ * \brief Builds a CSMA + RIP topology from an edge-list file in one pass.
+ *
+ * Text form, one directive per line, '#' starts a comment:
+ *
+ *     node <name> <router|host> [<x> <y>]
+ *     link <nodeA> <nodeB> <network>/<prefix> [<dataRate> <delay>]
+ *     lan <network>/<prefix> <node> <node> [<node> ...] [<dataRate> <delay>]
+ *     exclude <node> <peer>
+ *     default <host> <router>
+ *
+ * Nodes must be declared before they are used. "-" or a missing rate/delay
+ * keeps the 5Mbps / 2ms default. A "link" is a two-node CSMA channel, or a
+ * point-to-point link after SetPointToPoint(true); a "lan" is always CSMA.
+ * "exclude" keeps RIP off the interface of <node> that faces <peer>;
+ * "default" points the static default route of <host> at the address of
+ * <router> on the link they share. Interfaces are numbered in the order
+ * links are listed, starting from 1.
+ *
+ * The binary form holds the same records with node names replaced by their
+ * declaration index and rates/delays already converted, so it loads without
+ * any text parsing. It is written with SetBinaryMirror() while loading the
+ * text form and is recognised by its magic. Integers are stored in host byte
+ * order.
+ */
+class TopologyLoader
+{
+public:
+  TopologyLoader ();
+
+  /**
+   * \brief Also write every record read by Load() to a binary topology file.
+   */
+  void SetBinaryMirror (const std::string &path);
+
+  /**
+   * \brief Do not install mobility for nodes with a position. Positions are
+   * only used by NetAnim and node moves, and cost a model per node.
+   */
+  void SetIgnorePositions (bool ignore);
+
+  /**
+   * \brief Build "link" records with point-to-point devices instead of CSMA.
+   * Interface numbering is the same either way.
+   */
+  void SetPointToPoint (bool pointToPoint);
+
+  /**
+   * \brief Read a text or binary topology, create its nodes and links and
+   * install the Internet stack, RIP, addresses and default routes.
+   */
+  void Load (const std::string &path);
+
+  Ptr<Node> GetNode (const std::string &name) const;
+  NodeContainer GetRouters (void) const;
+  NodeContainer GetHosts (void) const;
+  CsmaHelper &GetCsmaHelper (void);
+  PointToPointHelper &GetPointToPointHelper (void);
+  uint32_t GetNLinks (void) const;
+
+private:
+  enum RecordType
+  {
+    NODE = 1,
+    LINK = 2,
+    LAN = 3,
+    EXCLUDE = 4,
+    DEFAULT = 5
+  };
+
+  struct Record
+  {
+    uint8_t type;
+    std::string name;
+    uint8_t isRouter;
+    uint8_t hasPosition;
+    double x;
+    double y;
+    std::vector<uint32_t> nodes;
+    uint32_t network;
+    uint8_t prefix;
+    uint64_t rate;
+    uint64_t delay;
+  };
+
+  struct PendingLink
+  {
+    NetDeviceContainer devices;
+    uint32_t network;
+    uint8_t prefix;
+  };
+
+  static const uint32_t MAGIC = 0x54504952; // "RIPT"
+  static const uint32_t VERSION = 1;
+
+  bool ReadTextRecord (std::istream &is, Record &rec, uint64_t &lineNo);
+  bool ReadBinaryRecord (std::istream &is, Record &rec);
+  void WriteBinaryRecord (const Record &rec);
+  void Apply (const Record &rec);
+  void Finish (void);
+  uint32_t Lookup (const std::string &name, uint64_t lineNo) const;
+  static void ParseNetwork (const std::string &s, Record &rec, uint64_t lineNo);
+  /// Whether the subnet of a link or lan record has an address for each node.
+  static bool Fits (const Record &rec);
+  static uint64_t PairKey (uint32_t a, uint32_t b);
+
+  std::string m_mirrorPath;
+  std::ofstream m_mirror;
+  bool m_ignorePositions;
+  bool m_pointToPoint;
+
+  std::vector<Ptr<Node> > m_nodes;
+  std::vector<uint32_t> m_nextInterface;
+  std::unordered_map<std::string, uint32_t> m_names;
+  std::unordered_map<uint64_t, uint32_t> m_interfaceTowards;
+  std::vector<PendingLink> m_links;
+  std::vector<std::pair<uint32_t, uint32_t> > m_defaults;
+
+  NodeContainer m_routers;
+  NodeContainer m_hosts;
+  NodeContainer m_positioned;
+  Ptr<ListPositionAllocator> m_positions;
+
+  CsmaHelper m_csma;
+  PointToPointHelper m_p2p;
+  RipHelper m_rip;
+  uint64_t m_defaultRate;
+  uint64_t m_defaultDelay;
+  uint32_t m_nLinks;
+};
+
+inline
+TopologyLoader::TopologyLoader ()
+  : m_ignorePositions (false),
+    m_pointToPoint (false),
+    m_positions (CreateObject<ListPositionAllocator> ()),
+    m_defaultRate (5000000),
+    m_defaultDelay (MilliSeconds (2).GetNanoSeconds ()),
+    m_nLinks (0)
+{
+}
+
+inline void
+TopologyLoader::SetBinaryMirror (const std::string &path)
+{
+  m_mirrorPath = path;
+}
+
+inline void
+TopologyLoader::SetIgnorePositions (bool ignore)
+{
+  m_ignorePositions = ignore;
+}
+
+inline void
+TopologyLoader::SetPointToPoint (bool pointToPoint)
+{
+  m_pointToPoint = pointToPoint;
+}
+
+inline uint64_t
+TopologyLoader::PairKey (uint32_t a, uint32_t b)
+{
+  return (uint64_t (a) << 32) | b;
+}
+
+inline uint32_t
+TopologyLoader::Lookup (const std::string &name, uint64_t lineNo) const
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_names.find (name);
+  NS_ABORT_MSG_IF (it == m_names.end (), "Topology line " << lineNo << ": node \"" << name << "\" used before it is declared");
+  return it->second;
+}
+
+inline void
+TopologyLoader::ParseNetwork (const std::string &s, Record &rec, uint64_t lineNo)
+{
+  std::string::size_type slash = s.find ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos, "Topology line " << lineNo << ": \"" << s << "\" is not a network/prefix");
+  rec.network = Ipv4Address (s.substr (0, slash).c_str ()).Get ();
+  rec.prefix = std::atoi (s.c_str () + slash + 1);
+  NS_ABORT_MSG_IF (rec.prefix > 31, "Topology line " << lineNo << ": bad prefix length in \"" << s << "\"");
+}
+
+inline bool
+TopologyLoader::Fits (const Record &rec)
+{
+  // A /31 has no network or broadcast address, so both of its addresses
+  // are usable; otherwise the subnet loses two.
+  if (rec.prefix == 31)
+    {
+      return rec.nodes.size () <= 2;
+    }
+  uint32_t mask = rec.prefix == 0 ? 0 : 0xffffffffu << (32 - rec.prefix);
+  return rec.nodes.size () + 1 <= (~mask);
+}
+
+inline bool
+TopologyLoader::ReadTextRecord (std::istream &is, Record &rec, uint64_t &lineNo)
+{
+  std::string line;
+  std::vector<std::string> tok;
+  while (std::getline (is, line))
+    {
+      ++lineNo;
+      std::string::size_type hash = line.find ('#');
+      if (hash != std::string::npos)
+        {
+          line.erase (hash);
+        }
+      tok.clear ();
+      std::istringstream ls (line);
+      std::string t;
+      while (ls >> t)
+        {
+          tok.push_back (t);
+        }
+      if (tok.empty ())
+        {
+          continue;
+        }
+
+      rec.nodes.clear ();
+      rec.rate = m_defaultRate;
+      rec.delay = m_defaultDelay;
+      size_t rest = 0;
+      if (tok[0] == "node")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 3 || tok.size () == 5, "Topology line " << lineNo << ": node <name> <router|host> [<x> <y>]");
+          NS_ABORT_MSG_UNLESS (tok[2] == "router" || tok[2] == "host", "Topology line " << lineNo << ": unknown node kind \"" << tok[2] << "\"");
+          rec.type = NODE;
+          rec.name = tok[1];
+          rec.isRouter = tok[2] == "router";
+          rec.hasPosition = tok.size () == 5;
+          rec.x = rec.hasPosition ? std::atof (tok[3].c_str ()) : 0;
+          rec.y = rec.hasPosition ? std::atof (tok[4].c_str ()) : 0;
+          return true;
+        }
+      else if (tok[0] == "link")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 4 || tok.size () == 6, "Topology line " << lineNo << ": link <a> <b> <network>/<prefix> [<rate> <delay>]");
+          rec.type = LINK;
+          rec.nodes.push_back (Lookup (tok[1], lineNo));
+          rec.nodes.push_back (Lookup (tok[2], lineNo));
+          ParseNetwork (tok[3], rec, lineNo);
+          rest = 4;
+        }
+      else if (tok[0] == "lan")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () >= 4, "Topology line " << lineNo << ": lan <network>/<prefix> <node> <node> ...");
+          rec.type = LAN;
+          ParseNetwork (tok[1], rec, lineNo);
+          size_t end = tok.size ();
+          // A trailing pair that names no declared node is "<rate> <delay>".
+          if (end >= 6 && m_names.find (tok[end - 1]) == m_names.end () && m_names.find (tok[end - 2]) == m_names.end ())
+            {
+              end -= 2;
+            }
+          for (size_t i = 2; i < end; ++i)
+            {
+              rec.nodes.push_back (Lookup (tok[i], lineNo));
+            }
+          rest = end;
+        }
+      else if (tok[0] == "exclude" || tok[0] == "default")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 3, "Topology line " << lineNo << ": " << tok[0] << " <node> <peer>");
+          rec.type = tok[0] == "exclude" ? EXCLUDE : DEFAULT;
+          rec.nodes.push_back (Lookup (tok[1], lineNo));
+          rec.nodes.push_back (Lookup (tok[2], lineNo));
+          return true;
+        }
+      else
+        {
+          NS_ABORT_MSG ("Topology line " << lineNo << ": unknown directive \"" << tok[0] << "\"");
+        }
+
+      NS_ABORT_MSG_UNLESS (Fits (rec), "Topology line " << lineNo << ": " << Ipv4Address (rec.network) << "/" << int (rec.prefix)
+                           << " is too small for " << rec.nodes.size () << " nodes");
+      if (rest + 2 <= tok.size ())
+        {
+          if (tok[rest] != "-")
+            {
+              rec.rate = DataRate (tok[rest]).GetBitRate ();
+            }
+          if (tok[rest + 1] != "-")
+            {
+              rec.delay = Time (tok[rest + 1]).GetNanoSeconds ();
+            }
+        }
+      return true;
+    }
+  return false;
+}
+
+inline bool
+TopologyLoader::ReadBinaryRecord (std::istream &is, Record &rec)
+{
+  if (!is.read (reinterpret_cast<char *> (&rec.type), 1))
+    {
+      return false;
+    }
+  uint32_t count = 0;
+  switch (rec.type)
+    {
+    case NODE:
+      {
+        uint16_t len;
+        is.read (reinterpret_cast<char *> (&len), sizeof (len));
+        rec.name.resize (len);
+        is.read (&rec.name[0], len);
+        is.read (reinterpret_cast<char *> (&rec.isRouter), 1);
+        is.read (reinterpret_cast<char *> (&rec.hasPosition), 1);
+        if (rec.hasPosition)
+          {
+            is.read (reinterpret_cast<char *> (&rec.x), sizeof (rec.x));
+            is.read (reinterpret_cast<char *> (&rec.y), sizeof (rec.y));
+          }
+        break;
+      }
+    case LINK:
+    case LAN:
+      is.read (reinterpret_cast<char *> (&rec.network), sizeof (rec.network));
+      is.read (reinterpret_cast<char *> (&rec.prefix), 1);
+      is.read (reinterpret_cast<char *> (&rec.rate), sizeof (rec.rate));
+      is.read (reinterpret_cast<char *> (&rec.delay), sizeof (rec.delay));
+      count = 2;
+      if (rec.type == LAN)
+        {
+          is.read (reinterpret_cast<char *> (&count), sizeof (count));
+          NS_ABORT_MSG_UNLESS (is && count >= 2, "Binary topology: LAN record with fewer than two nodes");
+        }
+      rec.nodes.resize (count);
+      is.read (reinterpret_cast<char *> (&rec.nodes[0]), count * sizeof (uint32_t));
+      break;
+    case EXCLUDE:
+    case DEFAULT:
+      rec.nodes.resize (2);
+      is.read (reinterpret_cast<char *> (&rec.nodes[0]), 2 * sizeof (uint32_t));
+      break;
+    default:
+      NS_ABORT_MSG ("Binary topology: unknown record type " << int (rec.type));
+    }
+  NS_ABORT_MSG_UNLESS (is, "Binary topology: truncated record");
+  if (rec.type == LINK || rec.type == LAN)
+    {
+      NS_ABORT_MSG_IF (rec.prefix > 31, "Binary topology: bad prefix length " << int (rec.prefix));
+      NS_ABORT_MSG_UNLESS (Fits (rec), "Binary topology: " << Ipv4Address (rec.network) << "/" << int (rec.prefix)
+                           << " is too small for " << rec.nodes.size () << " nodes");
+    }
+  for (size_t i = 0; i < rec.nodes.size (); ++i)
+    {
+      NS_ABORT_MSG_UNLESS (rec.nodes[i] < m_nodes.size (), "Binary topology: node index " << rec.nodes[i] << " used before it is declared");
+    }
+  return true;
+}
+
+inline void
+TopologyLoader::WriteBinaryRecord (const Record &rec)
+{
+  m_mirror.write (reinterpret_cast<const char *> (&rec.type), 1);
+  switch (rec.type)
+    {
+    case NODE:
+      {
+        uint16_t len = rec.name.size ();
+        m_mirror.write (reinterpret_cast<const char *> (&len), sizeof (len));
+        m_mirror.write (rec.name.data (), len);
+        m_mirror.write (reinterpret_cast<const char *> (&rec.isRouter), 1);
+        m_mirror.write (reinterpret_cast<const char *> (&rec.hasPosition), 1);
+        if (rec.hasPosition)
+          {
+            m_mirror.write (reinterpret_cast<const char *> (&rec.x), sizeof (rec.x));
+            m_mirror.write (reinterpret_cast<const char *> (&rec.y), sizeof (rec.y));
+          }
+        break;
+      }
+    case LINK:
+    case LAN:
+      {
+        m_mirror.write (reinterpret_cast<const char *> (&rec.network), sizeof (rec.network));
+        m_mirror.write (reinterpret_cast<const char *> (&rec.prefix), 1);
+        m_mirror.write (reinterpret_cast<const char *> (&rec.rate), sizeof (rec.rate));
+        m_mirror.write (reinterpret_cast<const char *> (&rec.delay), sizeof (rec.delay));
+        if (rec.type == LAN)
+          {
+            uint32_t count = rec.nodes.size ();
+            m_mirror.write (reinterpret_cast<const char *> (&count), sizeof (count));
+          }
+        m_mirror.write (reinterpret_cast<const char *> (&rec.nodes[0]), rec.nodes.size () * sizeof (uint32_t));
+        break;
+      }
+    default:
+      m_mirror.write (reinterpret_cast<const char *> (&rec.nodes[0]), 2 * sizeof (uint32_t));
+    }
+}
+
+inline void
+TopologyLoader::Apply (const Record &rec)
+{
+  switch (rec.type)
+    {
+    case NODE:
+      {
+        NS_ABORT_MSG_UNLESS (m_names.find (rec.name) == m_names.end (), "Topology: node \"" << rec.name << "\" declared twice");
+        Ptr<Node> node = CreateObject<Node> ();
+        m_names[rec.name] = m_nodes.size ();
+        m_nodes.push_back (node);
+        m_nextInterface.push_back (1); // interface 0 is always the loopback
+        if (rec.isRouter)
+          {
+            m_routers.Add (node);
+          }
+        else
+          {
+            m_hosts.Add (node);
+          }
+        if (rec.hasPosition && !m_ignorePositions)
+          {
+            m_positioned.Add (node);
+            m_positions->Add (Vector (rec.x, rec.y, 0));
+          }
+        break;
+      }
+    case LINK:
+    case LAN:
+      {
+        NodeContainer members;
+        for (size_t i = 0; i < rec.nodes.size (); ++i)
+          {
+            members.Add (m_nodes[rec.nodes[i]]);
+          }
+        PendingLink link;
+        if (m_pointToPoint && rec.type == LINK)
+          {
+            m_p2p.SetDeviceAttribute ("DataRate", DataRateValue (DataRate (rec.rate)));
+            m_p2p.SetChannelAttribute ("Delay", TimeValue (NanoSeconds (rec.delay)));
+            link.devices = m_p2p.Install (members);
+          }
+        else
+          {
+            m_csma.SetChannelAttribute ("DataRate", DataRateValue (DataRate (rec.rate)));
+            m_csma.SetChannelAttribute ("Delay", TimeValue (NanoSeconds (rec.delay)));
+            link.devices = m_csma.Install (members);
+          }
+        link.network = rec.network;
+        link.prefix = rec.prefix;
+        m_links.push_back (link);
+        ++m_nLinks;
+
+        for (size_t i = 0; i < rec.nodes.size (); ++i)
+          {
+            uint32_t self = rec.nodes[i];
+            uint32_t interface = m_nextInterface[self]++;
+            for (size_t j = 0; j < rec.nodes.size (); ++j)
+              {
+                if (i != j)
+                  {
+                    // keep the first link if two nodes share several
+                    m_interfaceTowards.insert (std::make_pair (PairKey (self, rec.nodes[j]), interface));
+                  }
+              }
+          }
+        break;
+      }
+    case EXCLUDE:
+      {
+        std::unordered_map<uint64_t, uint32_t>::const_iterator it = m_interfaceTowards.find (PairKey (rec.nodes[0], rec.nodes[1]));
+        NS_ABORT_MSG_IF (it == m_interfaceTowards.end (), "Topology: exclude on nodes " << rec.nodes[0] << " and " << rec.nodes[1] << " that share no link");
+        m_rip.ExcludeInterface (m_nodes[rec.nodes[0]], it->second);
+        break;
+      }
+    case DEFAULT:
+      NS_ABORT_MSG_IF (m_interfaceTowards.find (PairKey (rec.nodes[0], rec.nodes[1])) == m_interfaceTowards.end (),
+                       "Topology: default route between nodes " << rec.nodes[0] << " and " << rec.nodes[1] << " that share no link");
+      m_defaults.push_back (std::make_pair (rec.nodes[0], rec.nodes[1]));
+      break;
+    }
+}
+
+inline void
+TopologyLoader::Finish (void)
+{
+  Ipv4ListRoutingHelper listRH;
+  listRH.Add (m_rip, 0);
+
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.SetRoutingHelper (listRH);
+  internet.Install (m_routers);
+
+  InternetStackHelper internetNodes;
+  internetNodes.SetIpv6StackInstall (false);
+  internetNodes.Install (m_hosts);
+
+  // Same steps as Ipv4AddressHelper::Assign, minus its global duplicate
+  // registry which costs O(links) per call when subnets are not contiguous.
+  for (size_t l = 0; l < m_links.size (); ++l)
+    {
+      const PendingLink &link = m_links[l];
+      uint32_t mask = link.prefix == 0 ? 0 : 0xffffffffu << (32 - link.prefix);
+      // Both readers checked that the subnet fits its nodes.
+      uint32_t firstHost = link.prefix == 31 ? link.network : link.network + 1;
+      for (uint32_t i = 0; i < link.devices.GetN (); ++i)
+        {
+          Ptr<NetDevice> device = link.devices.Get (i);
+          Ptr<Node> node = device->GetNode ();
+          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+          int32_t interface = ipv4->AddInterface (device);
+          ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (firstHost + i), Ipv4Mask (mask)));
+          ipv4->SetMetric (interface, 1);
+          ipv4->SetUp (interface);
+
+          Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+          if (tc && tc->GetRootQueueDiscOnDevice (device) == 0)
+            {
+              TrafficControlHelper tcHelper = TrafficControlHelper::Default ();
+              tcHelper.Install (device);
+            }
+        }
+    }
+  m_links.clear ();
+
+  for (size_t i = 0; i < m_defaults.size (); ++i)
+    {
+      uint32_t host = m_defaults[i].first;
+      uint32_t router = m_defaults[i].second;
+      uint32_t hostIf = m_interfaceTowards[PairKey (host, router)];
+      uint32_t routerIf = m_interfaceTowards[PairKey (router, host)];
+      Ipv4Address gateway = m_nodes[router]->GetObject<Ipv4> ()->GetAddress (routerIf, 0).GetLocal ();
+      Ptr<Ipv4StaticRouting> staticRouting = Ipv4RoutingHelper::GetRouting <Ipv4StaticRouting> (m_nodes[host]->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      NS_ABORT_MSG_IF (staticRouting == 0, "Topology: default route on node " << host << " which has no static routing");
+      staticRouting->SetDefaultRoute (gateway, hostIf);
+    }
+
+  if (m_positioned.GetN () > 0)
+    {
+      MobilityHelper mobility;
+      mobility.SetPositionAllocator (m_positions);
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+      mobility.Install (m_positioned);
+    }
+}
+
+inline void
+TopologyLoader::Load (const std::string &path)
+{
+  std::ifstream is (path.c_str (), std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (is, "Cannot open topology file " << path);
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  bool binary = is.read (reinterpret_cast<char *> (&magic), sizeof (magic)) && magic == MAGIC;
+  if (binary)
+    {
+      is.read (reinterpret_cast<char *> (&version), sizeof (version));
+      NS_ABORT_MSG_UNLESS (version == VERSION, "Binary topology " << path << " has version " << version << ", expected " << VERSION);
+    }
+  else
+    {
+      is.clear ();
+      is.seekg (0);
+    }
+
+  if (!m_mirrorPath.empty ())
+    {
+      m_mirror.open (m_mirrorPath.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      NS_ABORT_MSG_UNLESS (m_mirror, "Cannot write binary topology " << m_mirrorPath);
+      uint32_t header[2] = { MAGIC, VERSION };
+      m_mirror.write (reinterpret_cast<const char *> (header), sizeof (header));
+    }
+
+  Record rec;
+  uint64_t lineNo = 0;
+  while (binary ? ReadBinaryRecord (is, rec) : ReadTextRecord (is, rec, lineNo))
+    {
+      Apply (rec);
+      if (m_mirror.is_open ())
+        {
+          WriteBinaryRecord (rec);
+        }
+    }
+  if (m_mirror.is_open ())
+    {
+      m_mirror.close ();
+    }
+  Finish ();
+}
+
+inline Ptr<Node>
+TopologyLoader::GetNode (const std::string &name) const
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_names.find (name);
+  return it == m_names.end () ? Ptr<Node> () : m_nodes[it->second];
+}
+
+inline NodeContainer
+TopologyLoader::GetRouters (void) const
+{
+  return m_routers;
+}
+
+inline NodeContainer
+TopologyLoader::GetHosts (void) const
+{
+  return m_hosts;
+}
+
+inline CsmaHelper &
+TopologyLoader::GetCsmaHelper (void)
+{
+  return m_csma;
+}
+
+inline PointToPointHelper &
+TopologyLoader::GetPointToPointHelper (void)
+{
+  return m_p2p;
+}
+
+inline uint32_t
+TopologyLoader::GetNLinks (void) const
+{
+  return m_nLinks;
+}
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_LOADER_H */
@@ -0,0 +1,448 @@
+#ifndef TRAFFIC_MATRIX_H
+#define TRAFFIC_MATRIX_H
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/mobility-module.h"
+#include "bulk-traffic.h"
+#include "rip-table-watcher.h"
+
+namespace ns3 {
+
+/**
+ * \brief Hosts attached at routers and a matrix of flows between them,
+ * from a file.
+ *
+ * Text form, one entry per line, '#' starts a comment:
+ *
+ *     host <name> <router> [<weight>]
+ *     endpoint <node> [<weight>]
+ *     flow <src> <dst> [<rate>]
+ *     matrix uniform|gravity <flows> <total rate>
+ *
+ * "host" creates a node linked to a router; "endpoint" uses a node that
+ * already has an address (src, dst, an idle LAN host). The weight (default
+ * 1) is the host's share in a gravity matrix. "flow" adds one flow between
+ * two hosts or endpoints, at the program's UDP rate unless given. "matrix"
+ * draws that many flows: uniform picks every ordered pair alike, gravity
+ * picks a pair in proportion to the product of their weights, so the
+ * expected traffic between two hosts follows the gravity model. The
+ * total rate is split evenly over the drawn flows. Rates are ns-3
+ * DataRate strings ("10Mbps").
+ *
+ * Routers are found with the node lookup (ns-3 Names by default) or by
+ * node id. AttachHosts gives every host a default route through the RIP
+ * router on its first interface, and keeps RIP from sending on the
+ * routers' host-facing links, whose networks RIP still advertises. Pairs
+ * are drawn from alias tables, so the whole setup is linear in hosts plus
+ * flows.
+ */
+class TrafficMatrix
+{
+public:
+  typedef Callback<Ptr<Node>, const std::string &> NodeLookup;
+
+  TrafficMatrix ();
+
+  /// Resolve router and endpoint names with this instead of ns-3 Names.
+  void SetNodeLookup (NodeLookup lookup);
+
+  void Load (const std::string &path);
+
+  /**
+   * \brief Create the hosts, link them to their routers and set the default
+   * routes of hosts and endpoints. Call after the routers are addressed
+   * and before the simulation starts.
+   * \param pool network of the host links, one /30 each ("a.b.c.d/len")
+   */
+  void AttachHosts (CsmaHelper &csma, PointToPointHelper &p2p, bool pointToPoint, const std::string &pool);
+
+  /// Draw the matrix and add every flow to the traffic; call after AttachHosts.
+  void AddFlows (BulkTraffic &traffic, Time start, Time stop);
+
+  NodeContainer GetHosts (void) const;
+  uint32_t GetNFlows (void) const;
+
+private:
+  struct Endpoint
+  {
+    std::string name;
+    std::string router; // empty for an existing node
+    double weight;
+    uint64_t lineNo;
+    Ptr<Node> node;
+  };
+
+  struct Flow
+  {
+    uint32_t src;
+    uint32_t dst;
+    DataRate rate;
+    bool hasRate;
+  };
+
+  /// Walker's alias table over endpoint weights.
+  struct Alias
+  {
+    std::vector<double> probability;
+    std::vector<uint32_t> alias;
+  };
+
+  Ptr<Node> Resolve (const std::string &name, uint64_t lineNo) const;
+  uint32_t Find (const std::string &name, uint64_t lineNo) const;
+  void AddEndpoint (const std::string &name, const std::string &router, double weight, uint64_t lineNo);
+  static Alias BuildAlias (const std::vector<double> &weights);
+  uint32_t Draw (const Alias &table);
+  void SetDefaultRoute (Ptr<Node> node);
+
+  NodeLookup m_lookup;
+  std::vector<Endpoint> m_endpoints;
+  std::unordered_map<std::string, uint32_t> m_byName;
+  std::vector<Flow> m_flows;
+  std::string m_model;
+  uint32_t m_nDrawn;
+  DataRate m_totalRate;
+  NodeContainer m_hosts;
+  Ptr<UniformRandomVariable> m_random;
+};
+
+inline
+TrafficMatrix::TrafficMatrix ()
+  : m_nDrawn (0),
+    m_random (CreateObject<UniformRandomVariable> ())
+{
+}
+
+inline void
+TrafficMatrix::SetNodeLookup (NodeLookup lookup)
+{
+  m_lookup = lookup;
+}
+
+inline Ptr<Node>
+TrafficMatrix::Resolve (const std::string &name, uint64_t lineNo) const
+{
+  Ptr<Node> node = m_lookup.IsNull () ? Names::Find<Node> (name) : m_lookup (name);
+  if (node == 0 && !name.empty () && name.find_first_not_of ("0123456789") == std::string::npos
+      && std::strtoul (name.c_str (), 0, 10) < NodeList::GetNNodes ())
+    {
+      node = NodeList::GetNode (std::strtoul (name.c_str (), 0, 10));
+    }
+  NS_ABORT_MSG_IF (node == 0, "Traffic matrix line " << lineNo << ": unknown node \"" << name << "\"");
+  return node;
+}
+
+inline uint32_t
+TrafficMatrix::Find (const std::string &name, uint64_t lineNo) const
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_byName.find (name);
+  NS_ABORT_MSG_IF (it == m_byName.end (), "Traffic matrix line " << lineNo << ": \"" << name << "\" is no host or endpoint");
+  return it->second;
+}
+
+inline void
+TrafficMatrix::AddEndpoint (const std::string &name, const std::string &router, double weight, uint64_t lineNo)
+{
+  NS_ABORT_MSG_IF (weight < 0, "Traffic matrix line " << lineNo << ": negative weight");
+  NS_ABORT_MSG_UNLESS (m_byName.insert (std::make_pair (name, uint32_t (m_endpoints.size ()))).second,
+                       "Traffic matrix line " << lineNo << ": \"" << name << "\" is defined twice");
+  Endpoint endpoint;
+  endpoint.name = name;
+  endpoint.router = router;
+  endpoint.weight = weight;
+  endpoint.lineNo = lineNo;
+  m_endpoints.push_back (endpoint);
+}
+
+inline void
+TrafficMatrix::Load (const std::string &path)
+{
+  std::ifstream is (path.c_str ());
+  NS_ABORT_MSG_UNLESS (is, "Cannot open traffic matrix " << path);
+  std::string line;
+  uint64_t lineNo = 0;
+  while (std::getline (is, line))
+    {
+      ++lineNo;
+      line = line.substr (0, line.find ('#'));
+      std::istringstream ls (line);
+      std::vector<std::string> tok;
+      std::string t;
+      while (ls >> t)
+        {
+          tok.push_back (t);
+        }
+      if (tok.empty ())
+        {
+          continue;
+        }
+      if (tok[0] == "host")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 3 || tok.size () == 4, "Traffic matrix line " << lineNo << ": host <name> <router> [<weight>]");
+          AddEndpoint (tok[1], tok[2], tok.size () == 4 ? std::atof (tok[3].c_str ()) : 1.0, lineNo);
+        }
+      else if (tok[0] == "endpoint")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 2 || tok.size () == 3, "Traffic matrix line " << lineNo << ": endpoint <node> [<weight>]");
+          AddEndpoint (tok[1], "", tok.size () == 3 ? std::atof (tok[2].c_str ()) : 1.0, lineNo);
+          m_endpoints.back ().node = Resolve (tok[1], lineNo);
+        }
+      else if (tok[0] == "flow")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 3 || tok.size () == 4, "Traffic matrix line " << lineNo << ": flow <src> <dst> [<rate>]");
+          Flow flow;
+          flow.src = Find (tok[1], lineNo);
+          flow.dst = Find (tok[2], lineNo);
+          NS_ABORT_MSG_IF (flow.src == flow.dst, "Traffic matrix line " << lineNo << ": a flow needs two different ends");
+          flow.hasRate = tok.size () == 4;
+          flow.rate = flow.hasRate ? DataRate (tok[3]) : DataRate ();
+          m_flows.push_back (flow);
+        }
+      else if (tok[0] == "matrix")
+        {
+          NS_ABORT_MSG_UNLESS (tok.size () == 4 && (tok[1] == "uniform" || tok[1] == "gravity"),
+                               "Traffic matrix line " << lineNo << ": matrix uniform|gravity <flows> <total rate>");
+          m_model = tok[1];
+          m_nDrawn = std::strtoul (tok[2].c_str (), 0, 10);
+          m_totalRate = DataRate (tok[3]);
+        }
+      else
+        {
+          NS_ABORT_MSG ("Traffic matrix line " << lineNo << ": unknown entry \"" << tok[0] << "\"");
+        }
+    }
+  std::cout<<"INFO: Loaded "<<m_endpoints.size ()<<" hosts and endpoints and "<<m_flows.size ()<<" flows"
+           <<(m_model.empty () ? "" : ", plus a " + m_model + " matrix,")<<" from "<<path<<"\n";
+}
+
+inline void
+TrafficMatrix::SetDefaultRoute (Ptr<Node> node)
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ABORT_MSG_IF (ipv4 == 0 || ipv4->GetNInterfaces () < 2, "TrafficMatrix: node " << node->GetId () << " has no interface");
+  Ptr<Ipv4StaticRouting> staticRouting = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting> (ipv4->GetRoutingProtocol ());
+  NS_ABORT_MSG_IF (staticRouting == 0, "TrafficMatrix: node " << node->GetId () << " has no static routing for its default route");
+  for (uint32_t r = 0; r < staticRouting->GetNRoutes (); ++r)
+    {
+      if (staticRouting->GetRoute (r).IsDefault ())
+        {
+          return;
+        }
+    }
+  // The first RIP router on the host's first link is its gateway.
+  Ptr<NetDevice> device = ipv4->GetNetDevice (1);
+  Ptr<Channel> channel = device->GetChannel ();
+  for (uint32_t d = 0; channel != 0 && d < channel->GetNDevices (); ++d)
+    {
+      Ptr<NetDevice> peerDevice = channel->GetDevice (d);
+      Ptr<Ipv4> peerIpv4 = peerDevice->GetNode ()->GetObject<Ipv4> ();
+      if (peerDevice == device || peerIpv4 == 0 || RipTableWatcher::GetRip (peerDevice->GetNode ()) == 0)
+        {
+          continue;
+        }
+      int32_t peerInterface = peerIpv4->GetInterfaceForDevice (peerDevice);
+      if (peerInterface >= 0 && peerIpv4->GetNAddresses (peerInterface) > 0)
+        {
+          staticRouting->SetDefaultRoute (peerIpv4->GetAddress (peerInterface, 0).GetLocal (), 1);
+          return;
+        }
+    }
+  NS_ABORT_MSG ("TrafficMatrix: node " << node->GetId () << " has no RIP router on its first link");
+}
+
+inline void
+TrafficMatrix::AttachHosts (CsmaHelper &csma, PointToPointHelper &p2p, bool pointToPoint, const std::string &pool)
+{
+  std::string::size_type slash = pool.find ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos, "TrafficMatrix: host pool \"" << pool << "\" is not in a.b.c.d/len form");
+  uint32_t poolPrefix = std::atoi (pool.substr (slash + 1).c_str ());
+  NS_ABORT_MSG_UNLESS (poolPrefix >= 8 && poolPrefix <= 30, "TrafficMatrix: host pool /" << poolPrefix << " cannot hold /30 links");
+  uint32_t capacity = 1u << (30 - poolPrefix);
+  Ipv4Address base (pool.substr (0, slash).c_str ());
+  Ipv4Mask poolMask (0xffffffffu << (32 - poolPrefix));
+  // One pass over the addresses assigned so far: the pool must not overlap
+  // any of their networks.
+  for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+    {
+      Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4> ();
+      for (uint32_t i = 1; ipv4 != 0 && i < ipv4->GetNInterfaces (); ++i)
+        {
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); ++j)
+            {
+              Ipv4InterfaceAddress address = ipv4->GetAddress (i, j);
+              NS_ABORT_MSG_IF (poolMask.IsMatch (address.GetLocal (), base) || address.GetMask ().IsMatch (address.GetLocal (), base),
+                               "TrafficMatrix: host pool " << pool << " overlaps " << address.GetLocal () << " of node " << (*it)->GetId ());
+            }
+        }
+    }
+  Ipv4AddressHelper addresses;
+  addresses.SetBase (base, Ipv4Mask ("255.255.255.252"));
+
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  uint32_t nLinks = 0;
+  std::map<Ptr<Rip>, std::vector<uint32_t> > exclusions; // host-facing interfaces, by router
+  for (size_t i = 0; i < m_endpoints.size (); ++i)
+    {
+      Endpoint &endpoint = m_endpoints[i];
+      if (!endpoint.router.empty ())
+        {
+          NS_ABORT_MSG_IF (nLinks == capacity, "TrafficMatrix: host pool " << pool << " only has room for " << capacity << " hosts");
+          Ptr<Node> router = Resolve (endpoint.router, endpoint.lineNo);
+          Ptr<Rip> rip = RipTableWatcher::GetRip (router);
+          NS_ABORT_MSG_IF (rip == 0, "TrafficMatrix: host " << endpoint.name << " is attached to node " << router->GetId ()
+                           << ", which does not run RIP");
+          endpoint.node = CreateObject<Node> (router->GetSystemId ());
+          internet.Install (endpoint.node);
+          NetDeviceContainer devices = pointToPoint ? p2p.Install (endpoint.node, router)
+            : csma.Install (NodeContainer (endpoint.node, router));
+          addresses.Assign (devices);
+          addresses.NewNetwork ();
+          ++nLinks;
+          m_hosts.Add (endpoint.node);
+          Ptr<MobilityModel> routerPosition = router->GetObject<MobilityModel> ();
+          if (routerPosition != 0)
+            {
+              // Only for NetAnim, which wants every node placed.
+              Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+              position->SetPosition (routerPosition->GetPosition () + Vector (5, 5, 0));
+              endpoint.node->AggregateObject (position);
+            }
+
+          exclusions[rip].push_back (router->GetObject<Ipv4> ()->GetInterfaceForDevice (devices.Get (1)));
+        }
+      SetDefaultRoute (endpoint.node);
+    }
+  // RIP has nobody to talk to there; the networks are still advertised.
+  // Each router's exclusions are rewritten once, whatever its host count.
+  for (std::map<Ptr<Rip>, std::vector<uint32_t> >::const_iterator it = exclusions.begin (); it != exclusions.end (); ++it)
+    {
+      std::set<uint32_t> excluded = it->first->GetInterfaceExclusions ();
+      excluded.insert (it->second.begin (), it->second.end ());
+      it->first->SetInterfaceExclusions (excluded);
+    }
+  std::cout<<"INFO: Attached "<<nLinks<<" hosts from "<<pool<<", "<<m_endpoints.size () - nLinks<<" existing endpoints\n";
+}
+
+inline TrafficMatrix::Alias
+TrafficMatrix::BuildAlias (const std::vector<double> &weights)
+{
+  size_t n = weights.size ();
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    {
+      sum += weights[i];
+    }
+  Alias table;
+  table.probability.assign (n, 1.0);
+  table.alias.resize (n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  std::vector<double> scaled (n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      table.alias[i] = i;
+      scaled[i] = weights[i] * n / sum;
+      (scaled[i] < 1.0 ? small : large).push_back (i);
+    }
+  while (!small.empty () && !large.empty ())
+    {
+      uint32_t s = small.back ();
+      small.pop_back ();
+      uint32_t l = large.back ();
+      table.probability[s] = scaled[s];
+      table.alias[s] = l;
+      scaled[l] -= 1.0 - scaled[s];
+      if (scaled[l] < 1.0)
+        {
+          large.pop_back ();
+          small.push_back (l);
+        }
+    }
+  // What is left is 1 up to rounding.
+  return table;
+}
+
+inline uint32_t
+TrafficMatrix::Draw (const Alias &table)
+{
+  uint32_t i = m_random->GetInteger (0, table.probability.size () - 1);
+  return m_random->GetValue () < table.probability[i] ? i : table.alias[i];
+}
+
+inline void
+TrafficMatrix::AddFlows (BulkTraffic &traffic, Time start, Time stop)
+{
+  if (m_nDrawn > 0)
+    {
+      std::vector<double> weights (m_endpoints.size (), 1.0);
+      uint32_t positive = 0;
+      for (size_t i = 0; i < m_endpoints.size (); ++i)
+        {
+          if (m_model == "gravity")
+            {
+              weights[i] = m_endpoints[i].weight;
+            }
+          positive += weights[i] > 0;
+        }
+      NS_ABORT_MSG_IF (positive < 2, "TrafficMatrix: a matrix needs two hosts or endpoints of positive weight");
+      Alias table = BuildAlias (weights);
+      DataRate rate (m_totalRate.GetBitRate () / m_nDrawn);
+      m_flows.reserve (m_flows.size () + m_nDrawn);
+      for (uint32_t k = 0; k < m_nDrawn; ++k)
+        {
+          Flow flow;
+          flow.src = Draw (table);
+          // Source and destination are drawn independently; a pair of one
+          // host is drawn again.
+          do
+            {
+              flow.dst = Draw (table);
+            }
+          while (flow.dst == flow.src);
+          flow.rate = rate;
+          flow.hasRate = true;
+          m_flows.push_back (flow);
+        }
+    }
+  for (size_t k = 0; k < m_flows.size (); ++k)
+    {
+      const Flow &flow = m_flows[k];
+      if (flow.hasRate)
+        {
+          traffic.AddFlows (m_endpoints[flow.src].node, m_endpoints[flow.dst].node, start, stop, flow.rate);
+        }
+      else
+        {
+          traffic.AddFlows (m_endpoints[flow.src].node, m_endpoints[flow.dst].node, start, stop);
+        }
+    }
+  std::cout<<"INFO: Traffic matrix of "<<m_flows.size ()<<" flows between "<<m_endpoints.size ()<<" hosts and endpoints\n";
+}
+
+inline NodeContainer
+TrafficMatrix::GetHosts (void) const
+{
+  return m_hosts;
+}
+
+inline uint32_t
+TrafficMatrix::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+} // namespace ns3
+
+#endif /* TRAFFIC_MATRIX_H */